@@ -0,0 +1,219 @@
+#include "fixed_real.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+    using Limbs = std::vector<uint64_t>;
+
+    // Both magnitudes have the same number of limbs
+    int compareMagnitude(const Limbs& a, const Limbs& b) {
+        for (size_t k = 0; k < a.size(); ++k) {
+            if (a[k] != b[k]) {
+                return a[k] < b[k] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    Limbs addMagnitude(const Limbs& a, const Limbs& b) {
+        Limbs sum(a.size());
+        unsigned __int128 carry = 0;
+        for (size_t k = a.size(); k-- > 0;) {
+            carry += static_cast<unsigned __int128>(a[k]) + b[k];
+            sum[k] = static_cast<uint64_t>(carry);
+            carry >>= 64;
+        }
+        return sum;
+    }
+
+    // Requires a >= b
+    Limbs subtractMagnitude(const Limbs& a, const Limbs& b) {
+        Limbs difference(a.size());
+        uint64_t borrow = 0;
+        for (size_t k = a.size(); k-- > 0;) {
+            uint64_t subtrahend = b[k] + borrow;
+            bool wraps = subtrahend < borrow || a[k] < subtrahend;
+            difference[k] = a[k] - subtrahend;
+            borrow = wraps ? 1 : 0;
+        }
+        return difference;
+    }
+
+    // Divides the number in place by a small divisor, most significant limb first
+    void divideMagnitude(Limbs& limbs, uint64_t divisor) {
+        unsigned __int128 remainder = 0;
+        for (auto& limb : limbs) {
+            unsigned __int128 current = (remainder << 64) | limb;
+            limb = static_cast<uint64_t>(current / divisor);
+            remainder = current % divisor;
+        }
+    }
+}
+
+fixed_real::fixed_real(int fractionLimbs) : limbs(std::max(fractionLimbs, 1) + 1, 0) {}
+
+fixed_real::fixed_real(double value, int fractionLimbs) : fixed_real(fractionLimbs) {
+    if (!std::isfinite(value) || std::fabs(value) >= 0x1p63) {
+        throw std::invalid_argument("fixed_real holds finite values below 2^63");
+    }
+    negative = value < 0.0;
+    double magnitude = std::fabs(value);
+    double integer = std::floor(magnitude);
+    limbs[0] = static_cast<uint64_t>(integer);
+    // Scaling by 2^64 and splitting off the integer part are exact in binary
+    double fraction = magnitude - integer;
+    for (size_t k = 1; k < limbs.size() && fraction != 0.0; ++k) {
+        fraction = std::ldexp(fraction, 64);
+        double digit = std::floor(fraction);
+        limbs[k] = static_cast<uint64_t>(digit);
+        fraction -= digit;
+    }
+    if (isZero()) {
+        negative = false;
+    }
+}
+
+fixed_real fixed_real::parse(const std::string& decimal, int fractionLimbs) {
+    size_t position = 0;
+    bool negative = false;
+    if (position < decimal.size() && (decimal[position] == '-' || decimal[position] == '+')) {
+        negative = decimal[position++] == '-';
+    }
+    size_t integerStart = position;
+    while (position < decimal.size() && std::isdigit(static_cast<unsigned char>(decimal[position]))) {
+        ++position;
+    }
+    std::string integerDigits = decimal.substr(integerStart, position - integerStart);
+    std::string fractionDigits;
+    if (position < decimal.size() && decimal[position] == '.') {
+        size_t fractionStart = ++position;
+        while (position < decimal.size() && std::isdigit(static_cast<unsigned char>(decimal[position]))) {
+            ++position;
+        }
+        fractionDigits = decimal.substr(fractionStart, position - fractionStart);
+    }
+    if (position != decimal.size() || (integerDigits.empty() && fractionDigits.empty())) {
+        throw std::invalid_argument("Not a decimal number: " + decimal);
+    }
+    if (integerDigits.size() > 18) {
+        throw std::invalid_argument("fixed_real holds values below 2^63: " + decimal);
+    }
+
+    // One guard limb absorbs the rounding of the divisions below
+    fixed_real result(fractionLimbs + 1);
+    for (auto it = fractionDigits.rbegin(); it != fractionDigits.rend(); ++it) {
+        result.limbs[0] = static_cast<uint64_t>(*it - '0');
+        divideMagnitude(result.limbs, 10);
+    }
+    result.limbs[0] = integerDigits.empty() ? 0 : std::stoull(integerDigits);
+    result.negative = negative && !result.isZero();
+    return result.withPrecision(fractionLimbs);
+}
+
+int fixed_real::limbsFor(double resolution) {
+    double bits = 64.0 + std::max(0.0, -std::log2(std::fabs(resolution)));
+    return std::max(1, static_cast<int>(std::ceil(bits / 64.0)));
+}
+
+double fixed_real::toDouble() const {
+    double magnitude = 0.0;
+    for (size_t k = limbs.size(); k-- > 0;) {
+        magnitude += std::ldexp(static_cast<double>(limbs[k]), -64 * static_cast<int>(k));
+    }
+    return negative ? -magnitude : magnitude;
+}
+
+std::string fixed_real::toString(int fractionDigits) const {
+    std::string text = (negative ? "-" : "") + std::to_string(limbs[0]);
+    if (fractionDigits <= 0) {
+        return text;
+    }
+    text += '.';
+    Limbs fraction(limbs.begin() + 1, limbs.end());
+    for (int digit = 0; digit < fractionDigits; ++digit) {
+        unsigned __int128 carry = 0;
+        for (size_t k = fraction.size(); k-- > 0;) {
+            carry += static_cast<unsigned __int128>(fraction[k]) * 10;
+            fraction[k] = static_cast<uint64_t>(carry);
+            carry >>= 64;
+        }
+        text += static_cast<char>('0' + static_cast<int>(carry));
+    }
+    return text;
+}
+
+fixed_real fixed_real::withPrecision(int fractionLimbs) const {
+    fixed_real result = *this;
+    result.limbs.resize(std::max(fractionLimbs, 1) + 1, 0);
+    if (result.isZero()) {
+        result.negative = false;
+    }
+    return result;
+}
+
+bool fixed_real::isZero() const {
+    return std::all_of(limbs.begin(), limbs.end(), [](uint64_t limb) { return limb == 0; });
+}
+
+fixed_real fixed_real::operator-() const {
+    fixed_real result = *this;
+    result.negative = !negative && !isZero();
+    return result;
+}
+
+fixed_real fixed_real::operator+(const fixed_real& other) const {
+    int precision = std::max(fractionLimbs(), other.fractionLimbs());
+    fixed_real a = withPrecision(precision);
+    fixed_real b = other.withPrecision(precision);
+
+    fixed_real result(precision);
+    if (a.negative == b.negative) {
+        result.limbs = addMagnitude(a.limbs, b.limbs);
+        result.negative = a.negative;
+    } else if (compareMagnitude(a.limbs, b.limbs) >= 0) {
+        result.limbs = subtractMagnitude(a.limbs, b.limbs);
+        result.negative = a.negative;
+    } else {
+        result.limbs = subtractMagnitude(b.limbs, a.limbs);
+        result.negative = b.negative;
+    }
+    if (result.isZero()) {
+        result.negative = false;
+    }
+    return result;
+}
+
+fixed_real fixed_real::operator-(const fixed_real& other) const {
+    return *this + (-other);
+}
+
+fixed_real fixed_real::operator*(const fixed_real& other) const {
+    const int precision = std::max(fractionLimbs(), other.fractionLimbs());
+    const size_t n = precision + 1;
+    fixed_real a = withPrecision(precision);
+    fixed_real b = other.withPrecision(precision);
+
+    // Schoolbook product, least significant limb first: limb k of an operand
+    // sits at index n - 1 - k, and product index q weighs 2^(64 * (q - 2 * precision))
+    Limbs product(2 * n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        unsigned __int128 carry = 0;
+        uint64_t ai = a.limbs[n - 1 - i];
+        for (size_t j = 0; j < n; ++j) {
+            carry += static_cast<unsigned __int128>(ai) * b.limbs[n - 1 - j] + product[i + j];
+            product[i + j] = static_cast<uint64_t>(carry);
+            carry >>= 64;
+        }
+        product[i + n] = static_cast<uint64_t>(carry);
+    }
+
+    // Keeps the integer limb and precision fraction limbs; anything above 2^64 is out of range
+    fixed_real result(precision);
+    for (size_t k = 0; k < n; ++k) {
+        result.limbs[k] = product[2 * precision - k];
+    }
+    result.negative = (a.negative != b.negative) && !result.isZero();
+    return result;
+}
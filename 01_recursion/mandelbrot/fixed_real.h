@@ -0,0 +1,48 @@
+#ifndef FIXED_REAL_H
+#define FIXED_REAL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Signed fixed-point number with a 64-bit integer part and a configurable
+// number of 64-bit fraction limbs. Mandelbrot orbits stay inside |z| <= 2
+// until they escape, so a fixed binary point loses nothing against a float
+// and keeps addition and multiplication simple. Results get the precision
+// of the more precise operand; extra product bits are truncated.
+class fixed_real {
+public:
+    // Zero with fractionLimbs * 64 fraction bits
+    explicit fixed_real(int fractionLimbs = 1);
+    fixed_real(double value, int fractionLimbs);
+
+    // Parses a decimal like "-0.743643887037158704752191506114774"; exponents are not
+    // accepted. Throws std::invalid_argument for malformed input.
+    static fixed_real parse(const std::string& decimal, int fractionLimbs);
+
+    // Fraction limbs needed to resolve steps of size resolution with 64 bits to spare
+    static int limbsFor(double resolution);
+
+    double toDouble() const;
+    // Decimal with the given number of fraction digits, truncated
+    std::string toString(int fractionDigits) const;
+
+    int fractionLimbs() const { return static_cast<int>(limbs.size()) - 1; }
+    // Same value with more (or fewer, truncating) fraction limbs
+    fixed_real withPrecision(int fractionLimbs) const;
+
+    fixed_real operator-() const;
+    fixed_real operator+(const fixed_real& other) const;
+    fixed_real operator-(const fixed_real& other) const;
+    fixed_real operator*(const fixed_real& other) const;
+    fixed_real& operator+=(const fixed_real& other) { return *this = *this + other; }
+    fixed_real& operator-=(const fixed_real& other) { return *this = *this - other; }
+
+private:
+    bool isZero() const;
+
+    bool negative = false;
+    std::vector<uint64_t> limbs;  // limbs[0] is the integer part, then the fraction from the most significant limb
+};
+
+#endif // FIXED_REAL_H
@@ -0,0 +1,313 @@
+#include "image_writer.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <stdexcept>
+
+#ifdef MANDELBROT_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+    void requireImageSize(int width, int height) {
+        if (width <= 0 || height <= 0) {
+            throw std::invalid_argument("Image dimensions must be positive");
+        }
+    }
+
+    std::ofstream openOutput(const std::string& filename) {
+        std::ofstream out(filename, std::ios::binary);
+        if (!out.is_open()) {
+            throw std::runtime_error("Unable to open output file: " + filename);
+        }
+        return out;
+    }
+
+    void requireRows(const std::string& filename, int rowsWritten, int rows, int height) {
+        if (rows < 0 || rows > height - rowsWritten) {
+            throw std::runtime_error("More rows than the image height written to " + filename);
+        }
+    }
+
+    void finishOutput(std::ofstream& out, const std::string& filename, int rowsWritten, int height) {
+        if (rowsWritten != height) {
+            throw std::runtime_error("Image " + filename + " finished before its last row");
+        }
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Unable to write output file: " + filename);
+        }
+    }
+
+    // CRC-32 over chunk type and data, as every PNG chunk ends with one
+    uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t size) {
+        static const std::array<uint32_t, 256> table = [] {
+            std::array<uint32_t, 256> entries{};
+            for (uint32_t n = 0; n < 256; ++n) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; ++k) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                entries[n] = c;
+            }
+            return entries;
+        }();
+        crc = ~crc;
+        for (size_t i = 0; i < size; ++i) {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    void putBigEndian(uint8_t* bytes, uint32_t value) {
+        bytes[0] = static_cast<uint8_t>(value >> 24);
+        bytes[1] = static_cast<uint8_t>(value >> 16);
+        bytes[2] = static_cast<uint8_t>(value >> 8);
+        bytes[3] = static_cast<uint8_t>(value);
+    }
+
+    void writeChunk(std::ofstream& out, const char type[4], const uint8_t* data, size_t size) {
+        uint8_t header[8];
+        putBigEndian(header, static_cast<uint32_t>(size));
+        std::copy(type, type + 4, header + 4);
+        uint8_t crc[4];
+        putBigEndian(crc, crc32Update(crc32Update(0, header + 4, 4), data, size));
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+        out.write(reinterpret_cast<const char*>(crc), sizeof(crc));
+    }
+}
+
+ppm_writer::ppm_writer(const std::string& filename, int width, int height)
+    : filename(filename), width(width), height(height) {
+    requireImageSize(width, height);
+    out = openOutput(filename);
+    out << "P6\n" << width << " " << height << "\n255\n";
+}
+
+void ppm_writer::writeRows(const uint8_t* rgb, int rows) {
+    requireRows(filename, rowsWritten, rows, height);
+    out.write(reinterpret_cast<const char*>(rgb), static_cast<std::streamsize>(rows) * width * 3);
+    rowsWritten += rows;
+}
+
+void ppm_writer::finish() {
+    finishOutput(out, filename, rowsWritten, height);
+}
+
+// The zlib stream of the image data. Whatever it produces goes out as one IDAT chunk.
+class png_writer::deflater {
+public:
+    deflater(std::ofstream& out, bool compress);
+    ~deflater();
+
+    void write(const uint8_t* data, size_t size);
+    void finish();
+
+private:
+    // A stored deflate block holds at most 65535 bytes
+    static constexpr size_t STORED_BLOCK = 65535;
+
+    void writeStored(const uint8_t* data, size_t size);
+    void finishStored();
+    void emitBlock(bool last);
+
+    std::ofstream& out;
+    std::vector<uint8_t> buffer;
+    uint32_t adlerA = 1;
+    uint32_t adlerB = 0;
+    bool headerWritten = false;
+#ifdef MANDELBROT_HAS_ZLIB
+    // Fast levels already shrink the long runs of a Mandelbrot image most of the way
+    static constexpr int COMPRESSION_LEVEL = 3;
+
+    void run(int flush);
+
+    bool compressed;
+    z_stream stream{};
+#endif
+};
+
+#ifdef MANDELBROT_HAS_ZLIB
+png_writer::deflater::deflater(std::ofstream& out, bool compress) : out(out), compressed(compress) {
+    if (!compressed) {
+        buffer.reserve(2 + 5 + STORED_BLOCK);
+        return;
+    }
+    buffer.resize(1 << 16);
+    if (deflateInit(&stream, COMPRESSION_LEVEL) != Z_OK) {
+        throw std::runtime_error("Unable to initialise zlib");
+    }
+}
+
+png_writer::deflater::~deflater() {
+    if (compressed) {
+        deflateEnd(&stream);
+    }
+}
+
+void png_writer::deflater::run(int flush) {
+    int status;
+    do {
+        stream.next_out = buffer.data();
+        stream.avail_out = static_cast<uInt>(buffer.size());
+        status = deflate(&stream, flush);
+        if (status == Z_STREAM_ERROR) {
+            throw std::runtime_error("zlib failed to compress the image");
+        }
+        size_t produced = buffer.size() - stream.avail_out;
+        if (produced > 0) {
+            writeChunk(out, "IDAT", buffer.data(), produced);
+        }
+    } while (stream.avail_out == 0 || (flush == Z_FINISH && status != Z_STREAM_END));
+}
+
+void png_writer::deflater::write(const uint8_t* data, size_t size) {
+    if (!compressed) {
+        writeStored(data, size);
+        return;
+    }
+    // avail_in is 32 bits wide, rows of huge images are fed in pieces
+    while (size > 0) {
+        size_t piece = std::min<size_t>(size, 1u << 30);
+        stream.next_in = const_cast<Bytef*>(data);
+        stream.avail_in = static_cast<uInt>(piece);
+        run(Z_NO_FLUSH);
+        data += piece;
+        size -= piece;
+    }
+}
+
+void png_writer::deflater::finish() {
+    if (!compressed) {
+        finishStored();
+        return;
+    }
+    stream.next_in = nullptr;
+    stream.avail_in = 0;
+    run(Z_FINISH);
+}
+#else
+png_writer::deflater::deflater(std::ofstream& out, bool) : out(out) {
+    buffer.reserve(2 + 5 + STORED_BLOCK);
+}
+
+png_writer::deflater::~deflater() = default;
+
+void png_writer::deflater::write(const uint8_t* data, size_t size) {
+    writeStored(data, size);
+}
+
+void png_writer::deflater::finish() {
+    finishStored();
+}
+#endif
+
+void png_writer::deflater::emitBlock(bool last) {
+    // buffer holds [zlib header] + 5 bytes of block header + the block's bytes
+    size_t offset = headerWritten ? 0 : 2;
+    uint16_t length = static_cast<uint16_t>(buffer.size() - offset - 5);
+    buffer[offset] = last ? 1 : 0;
+    buffer[offset + 1] = static_cast<uint8_t>(length);
+    buffer[offset + 2] = static_cast<uint8_t>(length >> 8);
+    buffer[offset + 3] = static_cast<uint8_t>(~length);
+    buffer[offset + 4] = static_cast<uint8_t>(~length >> 8);
+    if (last) {
+        uint8_t adler[4];
+        putBigEndian(adler, (adlerB << 16) | adlerA);
+        buffer.insert(buffer.end(), adler, adler + 4);
+    }
+    writeChunk(out, "IDAT", buffer.data(), buffer.size());
+    buffer.clear();
+    headerWritten = true;
+}
+
+void png_writer::deflater::writeStored(const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        if (buffer.empty()) {
+            if (!headerWritten) {
+                // CMF / FLG: deflate with a 32K window, no dictionary, fastest level
+                buffer.push_back(0x78);
+                buffer.push_back(0x01);
+            }
+            buffer.resize(buffer.size() + 5);
+        }
+        buffer.push_back(data[i]);
+        adlerA = (adlerA + data[i]) % 65521;
+        adlerB = (adlerB + adlerA) % 65521;
+        if (buffer.size() - (headerWritten ? 0 : 2) - 5 == STORED_BLOCK) {
+            emitBlock(false);
+        }
+    }
+}
+
+void png_writer::deflater::finishStored() {
+    if (buffer.empty()) {
+        if (!headerWritten) {
+            buffer.push_back(0x78);
+            buffer.push_back(0x01);
+        }
+        buffer.resize(buffer.size() + 5);
+    }
+    emitBlock(true);
+}
+
+png_writer::png_writer(const std::string& filename, int width, int height, bool compress)
+    : filename(filename), width(width), height(height) {
+    requireImageSize(width, height);
+    out = openOutput(filename);
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    out.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    // 8 bits per channel, colour type 2 (RGB), default compression and filtering, no interlace
+    uint8_t header[13] = {};
+    putBigEndian(header, static_cast<uint32_t>(width));
+    putBigEndian(header + 4, static_cast<uint32_t>(height));
+    header[8] = 8;
+    header[9] = 2;
+    writeChunk(out, "IHDR", header, sizeof(header));
+
+    filtered.resize(1 + static_cast<size_t>(width) * 3);
+    stream = std::make_unique<deflater>(out, compress);
+}
+
+png_writer::~png_writer() = default;
+
+void png_writer::writeRows(const uint8_t* rgb, int rows) {
+    requireRows(filename, rowsWritten, rows, height);
+    const size_t rowBytes = static_cast<size_t>(width) * 3;
+    for (int row = 0; row < rows; ++row, rgb += rowBytes) {
+        // Sub filter: every byte minus the same channel of the pixel to its left
+        filtered[0] = 1;
+        std::copy(rgb, rgb + 3, filtered.begin() + 1);
+        for (size_t i = 3; i < rowBytes; ++i) {
+            filtered[1 + i] = static_cast<uint8_t>(rgb[i] - rgb[i - 3]);
+        }
+        stream->write(filtered.data(), filtered.size());
+    }
+    rowsWritten += rows;
+}
+
+void png_writer::finish() {
+    if (rowsWritten == height) {
+        stream->finish();
+        writeChunk(out, "IEND", nullptr, 0);
+    }
+    finishOutput(out, filename, rowsWritten, height);
+}
+
+std::unique_ptr<image_writer> make_image_writer(const std::string& filename, int width, int height) {
+    auto hasExtension = [&](const std::string& extension) {
+        return filename.size() >= extension.size() &&
+               std::equal(extension.rbegin(), extension.rend(), filename.rbegin(),
+                          [](char a, char b) { return a == std::tolower(static_cast<unsigned char>(b)); });
+    };
+    if (hasExtension(".ppm")) {
+        return std::make_unique<ppm_writer>(filename, width, height);
+    }
+    if (hasExtension(".png")) {
+        return std::make_unique<png_writer>(filename, width, height);
+    }
+    throw std::invalid_argument("Output file must end in .ppm or .png: " + filename);
+}
@@ -0,0 +1,66 @@
+#ifndef IMAGE_WRITER_H
+#define IMAGE_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Writes an 8-bit RGB image from top to bottom, a band of rows at a time, so
+// images far larger than memory can be produced. Errors throw std::runtime_error.
+class image_writer {
+public:
+    virtual ~image_writer() = default;
+
+    // Appends rows complete rows of 3 * width bytes each
+    virtual void writeRows(const uint8_t* rgb, int rows) = 0;
+    // Flushes the file; every row of the image must have been written
+    virtual void finish() = 0;
+};
+
+// Binary PPM (P6): a text header followed by the raw rows
+class ppm_writer : public image_writer {
+public:
+    ppm_writer(const std::string& filename, int width, int height);
+
+    void writeRows(const uint8_t* rgb, int rows) override;
+    void finish() override;
+
+private:
+    std::ofstream out;
+    std::string filename;
+    int width;
+    int height;
+    int rowsWritten = 0;
+};
+
+// PNG with a single zlib stream cut into IDAT chunks as rows arrive. Compressed
+// with zlib when the build found it, otherwise written as stored deflate blocks.
+class png_writer : public image_writer {
+public:
+    // compress = false writes stored blocks even when zlib is available
+    png_writer(const std::string& filename, int width, int height, bool compress = true);
+    ~png_writer() override;
+
+    void writeRows(const uint8_t* rgb, int rows) override;
+    void finish() override;
+
+private:
+    class deflater;
+
+    std::ofstream out;
+    std::string filename;
+    int width;
+    int height;
+    int rowsWritten = 0;
+    std::vector<uint8_t> filtered;  // One row with its filter byte
+    std::unique_ptr<deflater> stream;
+};
+
+// Picks the writer from the extension of filename (.ppm or .png).
+// Throws std::invalid_argument for other extensions or an empty image.
+std::unique_ptr<image_writer> make_image_writer(const std::string& filename, int width, int height);
+
+#endif // IMAGE_WRITER_H
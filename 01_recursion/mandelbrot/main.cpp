@@ -5,11 +5,14 @@
 #include <iostream>
 #include <complex>
 #include "mandelbrot.h"
+#include "memory_stats.h"
 
 int main() {
     std::cout << "=== Mandelbrot Set Recursive Calculator ===" << std::endl << std::endl;
 
     int maxIterations = 100;
+    MemoryProbe memory;
+    memory.start();
 
     // Test some points in the complex plane
     std::complex<double> testPoints[] = {
@@ -34,5 +37,6 @@ int main() {
         std::cout << std::endl;
     }
 
+    std::cout << std::endl << "Memory: " << memory.stop().format() << std::endl;
     return 0;
 }
\ No newline at end of file
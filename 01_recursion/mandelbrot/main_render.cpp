@@ -0,0 +1,206 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "image_writer.h"
+#include "mandelbrot.h"
+#include "memory_stats.h"
+#include "palette.h"
+#include "perturbation.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Each of the two band buffers stays below this size unless a single row is already larger
+    constexpr size_t DEFAULT_BAND_BYTES = size_t(64) << 20;
+
+    // Defaults match the visualizer's initial view
+    struct RenderOptions {
+        std::string centerX = "-0.5";  // Decimals, parsed to whatever precision the scale needs
+        std::string centerY = "0";
+        double scale = 3.5;  // Height of the view in the complex plane
+        int width = 1920;
+        int height = 1080;
+        int maxIterations = 256;
+        Palette palette = Palette::Sine;
+        InteriorCheck interiorCheck = InteriorCheck::On;  // Off benchmarks the plain kernel
+        int bandRows = 0;  // 0: as many as fit DEFAULT_BAND_BYTES
+        unsigned int threads = std::thread::hardware_concurrency();
+        std::string output = "mandelbrot.png";
+    };
+
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program << " [--center-x <decimal>] [--center-y <decimal>] [--scale <height>]"
+                  << " [--width <pixels>] [--height <pixels>] [--iterations <max>] [--palette <name>]"
+                  << " [--interior on|off] [--band-rows <rows>] [--threads <count>] [--output <file.png|file.ppm>]" << std::endl;
+        std::cerr << "Palettes:";
+        for (const auto& name : palette_names()) {
+            std::cerr << " " << name;
+        }
+        std::cerr << std::endl;
+    }
+
+    RenderOptions parseOptions(int argc, char* argv[]) {
+        RenderOptions options;
+        for (int i = 1; i < argc; ++i) {
+            std::string flag = argv[i];
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + flag);
+            }
+            std::string value = argv[++i];
+            if (flag == "--center-x") {
+                options.centerX = value;
+            } else if (flag == "--center-y") {
+                options.centerY = value;
+            } else if (flag == "--scale") {
+                options.scale = std::stod(value);
+            } else if (flag == "--width") {
+                options.width = std::stoi(value);
+            } else if (flag == "--height") {
+                options.height = std::stoi(value);
+            } else if (flag == "--iterations") {
+                options.maxIterations = std::stoi(value);
+            } else if (flag == "--palette") {
+                options.palette = parse_palette(value);
+            } else if (flag == "--interior") {
+                if (value != "on" && value != "off") {
+                    throw std::invalid_argument("--interior takes on or off, not " + value);
+                }
+                options.interiorCheck = value == "on" ? InteriorCheck::On : InteriorCheck::Off;
+            } else if (flag == "--band-rows") {
+                options.bandRows = std::stoi(value);
+            } else if (flag == "--threads") {
+                options.threads = std::stoul(value);
+            } else if (flag == "--output") {
+                options.output = value;
+            } else {
+                throw std::invalid_argument("Unknown option " + flag);
+            }
+        }
+        if (options.width <= 0 || options.height <= 0 || options.maxIterations <= 0 || !(options.scale > 0.0)) {
+            throw std::invalid_argument("Width, height, iterations and scale must be positive");
+        }
+        if (options.bandRows <= 0) {
+            size_t rowBytes = static_cast<size_t>(options.width) * 3;
+            options.bandRows = static_cast<int>(std::max<size_t>(1, DEFAULT_BAND_BYTES / rowBytes));
+        }
+        options.bandRows = std::min(options.bandRows, options.height);
+        return options;
+    }
+
+    // Where the rows are computed: centre in double for shallow views, perturbation for deep ones
+    struct View {
+        double centerX = 0.0;
+        double centerY = 0.0;
+        std::unique_ptr<perturbation_engine> deepZoom;
+    };
+
+    View makeView(const RenderOptions& options) {
+        double pixel = options.scale / options.height;
+        int limbs = fixed_real::limbsFor(pixel);
+        fixed_real centerX = fixed_real::parse(options.centerX, limbs);
+        fixed_real centerY = fixed_real::parse(options.centerY, limbs);
+
+        View view;
+        view.centerX = centerX.toDouble();
+        view.centerY = centerY.toDouble();
+        if (options.scale < perturbation_engine::DEEP_ZOOM_SCALE) {
+            double maxDelta = 0.5 * pixel * std::hypot(options.width, options.height);
+            view.deepZoom = std::make_unique<perturbation_engine>(centerX, centerY, maxDelta, options.maxIterations);
+            std::cout << "Deep zoom: reference orbit lasts " << view.deepZoom->referenceIterations()
+                      << " iterations, series skips " << view.deepZoom->skippedIterations() << std::endl;
+        }
+        return view;
+    }
+
+    // Colours one image row; pixel centres are sampled, so the view is symmetric around the centre
+    void renderRow(const RenderOptions& options, const View& view, int y, std::vector<int>& iterations,
+                   uint8_t* rgb) {
+        double pixel = options.scale / options.height;
+        double deltaStart = (0.5 - options.width / 2.0) * pixel;
+        double deltaImag = -(y + 0.5 - options.height / 2.0) * pixel;
+        if (view.deepZoom) {
+            view.deepZoom->iterateRow(deltaStart, pixel, deltaImag, options.width, iterations.data());
+        } else {
+            mandelbrot_row(view.centerX + deltaStart, pixel, view.centerY + deltaImag, options.width,
+                           options.maxIterations, iterations.data(), options.interiorCheck);
+        }
+
+        for (int x = 0; x < options.width; ++x, rgb += 3) {
+            float color[3];
+            palette_color(options.palette, iterations[x], options.maxIterations, color);
+            for (int channel = 0; channel < 3; ++channel) {
+                rgb[channel] = static_cast<uint8_t>(color[channel] * 255.0f + 0.5f);
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    RenderOptions options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        MemoryProbe memory;
+        memory.start();
+        auto start = std::chrono::steady_clock::now();
+
+        View view = makeView(options);
+        std::unique_ptr<image_writer> writer = make_image_writer(options.output, options.width, options.height);
+        WorkStealingPool pool(options.threads);
+        const size_t rowBytes = static_cast<size_t>(options.width) * 3;
+        std::vector<uint8_t> bands[2] = {std::vector<uint8_t>(rowBytes * options.bandRows),
+                                         std::vector<uint8_t>(rowBytes * options.bandRows)};
+        std::future<void> pendingWrite;
+
+        // Rows of a band are independent tasks, so workers that finish the cheap
+        // rows outside the set steal the expensive ones. A band is encoded and
+        // written while the next one is computed into the other buffer.
+        for (int bandStart = 0; bandStart < options.height; bandStart += options.bandRows) {
+            int rows = std::min(options.bandRows, options.height - bandStart);
+            std::vector<uint8_t>& band = bands[(bandStart / options.bandRows) % 2];
+            TaskGroup group(pool);
+            for (int row = 0; row < rows; ++row) {
+                group.run([&, row] {
+                    std::vector<int> iterations(options.width);
+                    renderRow(options, view, bandStart + row, iterations, band.data() + row * rowBytes);
+                });
+            }
+            group.wait();
+
+            if (pendingWrite.valid()) {
+                pendingWrite.get();
+            }
+            pendingWrite = std::async(std::launch::async, [&writer, &band, rows] {
+                writer->writeRows(band.data(), rows);
+            });
+        }
+        pendingWrite.get();
+        writer->finish();
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Rendered " << options.width << "x" << options.height << " to " << options.output << " in "
+                  << seconds << " s" << std::endl;
+        std::cout << "Memory: " << memory.stop().format() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -1,4 +1,13 @@
 #include "mandelbrot.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define MANDELBROT_HAS_X86_SIMD 1
+#endif
 
 // Helper function for recursive Mandelbrot calculation
 int mandelbrot_recursive(std::complex<double> c, std::complex<double> z, int iteration, int maxIterations) {
@@ -20,3 +29,314 @@ int mandelbrot(std::complex<double> c, int maxIterations) {
     return mandelbrot_recursive(c, std::complex<double>(0.0, 0.0), 0, maxIterations);
 }
 
+// Closed-form membership tests for the two largest components of the set
+bool in_cardioid_or_bulb(double re, double im) {
+    double yy = im * im;
+    double shifted = re - 0.25;
+    double q = shifted * shifted + yy;
+    if (q * (q + shifted) <= 0.25 * yy) {
+        return true;
+    }
+    return (re + 1.0) * (re + 1.0) + yy <= 0.0625;
+}
+
+namespace {
+    // |z|^2 = x*x + y*y is off by at most two ulps of 4, so outside this band it is on
+    // the same side of 4 as std::abs(z) is of 2. Inside it the batch kernels ask
+    // std::abs itself, which keeps their counts identical to mandelbrot().
+    constexpr double ESCAPE_NORM_LOW = 4.0 - 0x1p-48;
+    constexpr double ESCAPE_NORM_HIGH = 4.0 + 0x1p-48;
+
+    bool escapes(double x, double y, double norm) {
+        if (norm < ESCAPE_NORM_LOW || norm > ESCAPE_NORM_HIGH) {
+            return norm > ESCAPE_NORM_HIGH;
+        }
+        return std::abs(std::complex<double>(x, y)) > 2.0;
+    }
+
+    // Orbits that come back this close (in each coordinate) to a saved point are
+    // taken as cycling; attracting cycles converge far below it within a few periods
+    constexpr double PERIODICITY_TOLERANCE = 1e-13;
+
+    // Brent-style cycle detection keeps z from the last power-of-two iteration and
+    // compares every later z against it, so cycles of any period up to half the
+    // current iteration are caught within about twice their convergence time
+    bool isCheckpoint(int iteration) {
+        return (iteration & (iteration - 1)) == 0;
+    }
+
+    // Iterative form of mandelbrot_recursive. The update spells out what
+    // std::complex computes for z * z + c, so the orbits match bit for bit.
+    void mandelbrot_row_scalar(double re_start, double re_step, double im, int count, int maxIterations, int* out,
+                               bool detectInterior) {
+        for (int k = 0; k < count; ++k) {
+            double cr = static_cast<double>(k) * re_step + re_start;
+            if (detectInterior && in_cardioid_or_bulb(cr, im)) {
+                out[k] = maxIterations;
+                continue;
+            }
+            double x = 0.0;
+            double y = 0.0;
+            // NaN compares false until the first checkpoint is saved
+            double savedX = std::numeric_limits<double>::quiet_NaN();
+            double savedY = savedX;
+            int iteration = 0;
+            for (; iteration < maxIterations; ++iteration) {
+                double xx = x * x;
+                double yy = y * y;
+                if (escapes(x, y, xx + yy)) {
+                    break;
+                }
+                if (detectInterior) {
+                    if (std::fabs(x - savedX) <= PERIODICITY_TOLERANCE && std::fabs(y - savedY) <= PERIODICITY_TOLERANCE) {
+                        iteration = maxIterations;
+                        break;
+                    }
+                    if (isCheckpoint(iteration)) {
+                        savedX = x;
+                        savedY = y;
+                    }
+                }
+                double xy = x * y;
+                x = (xx - yy) + cr;
+                y = (xy + xy) + im;
+            }
+            out[k] = iteration;
+        }
+    }
+
+#ifdef MANDELBROT_HAS_X86_SIMD
+    // in_cardioid_or_bulb for four points; all-ones lanes are inside
+    __attribute__((target("avx2")))
+    __m256d in_cardioid_or_bulb_avx2(__m256d cr, __m256d ci) {
+        const __m256d quarter = _mm256_set1_pd(0.25);
+        __m256d yy = _mm256_mul_pd(ci, ci);
+        __m256d shifted = _mm256_sub_pd(cr, quarter);
+        __m256d q = _mm256_add_pd(_mm256_mul_pd(shifted, shifted), yy);
+        __m256d cardioid = _mm256_cmp_pd(_mm256_mul_pd(q, _mm256_add_pd(q, shifted)), _mm256_mul_pd(quarter, yy),
+                                         _CMP_LE_OQ);
+        __m256d bulbX = _mm256_add_pd(cr, _mm256_set1_pd(1.0));
+        __m256d bulb = _mm256_cmp_pd(_mm256_add_pd(_mm256_mul_pd(bulbX, bulbX), yy), _mm256_set1_pd(0.0625),
+                                     _CMP_LE_OQ);
+        return _mm256_or_pd(cardioid, bulb);
+    }
+
+    // Four points per register. Escaped lanes are masked out of the counter, and
+    // the group stops once every lane has escaped or maxIterations is reached.
+    // Lanes found to be interior leave the same way and report maxIterations.
+    __attribute__((target("avx2")))
+    void mandelbrot_row_avx2(double re_start, double re_step, double im, int count, int maxIterations, int* out,
+                             bool detectInterior) {
+        constexpr int LANES = 4;
+        const __m256d low = _mm256_set1_pd(ESCAPE_NORM_LOW);
+        const __m256d high = _mm256_set1_pd(ESCAPE_NORM_HIGH);
+        const __m256d one = _mm256_set1_pd(1.0);
+        const __m256d ci = _mm256_set1_pd(im);
+        const __m256d laneIndex = _mm256_setr_pd(0.0, 1.0, 2.0, 3.0);
+        const __m256d tolerance = _mm256_set1_pd(PERIODICITY_TOLERANCE);
+        const __m256d signBit = _mm256_set1_pd(-0.0);
+
+        for (int base = 0; base < count; base += LANES) {
+            int lanes = std::min(LANES, count - base);
+            __m256d index = _mm256_add_pd(_mm256_set1_pd(static_cast<double>(base)), laneIndex);
+            __m256d cr = _mm256_add_pd(_mm256_mul_pd(index, _mm256_set1_pd(re_step)), _mm256_set1_pd(re_start));
+            __m256d active = _mm256_cmp_pd(laneIndex, _mm256_set1_pd(static_cast<double>(lanes)), _CMP_LT_OQ);
+            __m256d interior = _mm256_setzero_pd();
+            if (detectInterior) {
+                interior = _mm256_and_pd(active, in_cardioid_or_bulb_avx2(cr, ci));
+                active = _mm256_andnot_pd(interior, active);
+            }
+            __m256d x = _mm256_setzero_pd();
+            __m256d y = _mm256_setzero_pd();
+            __m256d savedX = _mm256_set1_pd(std::numeric_limits<double>::quiet_NaN());
+            __m256d savedY = savedX;
+            __m256d iterations = _mm256_setzero_pd();
+
+            for (int iteration = 0; iteration < maxIterations; ++iteration) {
+                __m256d xx = _mm256_mul_pd(x, x);
+                __m256d yy = _mm256_mul_pd(y, y);
+                __m256d norm = _mm256_add_pd(xx, yy);
+                __m256d escaped = _mm256_cmp_pd(norm, high, _CMP_GT_OQ);
+                __m256d borderline = _mm256_and_pd(active, _mm256_and_pd(_mm256_cmp_pd(norm, low, _CMP_GE_OQ),
+                                                                         _mm256_cmp_pd(norm, high, _CMP_LE_OQ)));
+                if (_mm256_movemask_pd(borderline)) {
+                    alignas(32) double xs[LANES], ys[LANES], norms[LANES];
+                    alignas(32) long long escapedLanes[LANES];
+                    _mm256_store_pd(xs, x);
+                    _mm256_store_pd(ys, y);
+                    _mm256_store_pd(norms, norm);
+                    for (int lane = 0; lane < LANES; ++lane) {
+                        escapedLanes[lane] = escapes(xs[lane], ys[lane], norms[lane]) ? -1 : 0;
+                    }
+                    escaped = _mm256_castsi256_pd(_mm256_load_si256(reinterpret_cast<const __m256i*>(escapedLanes)));
+                }
+                active = _mm256_andnot_pd(escaped, active);
+                if (detectInterior) {
+                    __m256d closeX = _mm256_cmp_pd(_mm256_andnot_pd(signBit, _mm256_sub_pd(x, savedX)), tolerance,
+                                                   _CMP_LE_OQ);
+                    __m256d closeY = _mm256_cmp_pd(_mm256_andnot_pd(signBit, _mm256_sub_pd(y, savedY)), tolerance,
+                                                   _CMP_LE_OQ);
+                    __m256d cycling = _mm256_and_pd(active, _mm256_and_pd(closeX, closeY));
+                    interior = _mm256_or_pd(interior, cycling);
+                    active = _mm256_andnot_pd(cycling, active);
+                    if (isCheckpoint(iteration)) {
+                        savedX = x;
+                        savedY = y;
+                    }
+                }
+                if (!_mm256_movemask_pd(active)) {
+                    break;
+                }
+                iterations = _mm256_add_pd(iterations, _mm256_and_pd(active, one));
+                __m256d xy = _mm256_mul_pd(x, y);
+                x = _mm256_add_pd(_mm256_sub_pd(xx, yy), cr);
+                y = _mm256_add_pd(_mm256_add_pd(xy, xy), ci);
+            }
+
+            iterations = _mm256_blendv_pd(iterations, _mm256_set1_pd(static_cast<double>(maxIterations)), interior);
+            alignas(32) double counts[LANES];
+            _mm256_store_pd(counts, iterations);
+            for (int lane = 0; lane < lanes; ++lane) {
+                out[base + lane] = static_cast<int>(counts[lane]);
+            }
+        }
+    }
+
+    // in_cardioid_or_bulb for eight points as a lane mask
+    __attribute__((target("avx512f")))
+    __mmask8 in_cardioid_or_bulb_avx512(__m512d cr, __m512d ci) {
+        const __m512d quarter = _mm512_set1_pd(0.25);
+        __m512d yy = _mm512_mul_pd(ci, ci);
+        __m512d shifted = _mm512_sub_pd(cr, quarter);
+        __m512d q = _mm512_add_pd(_mm512_mul_pd(shifted, shifted), yy);
+        __mmask8 cardioid = _mm512_cmp_pd_mask(_mm512_mul_pd(q, _mm512_add_pd(q, shifted)),
+                                               _mm512_mul_pd(quarter, yy), _CMP_LE_OQ);
+        __m512d bulbX = _mm512_add_pd(cr, _mm512_set1_pd(1.0));
+        __mmask8 bulb = _mm512_cmp_pd_mask(_mm512_add_pd(_mm512_mul_pd(bulbX, bulbX), yy), _mm512_set1_pd(0.0625),
+                                           _CMP_LE_OQ);
+        return cardioid | bulb;
+    }
+
+    // Same kernel with eight lanes and the activity kept in a mask register
+    __attribute__((target("avx512f")))
+    void mandelbrot_row_avx512(double re_start, double re_step, double im, int count, int maxIterations, int* out,
+                               bool detectInterior) {
+        constexpr int LANES = 8;
+        const __m512d low = _mm512_set1_pd(ESCAPE_NORM_LOW);
+        const __m512d high = _mm512_set1_pd(ESCAPE_NORM_HIGH);
+        const __m512d one = _mm512_set1_pd(1.0);
+        const __m512d ci = _mm512_set1_pd(im);
+        const __m512d laneIndex = _mm512_setr_pd(0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0);
+        const __m512d tolerance = _mm512_set1_pd(PERIODICITY_TOLERANCE);
+
+        for (int base = 0; base < count; base += LANES) {
+            int lanes = std::min(LANES, count - base);
+            __m512d index = _mm512_add_pd(_mm512_set1_pd(static_cast<double>(base)), laneIndex);
+            __m512d cr = _mm512_add_pd(_mm512_mul_pd(index, _mm512_set1_pd(re_step)), _mm512_set1_pd(re_start));
+            __mmask8 active = static_cast<__mmask8>((1u << lanes) - 1);
+            __mmask8 interior = 0;
+            if (detectInterior) {
+                interior = active & in_cardioid_or_bulb_avx512(cr, ci);
+                active &= static_cast<__mmask8>(~interior);
+            }
+            __m512d x = _mm512_setzero_pd();
+            __m512d y = _mm512_setzero_pd();
+            __m512d savedX = _mm512_set1_pd(std::numeric_limits<double>::quiet_NaN());
+            __m512d savedY = savedX;
+            __m512d iterations = _mm512_setzero_pd();
+
+            for (int iteration = 0; iteration < maxIterations; ++iteration) {
+                __m512d xx = _mm512_mul_pd(x, x);
+                __m512d yy = _mm512_mul_pd(y, y);
+                __m512d norm = _mm512_add_pd(xx, yy);
+                __mmask8 escaped = _mm512_cmp_pd_mask(norm, high, _CMP_GT_OQ);
+                __mmask8 borderline = _mm512_mask_cmp_pd_mask(_mm512_mask_cmp_pd_mask(active, norm, low, _CMP_GE_OQ),
+                                                              norm, high, _CMP_LE_OQ);
+                if (borderline) {
+                    alignas(64) double xs[LANES], ys[LANES], norms[LANES];
+                    _mm512_store_pd(xs, x);
+                    _mm512_store_pd(ys, y);
+                    _mm512_store_pd(norms, norm);
+                    escaped = 0;
+                    for (int lane = 0; lane < LANES; ++lane) {
+                        escaped |= static_cast<__mmask8>(escapes(xs[lane], ys[lane], norms[lane]) << lane);
+                    }
+                }
+                active &= static_cast<__mmask8>(~escaped);
+                if (detectInterior) {
+                    __mmask8 closeX = _mm512_mask_cmp_pd_mask(active, _mm512_abs_pd(_mm512_sub_pd(x, savedX)),
+                                                              tolerance, _CMP_LE_OQ);
+                    __mmask8 cycling = _mm512_mask_cmp_pd_mask(closeX, _mm512_abs_pd(_mm512_sub_pd(y, savedY)),
+                                                               tolerance, _CMP_LE_OQ);
+                    interior |= cycling;
+                    active &= static_cast<__mmask8>(~cycling);
+                    if (isCheckpoint(iteration)) {
+                        savedX = x;
+                        savedY = y;
+                    }
+                }
+                if (!active) {
+                    break;
+                }
+                iterations = _mm512_mask_add_pd(iterations, active, iterations, one);
+                __m512d xy = _mm512_mul_pd(x, y);
+                x = _mm512_add_pd(_mm512_sub_pd(xx, yy), cr);
+                y = _mm512_add_pd(_mm512_add_pd(xy, xy), ci);
+            }
+
+            iterations = _mm512_mask_mov_pd(iterations, interior, _mm512_set1_pd(static_cast<double>(maxIterations)));
+            alignas(64) double counts[LANES];
+            _mm512_store_pd(counts, iterations);
+            for (int lane = 0; lane < lanes; ++lane) {
+                out[base + lane] = static_cast<int>(counts[lane]);
+            }
+        }
+    }
+#endif
+
+    using RowFunction = void (*)(double, double, double, int, int, int*, bool);
+
+    RowFunction rowFunction(RowKernel kernel) {
+        switch (kernel) {
+#ifdef MANDELBROT_HAS_X86_SIMD
+            case RowKernel::Avx512:
+                return mandelbrot_row_avx512;
+            case RowKernel::Avx2:
+                return mandelbrot_row_avx2;
+#endif
+            default:
+                return mandelbrot_row_scalar;
+        }
+    }
+}
+
+std::vector<RowKernel> supported_row_kernels() {
+    std::vector<RowKernel> kernels = {RowKernel::Scalar};
+#ifdef MANDELBROT_HAS_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.push_back(RowKernel::Avx2);
+    }
+    if (__builtin_cpu_supports("avx512f")) {
+        kernels.push_back(RowKernel::Avx512);
+    }
+#endif
+    return kernels;
+}
+
+// Escape-time counts for one row of points, widest kernel the CPU supports
+void mandelbrot_row(double re_start, double re_step, double im, int count, int maxIterations, int* out,
+                    InteriorCheck interiorCheck) {
+    // Resolved on first use, so the binary still starts on hosts without AVX2
+    static const RowFunction kernel = rowFunction(supported_row_kernels().back());
+    kernel(re_start, re_step, im, count, maxIterations, out, interiorCheck == InteriorCheck::On);
+}
+
+void mandelbrot_row(RowKernel kernel, double re_start, double re_step, double im, int count, int maxIterations,
+                    int* out, InteriorCheck interiorCheck) {
+    std::vector<RowKernel> supported = supported_row_kernels();
+    if (std::find(supported.begin(), supported.end(), kernel) == supported.end()) {
+        throw std::invalid_argument("Row kernel not supported by this CPU");
+    }
+    rowFunction(kernel)(re_start, re_step, im, count, maxIterations, out, interiorCheck == InteriorCheck::On);
+}
@@ -2,6 +2,7 @@
 #define MANDELBROT_H
 
 #include <complex>
+#include <vector>
 
 // Helper function for recursive Mandelbrot calculation
 // Parameters:
@@ -19,5 +20,39 @@ int mandelbrot_recursive(std::complex<double> c, std::complex<double> z, int ite
 // Returns: Number of iterations before divergence (or maxIterations if it doesn't diverge)
 int mandelbrot(std::complex<double> c, int maxIterations);
 
+// Whether mandelbrot_row looks for interior points before and while iterating.
+// Points in the main cardioid or the period-2 bulb are answered in closed form,
+// and orbits found revisiting a saved point (within a small tolerance) stop as
+// soon as the cycle shows. Either way the count is maxIterations, the same as
+// a point that never diverges; Off keeps the plain kernel for comparison.
+enum class InteriorCheck { Off, On };
+
+// Returns: Whether c = re + im*i lies in the main cardioid or the period-2 bulb
+bool in_cardioid_or_bulb(double re, double im);
+
+// Iteration counts for a row of points with a shared imaginary part, computed
+// without recursion and several points at a time (AVX2 / AVX-512 when available)
+// Parameters:
+//   re_start: Real part of the first point
+//   re_step: Distance between neighbouring points; point k has real part k * re_step + re_start
+//   im: Imaginary part of every point
+//   count: Number of points
+//   maxIterations: Maximum number of iterations to perform
+//   out: Receives count results, out[k] == mandelbrot(point k, maxIterations) for finite points
+//   interiorCheck: Whether interior points may stop early (see InteriorCheck)
+void mandelbrot_row(double re_start, double re_step, double im, int count, int maxIterations, int* out,
+                    InteriorCheck interiorCheck = InteriorCheck::On);
+
+// Batch kernels mandelbrot_row can run on, narrowest first
+enum class RowKernel { Scalar, Avx2, Avx512 };
+
+// Returns: The kernels this CPU supports, Scalar first; mandelbrot_row uses the last one
+std::vector<RowKernel> supported_row_kernels();
+
+// mandelbrot_row on the given kernel instead of the widest supported one, so that each
+// kernel can be checked on any host. Throws std::invalid_argument if the CPU lacks it.
+void mandelbrot_row(RowKernel kernel, double re_start, double re_step, double im, int count, int maxIterations,
+                    int* out, InteriorCheck interiorCheck = InteriorCheck::On);
+
 #endif // MANDELBROT_H
 
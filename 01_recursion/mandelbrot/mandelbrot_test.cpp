@@ -1,6 +1,16 @@
 #include <gtest/gtest.h>
+#include "fixed_real.h"
+#include "image_writer.h"
 #include "mandelbrot.h"
+#include "palette.h"
+#include "perturbation.h"
+#include <algorithm>
 #include <complex>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <vector>
 
 // Test that center point (0, 0) is in the Mandelbrot set
 TEST(MandelbrotTest, CenterPointInSet) {
@@ -64,3 +74,309 @@ TEST(MandelbrotTest, AnotherDiverging) {
     EXPECT_EQ(result, 0);  // Should diverge immediately at iteration 0
 }
 
+
+// Test that every batched row kernel the CPU supports agrees with mandelbrot() point by point
+TEST(MandelbrotTest, RowMatchesPointwise) {
+    const int count = 203;  // not a multiple of the lane count
+    const double step = 3.0 / count;
+    std::vector<int> row(count);
+    for (RowKernel kernel : supported_row_kernels()) {
+        for (double imag : {0.0, 0.1, 0.5, 0.75, 1.25}) {
+            mandelbrot_row(kernel, -2.25, step, imag, count, 500, row.data());
+            for (int k = 0; k < count; ++k) {
+                EXPECT_EQ(row[k], mandelbrot(std::complex<double>(k * step - 2.25, imag), 500))
+                    << "kernel " << static_cast<int>(kernel);
+            }
+        }
+    }
+    EXPECT_EQ(supported_row_kernels().front(), RowKernel::Scalar);
+}
+
+// Test points whose orbit lands exactly on |z| = 2, on every kernel
+TEST(MandelbrotTest, RowMatchesOnEscapeRadius) {
+    for (RowKernel kernel : supported_row_kernels()) {
+        int row[3];
+        mandelbrot_row(kernel, -2.0, 4.0, 0.0, 3, 100, row);  // c = -2, 2, 6
+        EXPECT_EQ(row[0], mandelbrot(std::complex<double>(-2.0, 0.0), 100)) << "kernel " << static_cast<int>(kernel);
+        EXPECT_EQ(row[1], mandelbrot(std::complex<double>(2.0, 0.0), 100)) << "kernel " << static_cast<int>(kernel);
+        EXPECT_EQ(row[2], mandelbrot(std::complex<double>(6.0, 0.0), 100)) << "kernel " << static_cast<int>(kernel);
+    }
+}
+
+// Test the closed-form interior regions against points known to be inside or outside them
+TEST(MandelbrotTest, CardioidAndBulb) {
+    EXPECT_TRUE(in_cardioid_or_bulb(0.0, 0.0));
+    EXPECT_TRUE(in_cardioid_or_bulb(0.25, 0.0));    // cusp of the cardioid
+    EXPECT_TRUE(in_cardioid_or_bulb(-0.5, 0.5));
+    EXPECT_TRUE(in_cardioid_or_bulb(-1.0, 0.0));    // centre of the period-2 bulb
+    EXPECT_TRUE(in_cardioid_or_bulb(-1.25, 0.0));   // its far edge
+    EXPECT_FALSE(in_cardioid_or_bulb(0.26, 0.0));
+    EXPECT_FALSE(in_cardioid_or_bulb(-1.3, 0.0));
+    EXPECT_FALSE(in_cardioid_or_bulb(-0.1225, 0.7449));  // period-3 bulb, interior but not covered
+}
+
+// Test that interior detection changes no count, on the points above and across views full of
+// interior, for every kernel
+TEST(MandelbrotTest, InteriorCheckMatchesPlainKernel) {
+    const std::complex<double> points[] = {{0.0, 0.0}, {-1.0, 0.0},  {-0.5, 0.5}, {0.5, 0.5}, {-0.7, 0.27015},
+                                           {0.25, 0.0}, {5.0, 5.0},   {2.0, 2.0},   {-2.0, 0.0}, {6.0, 0.0}};
+    // Whole set, the cusp, the seahorse valley and the period-3 bulb
+    const struct { double centerX, centerY, size; } views[] = {
+        {-0.5, 0.0, 3.0}, {0.25, 0.0, 1e-3}, {-0.7436, 0.1318, 1e-3}, {-0.1225, 0.7449, 0.05}};
+    const int count = 101;
+    std::vector<int> plain(count), checked(count);
+    for (RowKernel kernel : supported_row_kernels()) {
+        for (auto c : points) {
+            for (int maxIterations : {1, 100, 1000}) {
+                int result;
+                mandelbrot_row(kernel, c.real(), 0.0, c.imag(), 1, maxIterations, &result, InteriorCheck::On);
+                EXPECT_EQ(result, mandelbrot(c, maxIterations)) << "kernel " << static_cast<int>(kernel);
+            }
+        }
+
+        for (const auto& view : views) {
+            double step = view.size / count;
+            for (int row = 0; row < count; ++row) {
+                double imag = view.centerY + (row - count / 2) * step;
+                double realStart = view.centerX - (count / 2) * step;
+                mandelbrot_row(kernel, realStart, step, imag, count, 5000, plain.data(), InteriorCheck::Off);
+                mandelbrot_row(kernel, realStart, step, imag, count, 5000, checked.data(), InteriorCheck::On);
+                EXPECT_EQ(plain, checked) << "kernel " << static_cast<int>(kernel);
+            }
+        }
+    }
+}
+
+// Test that palettes are found by name and unknown names are rejected
+TEST(PaletteTest, ParsesNames) {
+    for (const auto& name : palette_names()) {
+        EXPECT_NO_THROW(parse_palette(name));
+    }
+    EXPECT_THROW(parse_palette("rainbow"), std::invalid_argument);
+
+    float rgb[3] = {1.0f, 1.0f, 1.0f};
+    palette_color(Palette::Fire, 100, 100, rgb);
+    EXPECT_EQ(rgb[0] + rgb[1] + rgb[2], 0.0f);  // Points in the set are black
+}
+
+// Test that a PPM is the header followed by the rows as written
+TEST(ImageWriterTest, PpmStreamsRows) {
+    std::string filename = testing::TempDir() + "mandelbrot_test.ppm";
+    std::vector<uint8_t> rgb = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    auto writer = make_image_writer(filename, 2, 2);
+    writer->writeRows(rgb.data(), 1);
+    writer->writeRows(rgb.data() + 6, 1);
+    writer->finish();
+
+    std::ifstream in(filename, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(contents, std::string("P6\n2 2\n255\n") + std::string(rgb.begin(), rgb.end()));
+}
+
+namespace {
+    struct PngChunk {
+        std::string type;
+        std::vector<uint8_t> data;
+    };
+
+    uint32_t readBigEndian(const uint8_t* bytes) {
+        return (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) | (uint32_t(bytes[2]) << 8) | bytes[3];
+    }
+
+    // Bitwise CRC-32, independent of the writer's table
+    uint32_t crc32(const uint8_t* data, size_t size) {
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < size; ++i) {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+            }
+        }
+        return ~crc;
+    }
+
+    // Checks the signature and every chunk's CRC, and returns the chunks in file order
+    std::vector<PngChunk> readPngChunks(const std::string& filename) {
+        std::ifstream in(filename, std::ios::binary);
+        std::vector<uint8_t> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        std::vector<PngChunk> chunks;
+        if (file.size() < 8 || !std::equal(signature, signature + 8, file.begin())) {
+            ADD_FAILURE() << "PNG signature missing";
+            return chunks;
+        }
+        size_t offset = 8;
+        while (offset + 12 <= file.size()) {
+            uint32_t length = readBigEndian(&file[offset]);
+            if (offset + 12 + length > file.size()) {
+                break;
+            }
+            const uint8_t* typeAndData = &file[offset + 4];
+            EXPECT_EQ(readBigEndian(typeAndData + 4 + length), crc32(typeAndData, 4 + length)) << "chunk at " << offset;
+            chunks.push_back({std::string(typeAndData, typeAndData + 4),
+                              std::vector<uint8_t>(typeAndData + 4, typeAndData + 4 + length)});
+            offset += 12 + length;
+        }
+        EXPECT_EQ(offset, file.size());
+        return chunks;
+    }
+
+    // Inflates a zlib stream made of stored blocks only and checks its Adler-32
+    std::vector<uint8_t> inflateStored(const std::vector<uint8_t>& stream) {
+        std::vector<uint8_t> data;
+        EXPECT_EQ((stream[0] * 256 + stream[1]) % 31, 0);  // header check bits
+        size_t offset = 2;
+        bool last = false;
+        while (!last && offset + 5 <= stream.size()) {
+            last = stream[offset] & 1;
+            EXPECT_EQ(stream[offset] >> 1, 0) << "not a stored block";
+            uint16_t length = stream[offset + 1] | (stream[offset + 2] << 8);
+            uint16_t complement = stream[offset + 3] | (stream[offset + 4] << 8);
+            EXPECT_EQ(length, static_cast<uint16_t>(~complement));
+            offset += 5;
+            data.insert(data.end(), stream.begin() + offset, stream.begin() + offset + length);
+            offset += length;
+        }
+        EXPECT_TRUE(last);
+        uint32_t a = 1, b = 0;
+        for (uint8_t byte : data) {
+            a = (a + byte) % 65521;
+            b = (b + a) % 65521;
+        }
+        EXPECT_EQ(offset + 4, stream.size());
+        EXPECT_EQ(readBigEndian(&stream[offset]), (b << 16) | a);
+        return data;
+    }
+}
+
+// Test that a stored PNG reads back: signature, chunk CRCs, header, zlib stream and pixels
+TEST(ImageWriterTest, PngReadsBack) {
+    std::string filename = testing::TempDir() + "mandelbrot_readback.png";
+    const int width = 150, height = 200;  // more image data than one stored block holds
+    std::vector<uint8_t> rgb(3 * width * height);
+    for (size_t i = 0; i < rgb.size(); ++i) {
+        rgb[i] = static_cast<uint8_t>(i * 7 + i / 301);
+    }
+    png_writer writer(filename, width, height, false);
+    writer.writeRows(rgb.data(), 3);
+    writer.writeRows(rgb.data() + 3 * width * 3, height - 3);
+    writer.finish();
+
+    std::vector<PngChunk> chunks = readPngChunks(filename);
+    ASSERT_GE(chunks.size(), 3u);
+    EXPECT_EQ(chunks.front().type, "IHDR");
+    ASSERT_EQ(chunks.front().data.size(), 13u);
+    EXPECT_EQ(readBigEndian(&chunks.front().data[0]), uint32_t(width));
+    EXPECT_EQ(readBigEndian(&chunks.front().data[4]), uint32_t(height));
+    EXPECT_EQ(chunks.front().data[8], 8);  // bits per channel
+    EXPECT_EQ(chunks.front().data[9], 2);  // RGB
+    EXPECT_EQ(chunks.back().type, "IEND");
+
+    std::vector<uint8_t> stream;
+    for (size_t i = 1; i + 1 < chunks.size(); ++i) {
+        EXPECT_EQ(chunks[i].type, "IDAT");
+        stream.insert(stream.end(), chunks[i].data.begin(), chunks[i].data.end());
+    }
+    std::vector<uint8_t> filtered = inflateStored(stream);
+    const size_t rowBytes = 3 * width;
+    ASSERT_EQ(filtered.size(), height * (1 + rowBytes));
+    std::vector<uint8_t> pixels;
+    for (int row = 0; row < height; ++row) {
+        const uint8_t* line = &filtered[row * (1 + rowBytes)];
+        ASSERT_EQ(line[0], 1) << "row " << row;  // Sub filter
+        for (size_t i = 0; i < rowBytes; ++i) {
+            pixels.push_back(static_cast<uint8_t>(line[1 + i] + (i >= 3 ? pixels[pixels.size() - 3] : 0)));
+        }
+    }
+    EXPECT_EQ(pixels, rgb);
+
+    // The default writer may compress, but its chunks are framed and checksummed the same way
+    auto compressed = make_image_writer(filename, width, height);
+    compressed->writeRows(rgb.data(), height);
+    compressed->finish();
+    chunks = readPngChunks(filename);
+    ASSERT_GE(chunks.size(), 3u);
+    EXPECT_EQ(chunks.front().type, "IHDR");
+    EXPECT_EQ(chunks.back().type, "IEND");
+}
+
+// Test that writers refuse files with missing or extra rows
+TEST(ImageWriterTest, RejectsWrongRowCount) {
+    std::string filename = testing::TempDir() + "mandelbrot_test.png";
+    std::vector<uint8_t> rgb(3 * 4 * 3);
+    auto writer = make_image_writer(filename, 4, 2);
+    EXPECT_THROW(writer->writeRows(rgb.data(), 3), std::runtime_error);
+    writer->writeRows(rgb.data(), 1);
+    EXPECT_THROW(writer->finish(), std::runtime_error);
+    EXPECT_THROW(make_image_writer(testing::TempDir() + "mandelbrot_test.bmp", 4, 2), std::invalid_argument);
+}
+
+// Test fixed-point arithmetic against doubles on exactly representable values
+TEST(FixedRealTest, ArithmeticMatchesDouble) {
+    fixed_real a(1.5, 2);
+    fixed_real b(-0.28125, 3);
+    EXPECT_EQ((a + b).toDouble(), 1.21875);
+    EXPECT_EQ((b - a).toDouble(), -1.78125);
+    EXPECT_EQ((a * b).toDouble(), -0.421875);
+    EXPECT_EQ((b * b).toDouble(), 0.0791015625);
+    EXPECT_EQ((a * b).fractionLimbs(), 3);
+}
+
+// Test that decimals keep digits far beyond double precision
+TEST(FixedRealTest, ParsesAndPrintsDecimals) {
+    const std::string decimal = "-0.743643887037158704752191506114774";
+    fixed_real value = fixed_real::parse(decimal, 3);
+    EXPECT_EQ(value.toString(30), decimal.substr(0, 33));  // Both directions truncate
+    double difference = (value - fixed_real::parse("-0.743643887037158704752191506114773", 3)).toDouble();
+    EXPECT_NEAR(difference, -1e-33, 1e-45);
+    EXPECT_THROW(fixed_real::parse("1e-5", 2), std::invalid_argument);
+}
+
+// Test that perturbation agrees with plain double iteration where doubles still suffice
+TEST(PerturbationTest, MatchesDoubleAtShallowZoom) {
+    const double centerX = -1.25066;
+    const double centerY = 0.02012;
+    const double step = 1e-7;
+    perturbation_engine engine(fixed_real::parse("-1.25066", 2), fixed_real::parse("0.02012", 2), 50 * step, 1000);
+    int agree = 0;
+    for (int y = -25; y < 25; ++y) {
+        for (int x = -25; x < 25; ++x) {
+            int expected = mandelbrot(std::complex<double>(centerX + x * step, centerY + y * step), 1000);
+            agree += std::abs(engine.iterate(x * step, y * step) - expected) <= 1;
+        }
+    }
+    EXPECT_GE(agree, 2500 * 99 / 100);  // Chaotic boundary points may differ by rounding
+}
+
+// Test a view far below double resolution against full fixed-point iteration
+TEST(PerturbationTest, DeepZoomMatchesFixedPoint) {
+    const int maxIterations = 6000;
+    const double step = 1e-16;
+    fixed_real centerX = fixed_real::parse("-0.743643887037158704752191506114774", 2);
+    fixed_real centerY = fixed_real::parse("0.131825904205311970493132056385139", 2);
+    perturbation_engine engine(centerX, centerY, 100 * step, maxIterations);
+    EXPECT_GT(engine.skippedIterations(), 0);
+
+    std::set<int> distinct;
+    for (int k = -50; k < 50; k += 10) {
+        fixed_real x = centerX + fixed_real(k * step, 2);
+        fixed_real y = centerY + fixed_real(-k * step, 2);
+        fixed_real zx(2);
+        fixed_real zy(2);
+        int expected = 0;
+        for (; expected < maxIterations; ++expected) {
+            fixed_real xx = zx * zx;
+            fixed_real yy = zy * zy;
+            if ((xx + yy).toDouble() > 4.0) {
+                break;
+            }
+            fixed_real xy = zx * zy;
+            zx = xx - yy + x;
+            zy = xy + xy + y;
+        }
+        int result = engine.iterate(k * step, -k * step);
+        EXPECT_NEAR(result, expected, 1);
+        distinct.insert(result);
+    }
+    EXPECT_GT(distinct.size(), 1u);  // Doubles would put this whole diagonal on one point
+}
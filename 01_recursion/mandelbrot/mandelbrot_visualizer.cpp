@@ -1,5 +1,8 @@
 #include "mandelbrot_visualizer.h"
 #include "mandelbrot.h"
+#include "palette.h"
+#include "perturbation.h"
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 
@@ -123,76 +126,83 @@ void mandelbrot_visualizer::initData() {
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
 
     // Position attribute
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
 
     // Color attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(2 * sizeof(float)));
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(float), (void*)(2 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
     updateMandelbrotData();
 }
 
 void mandelbrot_visualizer::updateMandelbrotData() {
-    vertices.clear();
-    colors.clear();
+    int columns = (width + SAMPLE_SPACING - 1) / SAMPLE_SPACING;
+    int rows = (height + SAMPLE_SPACING - 1) / SAMPLE_SPACING;
+    vertexCount = (size_t)columns * rows;
+    vertexData.resize(vertexCount * FLOATS_PER_VERTEX);
+
+    // Past double precision every sample is iterated as an offset from the centre's orbit
+    std::unique_ptr<perturbation_engine> deepZoom;
+    if (scale < perturbation_engine::DEEP_ZOOM_SCALE) {
+        float aspect_ratio = (float)width / (float)height;
+        double maxDelta = scale / 2.0 * std::sqrt(1.0 + 1.0 / ((double)aspect_ratio * aspect_ratio));
+        deepZoom = std::make_unique<perturbation_engine>(preciseCenterX, preciseCenterY, maxDelta, maxIterations);
+    }
+
+    // Tiles inside the set cost maxIterations per sample and the others a few,
+    // so the pool's idle workers steal whatever tiles are still queued
+    TaskGroup tiles(pool);
+    for (int row0 = 0; row0 < rows; row0 += TILE_SAMPLES) {
+        for (int column0 = 0; column0 < columns; column0 += TILE_SAMPLES) {
+            int row1 = std::min(row0 + TILE_SAMPLES, rows);
+            int column1 = std::min(column0 + TILE_SAMPLES, columns);
+            tiles.run([this, column0, column1, row0, row1, columns, engine = deepZoom.get()] {
+                computeTile(column0, column1, row0, row1, columns, engine);
+            });
+        }
+    }
+    tiles.wait();
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), GL_DYNAMIC_DRAW);
+
+    needsUpdate = false;
+}
 
+void mandelbrot_visualizer::computeTile(int column0, int column1, int row0, int row1, int columns,
+                                        const perturbation_engine* deepZoom) {
     float aspect_ratio = (float)width / (float)height;
-    int resolution = 3;  // Points per pixel (3x3 sampling)
 
-    for (int y = 0; y < height; y += resolution) {
-        for (int x = 0; x < width; x += resolution) {
+    // Mandelbrot space is affine in x, so every tile row is one batched call
+    double realStep = SAMPLE_SPACING * scale / ((double)width * aspect_ratio);
+    double deltaStart = -scale / (2.0 * aspect_ratio) + column0 * realStep;
+    int rowIterations[TILE_SAMPLES];
+
+    for (int row = row0; row < row1; ++row) {
+        int y = row * SAMPLE_SPACING;
+        float ndc_y = 1.0f - (2.0f * y / height);
+        double deltaImag = ndc_y * scale / 2.0;
+        if (deepZoom) {
+            deepZoom->iterateRow(deltaStart, realStep, deltaImag, column1 - column0, rowIterations);
+        } else {
+            mandelbrot_row(centerX + deltaStart, realStep, centerY + deltaImag, column1 - column0, maxIterations,
+                           rowIterations);
+        }
+
+        float* vertex = vertexData.data() + ((size_t)row * columns + column0) * FLOATS_PER_VERTEX;
+        for (int column = column0; column < column1; ++column, vertex += FLOATS_PER_VERTEX) {
             // Normalize to [-1, 1]
+            int x = column * SAMPLE_SPACING;
             float ndc_x = (2.0f * x / width) - 1.0f;
-            float ndc_y = 1.0f - (2.0f * y / height);
-
-            // Convert NDC to Mandelbrot space
-            double real = centerX + (ndc_x / aspect_ratio) * scale / 2.0;
-            double imag = centerY + ndc_y * scale / 2.0;
-
-            // Calculate Mandelbrot
-            int iterations = mandelbrot(std::complex<double>(real, imag), maxIterations);
+            vertex[0] = ndc_x;
+            vertex[1] = ndc_y;
 
             // Color based on iterations
-            float hue = (float)iterations / maxIterations;
-            float r, g, b;
-
-            if (iterations == maxIterations) {
-                // Black for points in the set
-                r = 0.0f;
-                g = 0.0f;
-                b = 0.0f;
-            } else {
-                // Color gradient based on escape time
-                hue = (float)std::sqrt((float)iterations / maxIterations);
-                r = std::sin(hue * 3.14159f) * 0.5f + 0.5f;
-                g = std::sin(hue * 3.14159f + 2.094f) * 0.5f + 0.5f;
-                b = std::sin(hue * 3.14159f + 4.189f) * 0.5f + 0.5f;
-            }
-
-            vertices.push_back(ndc_x);
-            vertices.push_back(ndc_y);
-            colors.push_back(r);
-            colors.push_back(g);
-            colors.push_back(b);
+            palette_color(Palette::Sine, rowIterations[column - column0], maxIterations, vertex + 2);
         }
     }
-
-    // Combine vertices and colors
-    std::vector<float> data;
-    for (size_t i = 0; i < vertices.size() / 2; ++i) {
-        data.push_back(vertices[i * 2]);
-        data.push_back(vertices[i * 2 + 1]);
-        data.push_back(colors[i * 3]);
-        data.push_back(colors[i * 3 + 1]);
-        data.push_back(colors[i * 3 + 2]);
-    }
-
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), data.data(), GL_DYNAMIC_DRAW);
-
-    needsUpdate = false;
 }
 
 void mandelbrot_visualizer::run() {
@@ -214,30 +224,41 @@ void mandelbrot_visualizer::processInput() {
         glfwSetWindowShouldClose(window, true);
 
     if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) {
-        maxIterations = std::min(maxIterations + 10, 2048);
+        maxIterations = std::min(maxIterations + std::max(10, maxIterations / 20), MAX_ITERATIONS);
         needsUpdate = true;
     }
     if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS) {
-        maxIterations = std::max(maxIterations - 10, 32);
+        maxIterations = std::max(maxIterations - std::max(10, maxIterations / 20), 32);
         needsUpdate = true;
     }
 
     if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) {
         centerX = -0.5;
         centerY = 0.0;
+        preciseCenterX = fixed_real(centerX, 1);
+        preciseCenterY = fixed_real(centerY, 1);
         scale = DEFAULT_SCALE;
         maxIterations = DEFAULT_MAX_ITERATIONS;
         needsUpdate = true;
     }
 }
 
+void mandelbrot_visualizer::moveCenter(double deltaX, double deltaY) {
+    // Enough fraction bits to place the centre on a pixel of the current view
+    int limbs = std::max(preciseCenterX.fractionLimbs(), fixed_real::limbsFor(scale / std::max(width, height)));
+    preciseCenterX = preciseCenterX.withPrecision(limbs) + fixed_real(deltaX, limbs);
+    preciseCenterY = preciseCenterY.withPrecision(limbs) + fixed_real(deltaY, limbs);
+    centerX = preciseCenterX.toDouble();
+    centerY = preciseCenterY.toDouble();
+}
+
 void mandelbrot_visualizer::render() {
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
 
     glUseProgram(shaderProgram);
     glBindVertexArray(VAO);
-    glDrawArrays(GL_POINTS, 0, vertices.size() / 2);
+    glDrawArrays(GL_POINTS, 0, vertexCount);
 }
 
 // Static Callbacks
@@ -269,8 +290,7 @@ void mandelbrot_visualizer::cursor_position_callback(GLFWwindow* window, double
         float dy = (float)(visualizer->lastMouseY - ypos) / visualizer->height;
 
         float aspect_ratio = (float)visualizer->width / visualizer->height;
-        visualizer->centerX -= dx * visualizer->scale / aspect_ratio;
-        visualizer->centerY += dy * visualizer->scale;
+        visualizer->moveCenter(-dx * visualizer->scale / aspect_ratio, dy * visualizer->scale);
 
         visualizer->lastMouseX = xpos;
         visualizer->lastMouseY = ypos;
@@ -3,6 +3,8 @@
 
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
+#include "fixed_real.h"
+#include "thread_pool.h"
 #include <vector>
 #include <string>
 
@@ -11,9 +13,15 @@ namespace MandelbrotConstants {
     constexpr int DEFAULT_HEIGHT = 900;
     constexpr float ZOOM_FACTOR = 1.1f;
     constexpr int DEFAULT_MAX_ITERATIONS = 256;
+    constexpr int MAX_ITERATIONS = 65536;  // Deep zooms need far more than the default
     constexpr float DEFAULT_SCALE = 3.5f;
+    constexpr int SAMPLE_SPACING = 3;      // Pixels between samples in both directions
+    constexpr int TILE_SAMPLES = 32;       // Tile edge length in samples, one pool task per tile
+    constexpr int FLOATS_PER_VERTEX = 5;   // x, y, r, g, b
 }
 
+class perturbation_engine;
+
 class mandelbrot_visualizer {
 public:
     mandelbrot_visualizer(int width, int height, const std::string& title);
@@ -29,6 +37,11 @@ private:
     void processInput();
     void render();
     void updateMandelbrotData();
+    // Fills the vertices of the samples in [column0, column1) x [row0, row1);
+    // deepZoom is set when the view is too small for plain double coordinates
+    void computeTile(int column0, int column1, int row0, int row1, int columns, const perturbation_engine* deepZoom);
+    // Moves the view centre by a distance in the complex plane
+    void moveCenter(double deltaX, double deltaY);
 
     // Callbacks
     static void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
@@ -44,8 +57,10 @@ private:
     unsigned int shaderProgram;
     unsigned int VAO, VBO;
 
-    std::vector<float> vertices;
-    std::vector<float> colors;
+    // Interleaved x, y, r, g, b per sample, row by row; tiles write disjoint parts of it
+    std::vector<float> vertexData;
+    size_t vertexCount = 0;
+    WorkStealingPool pool{std::thread::hardware_concurrency()};
 
     // Uniform locations
     int colorLoc;
@@ -53,6 +68,9 @@ private:
     // View State
     double centerX = -0.5;  // Real part of center
     double centerY = 0.0;   // Imaginary part of center
+    // The centre in fixed point, precise enough for any zoom; centerX / centerY are its rounding
+    fixed_real preciseCenterX = fixed_real(-0.5, 1);
+    fixed_real preciseCenterY = fixed_real(0.0, 1);
     double scale = MandelbrotConstants::DEFAULT_SCALE;  // How many units are visible
     int maxIterations = MandelbrotConstants::DEFAULT_MAX_ITERATIONS;
     bool isDragging = false;
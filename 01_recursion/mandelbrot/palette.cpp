@@ -0,0 +1,47 @@
+#include "palette.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+std::vector<std::string> palette_names() {
+    return {"sine", "grayscale", "fire"};
+}
+
+Palette parse_palette(const std::string& name) {
+    if (name == "sine") {
+        return Palette::Sine;
+    }
+    if (name == "grayscale") {
+        return Palette::Grayscale;
+    }
+    if (name == "fire") {
+        return Palette::Fire;
+    }
+    throw std::invalid_argument("Unknown palette: " + name);
+}
+
+void palette_color(Palette palette, int iterations, int maxIterations, float rgb[3]) {
+    if (iterations >= maxIterations) {
+        // Black for points in the set
+        rgb[0] = rgb[1] = rgb[2] = 0.0f;
+        return;
+    }
+
+    // The square root spreads the many quickly escaping points over more colours
+    float t = std::sqrt((float)iterations / maxIterations);
+    switch (palette) {
+        case Palette::Sine:
+            rgb[0] = std::sin(t * 3.14159f) * 0.5f + 0.5f;
+            rgb[1] = std::sin(t * 3.14159f + 2.094f) * 0.5f + 0.5f;
+            rgb[2] = std::sin(t * 3.14159f + 4.189f) * 0.5f + 0.5f;
+            break;
+        case Palette::Grayscale:
+            rgb[0] = rgb[1] = rgb[2] = t;
+            break;
+        case Palette::Fire:
+            rgb[0] = std::min(1.0f, 3.0f * t);
+            rgb[1] = std::clamp(3.0f * t - 1.0f, 0.0f, 1.0f);
+            rgb[2] = std::clamp(3.0f * t - 2.0f, 0.0f, 1.0f);
+            break;
+    }
+}
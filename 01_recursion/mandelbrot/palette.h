@@ -0,0 +1,28 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include <string>
+#include <vector>
+
+// Colour schemes shared by the visualizer and the headless renderer
+enum class Palette {
+    Sine,       // The visualizer's phase-shifted sine gradient
+    Grayscale,  // Dark to light with escape time
+    Fire        // Black through red and yellow to white
+};
+
+// Names accepted by parse_palette, in declaration order
+std::vector<std::string> palette_names();
+
+// Looks up a palette by name; throws std::invalid_argument for unknown names
+Palette parse_palette(const std::string& name);
+
+// Colour of a point from its escape time
+// Parameters:
+//   palette: Colour scheme to use
+//   iterations: Result of mandelbrot() for the point
+//   maxIterations: Iteration limit the result was computed with
+//   rgb: Receives red, green and blue in [0, 1]; points in the set are black
+void palette_color(Palette palette, int iterations, int maxIterations, float rgb[3]);
+
+#endif // PALETTE_H
@@ -0,0 +1,92 @@
+#include "perturbation.h"
+#include <cmath>
+
+perturbation_engine::perturbation_engine(const fixed_real& centerX, const fixed_real& centerY, double maxDelta,
+                                         int maxIterations)
+    : maxIterations(maxIterations) {
+    // Reference orbit in full precision; only its double rounding is kept
+    fixed_real x = fixed_real(centerX.fractionLimbs());
+    fixed_real y = fixed_real(centerY.fractionLimbs());
+    for (int iteration = 0; iteration <= maxIterations; ++iteration) {
+        orbitRe.push_back(x.toDouble());
+        orbitIm.push_back(y.toDouble());
+        fixed_real xx = x * x;
+        fixed_real yy = y * y;
+        if (iteration == maxIterations || (xx + yy).toDouble() > 4.0) {
+            break;
+        }
+        fixed_real xy = x * y;
+        x = xx - yy + centerX;
+        y = xy + xy + centerY;
+    }
+    computeSeries(maxDelta);
+}
+
+void perturbation_engine::computeSeries(double maxDelta) {
+    // dz_n = A_n dc + B_n dc^2 + C_n dc^3 + D_n dc^4 + ... with all coefficients 0 at n = 0 and
+    //   A_{n+1} = 2 Z_n A_n + 1            B_{n+1} = 2 Z_n B_n + A_n^2
+    //   C_{n+1} = 2 Z_n C_n + 2 A_n B_n    D_{n+1} = 2 Z_n D_n + 2 A_n C_n + B_n^2
+    // The first dropped term, D_n dc^4, estimates the truncation error.
+    std::complex<double> nextA, nextB, nextC, nextD;
+    const double r = maxDelta;
+    // The last orbit entry is kept for stepping, so the series stops one short of it
+    for (int n = 0; n + 1 < static_cast<int>(orbitRe.size()); ++n) {
+        if (n > 0 && !(std::abs(nextD) * r * r * r * r <= SERIES_TOLERANCE * std::abs(nextA) * r)) {
+            break;
+        }
+        skip = n;
+        a = nextA;
+        b = nextB;
+        c = nextC;
+        std::complex<double> d = nextD;
+        std::complex<double> twoZ(2.0 * orbitRe[n], 2.0 * orbitIm[n]);
+        nextA = twoZ * a + 1.0;
+        nextB = twoZ * b + a * a;
+        nextC = twoZ * c + 2.0 * a * b;
+        nextD = twoZ * d + 2.0 * a * c + b * b;
+    }
+}
+
+int perturbation_engine::iterate(double deltaRe, double deltaIm) const {
+    std::complex<double> dc(deltaRe, deltaIm);
+    std::complex<double> dz = ((c * dc + b) * dc + a) * dc;
+    int iterations = iterateFrom(skip, dz.real(), dz.imag(), deltaRe, deltaIm);
+    // Escaped already when the series hands over, at an iteration it skipped
+    if (iterations == skip && skip > 0) {
+        iterations = iterateFrom(0, 0.0, 0.0, deltaRe, deltaIm);
+    }
+    return iterations;
+}
+
+int perturbation_engine::iterateFrom(int start, double dzr, double dzi, double deltaRe, double deltaIm) const {
+    const int last = static_cast<int>(orbitRe.size()) - 1;
+    int reference = start;
+    for (int iteration = start; iteration < maxIterations; ++iteration) {
+        double zr = orbitRe[reference] + dzr;
+        double zi = orbitIm[reference] + dzi;
+        double norm = zr * zr + zi * zi;
+        if (norm > 4.0) {
+            return iteration;
+        }
+        // Rebase: continue from the orbit start with the point's full value as offset
+        if (norm < dzr * dzr + dzi * dzi || reference == last) {
+            dzr = zr;
+            dzi = zi;
+            reference = 0;
+        }
+        // dz' = (2 Z + dz) dz + dc
+        double tr = 2.0 * orbitRe[reference] + dzr;
+        double ti = 2.0 * orbitIm[reference] + dzi;
+        double nextRe = tr * dzr - ti * dzi + deltaRe;
+        dzi = tr * dzi + ti * dzr + deltaIm;
+        dzr = nextRe;
+        ++reference;
+    }
+    return maxIterations;
+}
+
+void perturbation_engine::iterateRow(double deltaStart, double deltaStep, double deltaIm, int count, int* out) const {
+    for (int k = 0; k < count; ++k) {
+        out[k] = iterate(static_cast<double>(k) * deltaStep + deltaStart, deltaIm);
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef PERTURBATION_H
+#define PERTURBATION_H
+
+#include "fixed_real.h"
+#include <complex>
+#include <vector>
+
+// Deep-zoom escape-time counts by perturbation theory. The orbit Z_n of the
+// view centre is computed once in fixed_real precision; every other point
+// C + dc only iterates its small offset dz_n from that orbit in double:
+//   dz_{n+1} = 2 * Z_n * dz_n + dz_n^2 + dc
+// When the offset outgrows the point itself (|Z_n + dz_n| < |dz_n|, a would-be
+// glitch) or the reference orbit ends, the point is rebased onto the start of
+// the reference orbit with dz = Z_n + dz_n. A cubic series in dc lets every
+// point skip the first iterations, which the whole view agrees on.
+class perturbation_engine {
+public:
+    // Below this view height double pixel coordinates collapse into blocks
+    static constexpr double DEEP_ZOOM_SCALE = 1e-12;
+
+    // Parameters:
+    //   centerX, centerY: Reference point, normally the centre of the view
+    //   maxDelta: Largest |dc| that will be asked for (half the view diagonal)
+    //   maxIterations: Maximum number of iterations to perform
+    perturbation_engine(const fixed_real& centerX, const fixed_real& centerY, double maxDelta, int maxIterations);
+
+    // Iteration count of the point (centerX + deltaRe, centerY + deltaIm), as mandelbrot() counts them
+    int iterate(double deltaRe, double deltaIm) const;
+
+    // Row form like mandelbrot_row: point k has the offset (k * deltaStep + deltaStart, deltaIm)
+    void iterateRow(double deltaStart, double deltaStep, double deltaIm, int count, int* out) const;
+
+    // Iterations the reference orbit lasted before escaping (maxIterations if it did not)
+    int referenceIterations() const { return static_cast<int>(orbitRe.size()) - 1; }
+    // Iterations every point skips through the series approximation
+    int skippedIterations() const { return skip; }
+
+private:
+    // Series skipping stops once the first dropped term could reach this fraction of the linear one
+    static constexpr double SERIES_TOLERANCE = 1e-10;
+
+    void computeSeries(double maxDelta);
+    // Iterates dz from iteration start, where it equals (dzr, dzi), onwards
+    int iterateFrom(int start, double dzr, double dzi, double deltaRe, double deltaIm) const;
+
+    std::vector<double> orbitRe;  // Z_0 .. Z_end rounded to double
+    std::vector<double> orbitIm;
+    int maxIterations;
+    int skip = 0;
+    // dz_skip ~= a * dc + b * dc^2 + c * dc^3
+    std::complex<double> a, b, c;
+};
+
+#endif // PERTURBATION_H
@@ -3,6 +3,7 @@
 //
 
 #include <iostream>
+#include "memory_stats.h"
 
 void tower_of_hanoi(unsigned int n, char from_rod, char to_rod, char aux_rod) {
     if (n == 1) {
@@ -21,6 +22,10 @@ int main(int argc, char *argv[]) {
         return 0;
     }
     int disk_count = std::stoi(argv[1]);
+    MemoryProbe memory;
+    memory.start();
     tower_of_hanoi(disk_count, 'A', 'C', 'B');
+    // stderr, so the list of moves on stdout stays clean
+    std::cerr << "Memory: " << memory.stop().format() << std::endl;
     return 0;
 }
\ No newline at end of file
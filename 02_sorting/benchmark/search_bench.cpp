@@ -0,0 +1,225 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "search_index.h"
+#include "sort_algorithms.h"
+#include "input_distributions.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    struct BenchConfig {
+        std::vector<std::string> indexes = searchIndexNames();
+        std::vector<size_t> sizes = {1000, 100000, 10000000};
+        std::vector<std::string> modes = {"single", "batch"};
+        size_t queries = 1000000;
+        // Fraction of the queries that ask for a stored key
+        double hitRatio = 0.5;
+        unsigned int warmups = 1;
+        unsigned int repetitions = 5;
+        uint64_t seed = 12345;
+        std::string csvFilename;
+    };
+
+    struct BenchResult {
+        std::string index;
+        std::string indexName;
+        std::string mode;
+        size_t size = 0;
+        size_t queries = 0;
+        double buildSeconds = 0.0;
+        double median = 0.0;
+        double nanosPerQuery = 0.0;
+        bool correct = true;
+    };
+
+    std::vector<std::string> splitList(const std::string& value) {
+        std::vector<std::string> items;
+        std::stringstream stream(value);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            if (!item.empty()) {
+                items.push_back(item);
+            }
+        }
+        return items;
+    }
+
+    // Stored keys and random keys mixed by the hit ratio, in random order
+    std::vector<int> makeQueries(const std::vector<int>& sorted, const BenchConfig& config) {
+        std::mt19937_64 rng(config.seed + 1);
+        std::uniform_int_distribution<int> anyKey(0, std::numeric_limits<int>::max());
+        std::uniform_int_distribution<size_t> anyPosition(0, sorted.size() - 1);
+        std::bernoulli_distribution hit(config.hitRatio);
+        std::vector<int> queries(config.queries);
+        for (auto& query : queries) {
+            query = hit(rng) ? sorted[anyPosition(rng)] : anyKey(rng);
+        }
+        return queries;
+    }
+
+    BenchResult runCase(const std::string& index, const std::string& mode, const std::vector<int>& sorted,
+                        const std::vector<int>& queries, const std::vector<size_t>& expected,
+                        const BenchConfig& config) {
+        BenchResult result;
+        result.index = index;
+        result.mode = mode;
+        result.size = sorted.size();
+        result.queries = queries.size();
+
+        auto buildStart = std::chrono::steady_clock::now();
+        std::unique_ptr<SearchIndex<int>> searchIndex = makeSearchIndex<int>(index, sorted);
+        result.buildSeconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - buildStart).count();
+        result.indexName = searchIndex->getName();
+
+        std::vector<double> samples;
+        std::vector<size_t> positions(queries.size());
+        for (unsigned int run = 0; run < config.warmups + config.repetitions; ++run) {
+            std::fill(positions.begin(), positions.end(), 0);
+            auto start = std::chrono::steady_clock::now();
+            if (mode == "batch") {
+                searchIndex->lowerBound(queries.data(), queries.size(), positions.data());
+            } else {
+                for (size_t i = 0; i < queries.size(); ++i) {
+                    positions[i] = searchIndex->lowerBound(queries[i]);
+                }
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            // Every run is verified against std::lower_bound
+            if (positions != expected) {
+                result.correct = false;
+            }
+            if (run >= config.warmups) {
+                samples.push_back(std::chrono::duration<double>(end - start).count());
+            }
+        }
+
+        std::sort(samples.begin(), samples.end());
+        result.median = samples[samples.size() / 2];
+        result.nanosPerQuery = queries.empty() ? 0.0 : result.median * 1e9 / queries.size();
+        return result;
+    }
+
+    void writeCsv(const std::string& filename, const std::vector<BenchResult>& results) {
+        std::ofstream out(filename);
+        if (!out.is_open()) {
+            std::cerr << "Unable to open output file: " << filename << std::endl;
+            return;
+        }
+        out << "index,name,mode,size,queries,build_s,median_s,ns_per_query,correct\n";
+        out << std::setprecision(9);
+        for (const auto& r : results) {
+            out << r.index << ",\"" << r.indexName << "\"," << r.mode << "," << r.size << "," << r.queries << ","
+                << r.buildSeconds << "," << r.median << "," << r.nanosPerQuery << ","
+                << (r.correct ? "true" : "false") << "\n";
+        }
+    }
+
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program << " [--indexes a,b,...] [--sizes n,m,...] [--modes single,batch]"
+                  << " [--queries <count>] [--hit-ratio <0..1>] [--warmup <runs>] [--repetitions <runs>]"
+                  << " [--seed <seed>] [--csv <file>]" << std::endl;
+        std::cerr << "Indexes:";
+        for (const auto& name : searchIndexNames()) {
+            std::cerr << " " << name;
+        }
+        std::cerr << std::endl;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    BenchConfig config;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string flag = argv[i];
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + flag);
+            }
+            std::string value = argv[++i];
+            if (flag == "--indexes") {
+                config.indexes = splitList(value);
+            } else if (flag == "--sizes") {
+                config.sizes.clear();
+                for (const auto& size : splitList(value)) {
+                    config.sizes.push_back(std::max(1ull, std::stoull(size)));
+                }
+            } else if (flag == "--modes") {
+                config.modes = splitList(value);
+                for (const auto& mode : config.modes) {
+                    if (mode != "single" && mode != "batch") {
+                        throw std::invalid_argument("Unknown mode " + mode);
+                    }
+                }
+            } else if (flag == "--queries") {
+                config.queries = std::stoull(value);
+            } else if (flag == "--hit-ratio") {
+                config.hitRatio = std::clamp(std::stod(value), 0.0, 1.0);
+            } else if (flag == "--warmup") {
+                config.warmups = std::stoul(value);
+            } else if (flag == "--repetitions") {
+                config.repetitions = std::max(1ul, std::stoul(value));
+            } else if (flag == "--seed") {
+                config.seed = std::stoull(value);
+            } else if (flag == "--csv") {
+                config.csvFilename = value;
+            } else {
+                throw std::invalid_argument("Unknown option " + flag);
+            }
+        }
+
+        std::vector<BenchResult> results;
+        std::cout << std::left << std::setw(11) << "index" << std::setw(8) << "mode" << std::right << std::setw(12)
+                  << "size" << std::setw(12) << "build [s]" << std::setw(13) << "median [s]" << std::setw(12)
+                  << "ns/query" << "  check" << std::endl;
+        for (size_t size : config.sizes) {
+            std::vector<int> sorted = generateDistribution<int>(Distribution::Random, size, config.seed);
+            PdqSort<int>().sort(sorted);
+            std::vector<int> queries = makeQueries(sorted, config);
+            std::vector<size_t> expected(queries.size());
+            for (size_t i = 0; i < queries.size(); ++i) {
+                expected[i] = std::lower_bound(sorted.begin(), sorted.end(), queries[i]) - sorted.begin();
+            }
+
+            for (const auto& index : config.indexes) {
+                for (const auto& mode : config.modes) {
+                    BenchResult result = runCase(index, mode, sorted, queries, expected, config);
+                    std::cout << std::left << std::setw(11) << result.index << std::setw(8) << result.mode
+                              << std::right << std::setw(12) << result.size << std::setw(12) << result.buildSeconds
+                              << std::setw(13) << result.median << std::setw(12) << result.nanosPerQuery << "  "
+                              << (result.correct ? "ok" : "WRONG") << std::endl;
+                    results.push_back(result);
+                }
+            }
+        }
+
+        if (!config.csvFilename.empty()) {
+            writeCsv(config.csvFilename, results);
+        }
+
+        // A wrong index must not look like a successful benchmark
+        for (const auto& result : results) {
+            if (!result.correct) {
+                return 2;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    return 0;
+}
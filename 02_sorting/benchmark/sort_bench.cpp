@@ -0,0 +1,349 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "sort_algorithms.h"
+#include "input_distributions.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+    // Strategies with quadratic worst case are skipped above this size unless overridden
+    constexpr size_t DEFAULT_MAX_QUADRATIC_SIZE = 1 << 16;
+    const std::vector<std::string> QUADRATIC_STRATEGIES = {"insertion"};
+    // Strategies that only sort plain integer keys in the direct mode
+    const std::vector<std::string> INTEGER_ONLY_STRATEGIES = {"radix"};
+
+    struct BenchConfig {
+        std::vector<std::string> algorithms = sortStrategyNames();
+        std::vector<size_t> sizes = {1000, 100000, 1000000};
+        std::vector<std::string> distributions = distributionNames();
+        // 0 sorts plain int keys, anything else Record<payload>
+        std::vector<size_t> payloads = {0};
+        std::vector<std::string> modes = {"direct"};
+        unsigned int warmups = 1;
+        unsigned int repetitions = 5;
+        unsigned int threads = std::thread::hardware_concurrency();
+        uint64_t seed = 12345;
+        size_t maxQuadraticSize = DEFAULT_MAX_QUADRATIC_SIZE;
+        std::string csvFilename;
+        std::string jsonFilename;
+    };
+
+    struct BenchResult {
+        std::string algorithm;
+        std::string strategyName;
+        std::string distribution;
+        size_t size = 0;
+        size_t payload = 0;
+        std::string mode;
+        unsigned int repetitions = 0;
+        double min = 0.0;
+        double median = 0.0;
+        double p95 = 0.0;
+        double mean = 0.0;
+        double elementsPerSecond = 0.0;
+        bool correct = true;
+    };
+
+    std::vector<std::string> splitList(const std::string& value) {
+        std::vector<std::string> items;
+        std::stringstream stream(value);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            if (!item.empty()) {
+                items.push_back(item);
+            }
+        }
+        return items;
+    }
+
+    // Nearest-rank percentile of already sorted samples
+    double percentile(const std::vector<double>& sorted, double fraction) {
+        size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    }
+
+    // Records carry their input position in the first payload bytes so the output can be checked
+    template <typename T>
+    std::vector<T> makeInput(const std::vector<int>& keys) {
+        if constexpr (std::is_same_v<T, int>) {
+            return keys;
+        } else {
+            std::vector<T> records(keys.size());
+            for (size_t i = 0; i < keys.size(); ++i) {
+                records[i].key = keys[i];
+                uint32_t position = static_cast<uint32_t>(i);
+                std::memcpy(records[i].payload, &position, sizeof(position));
+            }
+            return records;
+        }
+    }
+
+    // The keys must match the sorted reference and every record must be an intact input record
+    template <typename T>
+    bool isSortedPermutation(const std::vector<T>& output, const std::vector<T>& input, const std::vector<int>& sortedKeys) {
+        if (output.size() != sortedKeys.size()) {
+            return false;
+        }
+        if constexpr (std::is_same_v<T, int>) {
+            return output == sortedKeys;
+        } else {
+            std::vector<bool> seen(input.size(), false);
+            for (size_t i = 0; i < output.size(); ++i) {
+                uint32_t position;
+                std::memcpy(&position, output[i].payload, sizeof(position));
+                if (output[i].key != sortedKeys[i] || position >= input.size() || seen[position]
+                    || input[position].key != output[i].key) {
+                    return false;
+                }
+                seen[position] = true;
+            }
+            return true;
+        }
+    }
+
+    template <typename T>
+    BenchResult runCase(const std::string& algorithm, Distribution distribution, size_t size, size_t payload,
+                        const std::string& mode, const BenchConfig& config) {
+        SortOptions options;
+        options.algorithm = algorithm;
+        options.threads = config.threads;
+        options.indirect = mode == "indirect";
+        auto strategy = makeSortStrategy<T>(options);
+
+        std::vector<int> reference = generateDistribution<int>(distribution, size, config.seed);
+        const std::vector<T> input = makeInput<T>(reference);
+        std::sort(reference.begin(), reference.end());
+
+        BenchResult result;
+        result.algorithm = algorithm;
+        result.strategyName = strategy->getName();
+        result.distribution = distributionName(distribution);
+        result.size = size;
+        result.payload = payload;
+        result.mode = mode;
+        result.repetitions = config.repetitions;
+
+        std::vector<double> samples;
+        std::vector<T> work;
+        // Scratch is allocated by the warm-up and reused by the measured runs
+        ScratchArena scratch;
+        for (unsigned int run = 0; run < config.warmups + config.repetitions; ++run) {
+            work = input;
+            auto start = std::chrono::steady_clock::now();
+            strategy->sort(work, scratch);
+            auto end = std::chrono::steady_clock::now();
+
+            // Every run is verified, a wrong answer disqualifies the case
+            if (!isSortedPermutation(work, input, reference)) {
+                result.correct = false;
+            }
+            if (run >= config.warmups) {
+                samples.push_back(std::chrono::duration<double>(end - start).count());
+            }
+        }
+
+        std::sort(samples.begin(), samples.end());
+        result.min = samples.front();
+        result.median = percentile(samples, 0.5);
+        result.p95 = percentile(samples, 0.95);
+        double total = 0.0;
+        for (double sample : samples) {
+            total += sample;
+        }
+        result.mean = total / samples.size();
+        result.elementsPerSecond = result.median > 0.0 ? size / result.median : 0.0;
+        return result;
+    }
+
+    BenchResult runPayloadCase(const std::string& algorithm, Distribution distribution, size_t size, size_t payload,
+                               const std::string& mode, const BenchConfig& config) {
+        switch (payload) {
+            case 0:
+                return runCase<int>(algorithm, distribution, size, payload, mode, config);
+#define RUN_RECORD_CASE(P) \
+            case P: \
+                return runCase<Record<P>>(algorithm, distribution, size, payload, mode, config);
+            SORT_RECORD_PAYLOADS(RUN_RECORD_CASE)
+#undef RUN_RECORD_CASE
+            default:
+                throw std::invalid_argument("Unsupported payload size " + std::to_string(payload));
+        }
+    }
+
+    void writeCsv(const std::string& filename, const std::vector<BenchResult>& results) {
+        std::ofstream out(filename);
+        if (!out.is_open()) {
+            std::cerr << "Unable to open output file: " << filename << std::endl;
+            return;
+        }
+        out << "algorithm,strategy,distribution,size,payload,mode,repetitions,min_s,median_s,p95_s,mean_s,elements_per_s,correct\n";
+        out << std::setprecision(9);
+        for (const auto& r : results) {
+            out << r.algorithm << ",\"" << r.strategyName << "\"," << r.distribution << "," << r.size << ","
+                << r.payload << "," << r.mode << "," << r.repetitions << "," << r.min << "," << r.median << "," << r.p95 << "," << r.mean << ","
+                << r.elementsPerSecond << "," << (r.correct ? "true" : "false") << "\n";
+        }
+    }
+
+    void writeJson(const std::string& filename, const std::vector<BenchResult>& results) {
+        std::ofstream out(filename);
+        if (!out.is_open()) {
+            std::cerr << "Unable to open output file: " << filename << std::endl;
+            return;
+        }
+        out << std::setprecision(9) << "[\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const auto& r = results[i];
+            out << "  {\"algorithm\": \"" << r.algorithm << "\", \"strategy\": \"" << r.strategyName
+                << "\", \"distribution\": \"" << r.distribution << "\", \"size\": " << r.size
+                << ", \"payload\": " << r.payload << ", \"mode\": \"" << r.mode
+                << "\", \"repetitions\": " << r.repetitions << ", \"min_s\": " << r.min
+                << ", \"median_s\": " << r.median << ", \"p95_s\": " << r.p95 << ", \"mean_s\": " << r.mean
+                << ", \"elements_per_s\": " << r.elementsPerSecond
+                << ", \"correct\": " << (r.correct ? "true" : "false") << "}"
+                << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "]\n";
+    }
+
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program << " [--algorithms a,b,...] [--sizes n,m,...] [--distributions d,e,...]"
+                  << " [--payloads 0,64,...] [--modes direct,indirect]"
+                  << " [--warmup <runs>] [--repetitions <runs>] [--threads <count>] [--seed <seed>]"
+                  << " [--max-quadratic-size <n>] [--csv <file>] [--json <file>]" << std::endl;
+        std::cerr << "Algorithms:";
+        for (const auto& name : sortStrategyNames()) {
+            std::cerr << " " << name;
+        }
+        std::cerr << std::endl << "Payloads: 0 (plain int keys)";
+#define PRINT_PAYLOAD(P) std::cerr << " " << P;
+        SORT_RECORD_PAYLOADS(PRINT_PAYLOAD)
+#undef PRINT_PAYLOAD
+        std::cerr << std::endl << "Distributions:";
+        for (const auto& name : distributionNames()) {
+            std::cerr << " " << name;
+        }
+        std::cerr << std::endl;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    BenchConfig config;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string flag = argv[i];
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + flag);
+            }
+            std::string value = argv[++i];
+            if (flag == "--algorithms") {
+                config.algorithms = splitList(value);
+            } else if (flag == "--sizes") {
+                config.sizes.clear();
+                for (const auto& size : splitList(value)) {
+                    config.sizes.push_back(std::stoull(size));
+                }
+            } else if (flag == "--distributions") {
+                config.distributions = splitList(value);
+            } else if (flag == "--payloads") {
+                config.payloads.clear();
+                for (const auto& payload : splitList(value)) {
+                    config.payloads.push_back(std::stoull(payload));
+                }
+            } else if (flag == "--modes") {
+                config.modes = splitList(value);
+                for (const auto& mode : config.modes) {
+                    if (mode != "direct" && mode != "indirect") {
+                        throw std::invalid_argument("Unknown mode " + mode);
+                    }
+                }
+            } else if (flag == "--warmup") {
+                config.warmups = std::stoul(value);
+            } else if (flag == "--repetitions") {
+                config.repetitions = std::max(1ul, std::stoul(value));
+            } else if (flag == "--threads") {
+                config.threads = std::stoul(value);
+            } else if (flag == "--seed") {
+                config.seed = std::stoull(value);
+            } else if (flag == "--max-quadratic-size") {
+                config.maxQuadraticSize = std::stoull(value);
+            } else if (flag == "--csv") {
+                config.csvFilename = value;
+            } else if (flag == "--json") {
+                config.jsonFilename = value;
+            } else {
+                throw std::invalid_argument("Unknown option " + flag);
+            }
+        }
+
+        std::vector<Distribution> distributions;
+        for (const auto& name : config.distributions) {
+            distributions.push_back(parseDistribution(name));
+        }
+
+        std::vector<BenchResult> results;
+        std::cout << std::left << std::setw(16) << "algorithm" << std::setw(15) << "distribution"
+                  << std::setw(9) << "mode" << std::right << std::setw(10) << "size" << std::setw(8) << "payload" << std::setw(13) << "min [s]" << std::setw(13)
+                  << "median [s]" << std::setw(13) << "p95 [s]" << std::setw(14) << "Melem/s" << "  check" << std::endl;
+        for (const auto& algorithm : config.algorithms) {
+            bool quadratic = std::find(QUADRATIC_STRATEGIES.begin(), QUADRATIC_STRATEGIES.end(), algorithm)
+                             != QUADRATIC_STRATEGIES.end();
+            bool integerOnly = std::find(INTEGER_ONLY_STRATEGIES.begin(), INTEGER_ONLY_STRATEGIES.end(), algorithm)
+                               != INTEGER_ONLY_STRATEGIES.end();
+            for (Distribution distribution : distributions) {
+                for (size_t size : config.sizes) {
+                    if (quadratic && size > config.maxQuadraticSize) {
+                        continue;
+                    }
+                    for (size_t payload : config.payloads) {
+                        for (const auto& mode : config.modes) {
+                            if (integerOnly && payload > 0 && mode == "direct") {
+                                continue;
+                            }
+                            BenchResult result = runPayloadCase(algorithm, distribution, size, payload, mode, config);
+                            std::cout << std::left << std::setw(16) << result.algorithm << std::setw(15)
+                                      << result.distribution << std::setw(9) << result.mode << std::right
+                                      << std::setw(10) << result.size << std::setw(8) << result.payload
+                                      << std::setw(13) << result.min << std::setw(13) << result.median
+                                      << std::setw(13) << result.p95 << std::setw(14) << result.elementsPerSecond / 1e6
+                                      << "  " << (result.correct ? "ok" : "WRONG") << std::endl;
+                            results.push_back(result);
+                        }
+                    }
+                }
+            }
+        }
+
+        if (!config.csvFilename.empty()) {
+            writeCsv(config.csvFilename, results);
+        }
+        if (!config.jsonFilename.empty()) {
+            writeJson(config.jsonFilename, results);
+        }
+
+        // A wrong strategy must not look like a successful benchmark
+        for (const auto& result : results) {
+            if (!result.correct) {
+                return 2;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    return 0;
+}
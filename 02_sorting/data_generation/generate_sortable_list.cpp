@@ -2,68 +2,153 @@
 // Created by keret on 2026. 02. 15..
 //
 
-#include <iostream>
-#include <random>
-#include <vector>
-#include <numeric>
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
 #include <string>
-#include <fstream>
+#include <thread>
+#include <vector>
+#include "data_writer.h"
+#include "input_distributions.h"
+#include "memory_stats.h"
+#include "thread_pool.h"
 
-struct RandomGenerator {
-    std::mt19937_64 sampler;
-    std::vector<unsigned int> available_numbers;
+namespace {
+    // Blocks generated per thread before a batch is handed to the writer
+    constexpr size_t BLOCKS_PER_THREAD = 4;
 
-    RandomGenerator(unsigned int seed, unsigned int max_val): sampler(seed) {
-        available_numbers.resize(max_val);
-        std::iota(available_numbers.begin(), available_numbers.end(), 0);
-    }
+    struct GeneratorConfig {
+        uint64_t count = 0;
+        std::string outputFile;
+        std::string type = "int32";
+        Distribution distribution = Distribution::Unique;
+        DistributionOptions options;
+        unsigned int threads = std::thread::hardware_concurrency();
+    };
 
-    unsigned int sample_non_repeatable() {
-        if (available_numbers.empty()) {
-            throw std::runtime_error("No more numbers to sample");
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program << " <max_value> <count> <output_file>"
+                  << " [--distribution <name>] [--type int32|int64] [--seed <seed>] [--threads <count>]"
+                  << " [--swaps <k>] [--unique-keys <n>] [--zipf-exponent <s>]" << std::endl;
+        std::cerr << "Keys are drawn from [0, max_value); 0 selects every non-negative key of the type." << std::endl;
+        std::cerr << "Distributions:";
+        for (const auto& name : distributionNames()) {
+            std::cerr << " " << name;
         }
+        std::cerr << std::endl;
+    }
 
-        std::uniform_int_distribution<size_t> dist(0, available_numbers.size() - 1);
-        size_t index = dist(sampler);
+    // Blocks are produced in parallel batches into one of two buffers while
+    // the previous batch is written out, so generation and I/O overlap.
+    // Every block has its own seeded substream: the output does not depend on the thread count.
+    template <typename T>
+    void generate(const GeneratorConfig& config) {
+        constexpr size_t blockSize = DistributionGenerator<T>::BLOCK_SIZE;
+        DistributionGenerator<T> generator(config.distribution, config.count, config.options);
+        DatasetWriter<T> writer(config.outputFile);
 
-        unsigned int result = available_numbers[index];
+        unsigned int threads = std::max(1u, config.threads);
+        std::unique_ptr<WorkStealingPool> pool;
+        if (threads > 1) {
+            pool = std::make_unique<WorkStealingPool>(threads - 1);
+        }
+        uint64_t blocksPerBatch = threads * BLOCKS_PER_THREAD;
+        std::vector<T> buffers[2];
+        std::future<void> pendingWrite;
 
-        // Swap with the last element and pop back for O(1) removal
-        std::swap(available_numbers[index], available_numbers.back());
-        available_numbers.pop_back();
+        for (uint64_t firstBlock = 0, batch = 0; firstBlock < generator.blockCount(); firstBlock += blocksPerBatch, ++batch) {
+            std::vector<T>& buffer = buffers[batch % 2];
+            uint64_t blocks = std::min(blocksPerBatch, generator.blockCount() - firstBlock);
+            buffer.resize(blocks * blockSize);
+            auto generateBlock = [&generator, &buffer, firstBlock](uint64_t block) {
+                generator.generateBlock(firstBlock + block, buffer.data() + block * blockSize);
+            };
+            if (pool) {
+                TaskGroup group(*pool);
+                for (uint64_t block = 0; block < blocks; ++block) {
+                    group.run([&generateBlock, block] { generateBlock(block); });
+                }
+                group.wait();
+            } else {
+                for (uint64_t block = 0; block < blocks; ++block) {
+                    generateBlock(block);
+                }
+            }
 
-        return result;
+            size_t produced = static_cast<size_t>(std::min<uint64_t>(blocks * blockSize, config.count - firstBlock * blockSize));
+            if (pendingWrite.valid()) {
+                pendingWrite.get();
+            }
+            pendingWrite = std::async(std::launch::async, [&writer, &buffer, produced] {
+                writer.write(buffer.data(), produced);
+            });
+        }
+        if (pendingWrite.valid()) {
+            pendingWrite.get();
+        }
+        writer.close();
     }
-};
+}
 
 int main(int argc, char *argv[]) {
     if (argc < 4) {
-        std::cerr << "Usage: " << argv[0] << " <max_value> <count> <output_file>" << std::endl;
+        printUsage(argv[0]);
         return 1;
     }
 
-    unsigned int max_val = std::stoi(argv[1]);
-    unsigned int count = std::stoi(argv[2]);
-    std::string output_file = argv[3];
-
-    if (count > max_val) {
-        std::cerr << "Error: count cannot be greater than max_value" << std::endl;
-        return 1;
-    }
+    GeneratorConfig config;
+    try {
+        config.options.domain = std::stoull(argv[1]);
+        config.count = std::stoull(argv[2]);
+        config.outputFile = argv[3];
+        for (int i = 4; i < argc; ++i) {
+            std::string flag = argv[i];
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + flag);
+            }
+            std::string value = argv[++i];
+            if (flag == "--distribution") {
+                config.distribution = parseDistribution(value);
+            } else if (flag == "--type") {
+                config.type = value;
+            } else if (flag == "--seed") {
+                config.options.seed = std::stoull(value);
+            } else if (flag == "--threads") {
+                config.threads = std::stoul(value);
+            } else if (flag == "--swaps") {
+                config.options.swaps = std::stoull(value);
+            } else if (flag == "--unique-keys") {
+                config.options.uniqueKeys = std::stoull(value);
+            } else if (flag == "--zipf-exponent") {
+                config.options.zipfExponent = std::stod(value);
+            } else {
+                throw std::invalid_argument("Unknown option " + flag);
+            }
+        }
 
-    std::ofstream out(output_file);
-    if (!out.is_open()) {
-        std::cerr << "Error: could not open file " << output_file << std::endl;
+        MemoryProbe memory;
+        memory.start();
+        auto start = std::chrono::high_resolution_clock::now();
+        // The .bin extension selects the binary container, anything else is one number per line
+        if (config.type == "int32") {
+            generate<int>(config);
+        } else if (config.type == "int64") {
+            generate<int64_t>(config);
+        } else {
+            throw std::invalid_argument("Unknown key type " + config.type);
+        }
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+        std::cout << "Generated " << config.count << " " << distributionName(config.distribution) << " keys in "
+                  << elapsed.count() << " seconds" << std::endl;
+        std::cout << "Memory: " << memory.stop().format() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage(argv[0]);
         return 1;
     }
-
-    RandomGenerator gen(12345, max_val);
-    for(unsigned int i=0; i<count; ++i) {
-        out << gen.sample_non_repeatable() << std::endl;
-    }
-    out << std::endl;
-
-    out.close();
     return 0;
-}
\ No newline at end of file
+}
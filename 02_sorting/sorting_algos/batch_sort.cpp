@@ -0,0 +1,342 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "batch_sort.h"
+#include "binary_dataset.h"
+#include <algorithm>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    // Counting semaphore over bytes. Requests above the total are clamped to
+    // it, so an oversized job waits until it can run alone instead of never.
+    class MemoryBudget {
+    public:
+        explicit MemoryBudget(size_t total) : total_(std::max<size_t>(total, 1)), available_(total_) {}
+
+        size_t acquire(size_t bytes) {
+            bytes = std::min(bytes, total_);
+            std::unique_lock<std::mutex> lock(mutex_);
+            released_.wait(lock, [&] { return available_ >= bytes; });
+            available_ -= bytes;
+            return bytes;
+        }
+
+        void release(size_t bytes) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                available_ += bytes;
+            }
+            released_.notify_all();
+        }
+
+    private:
+        size_t total_;
+        size_t available_;
+        std::mutex mutex_;
+        std::condition_variable released_;
+    };
+
+    // Arenas of finished jobs, handed to the next ones so their scratch is already
+    // allocated. Held memory is outside the budget, so an arena larger than one
+    // job's share of it is trimmed before it is kept.
+    class ArenaPool {
+    public:
+        explicit ArenaPool(size_t keepBytes) : keepBytes_(keepBytes) {}
+
+        std::unique_ptr<ScratchArena> acquire() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (free_.empty()) {
+                return std::make_unique<ScratchArena>();
+            }
+            std::unique_ptr<ScratchArena> arena = std::move(free_.back());
+            free_.pop_back();
+            return arena;
+        }
+
+        void release(std::unique_ptr<ScratchArena> arena) {
+            if (arena->capacity() > keepBytes_) {
+                arena->release();
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_.push_back(std::move(arena));
+        }
+
+    private:
+        size_t keepBytes_;
+        std::mutex mutex_;
+        std::vector<std::unique_ptr<ScratchArena>> free_;
+    };
+
+    std::string jsonEscape(const std::string& text) {
+        std::ostringstream out;
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                out << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+            } else {
+                out << c;
+            }
+        }
+        return out.str();
+    }
+
+    std::string csvQuote(const std::string& text) {
+        std::string quoted = "\"";
+        for (char c : text) {
+            quoted += c == '"' ? std::string("\"\"") : std::string(1, c);
+        }
+        return quoted + "\"";
+    }
+
+    // The phases of one report folded into a row: allocations add up, peaks take the maximum
+    struct MemorySummary {
+        std::string scope;  // "file", "batch" (process-wide, shared by every row) or empty when not measured
+        // allocations, bytes allocated, peak heap bytes, peak RSS bytes
+        std::optional<uint64_t> values[4];
+    };
+
+    const char* const MEMORY_COLUMNS[] = {
+        "memory_scope", "allocations", "bytes_allocated", "peak_heap_bytes", "peak_rss_bytes",
+    };
+
+    MemorySummary summarizeMemory(const std::vector<PhaseMemory>& phases) {
+        MemorySummary summary;
+        auto add = [](std::optional<uint64_t>& total, uint64_t value) { total = total.value_or(0) + value; };
+        auto raise = [](std::optional<uint64_t>& peak, std::optional<size_t> value) {
+            if (value) {
+                peak = std::max<uint64_t>(peak.value_or(0), *value);
+            }
+        };
+        for (const auto& phase : phases) {
+            summary.scope = phase.phase == BATCH_MEMORY_PHASE ? "batch" : "file";
+            add(summary.values[0], phase.usage.allocations);
+            add(summary.values[1], phase.usage.bytesAllocated);
+            raise(summary.values[2], phase.usage.peakHeapBytes);
+            raise(summary.values[3], phase.usage.peakRssBytes);
+        }
+        return summary;
+    }
+
+    bool isJsonPath(const std::string& filename) {
+        return std::filesystem::path(filename).extension() == ".json";
+    }
+
+    // Sorted file of every input in directory, all empty when there is none. Inputs
+    // that share a file name get their batch position before the extension.
+    std::vector<std::string> sortedFilenames(const std::vector<std::string>& inputs,
+                                             const std::filesystem::path& directory) {
+        std::vector<std::string> sorted(inputs.size());
+        if (directory.empty()) {
+            return sorted;
+        }
+        std::map<std::filesystem::path, size_t> uses;
+        for (const auto& input : inputs) {
+            ++uses[std::filesystem::path(input).filename()];
+        }
+        std::set<std::string> taken;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            std::filesystem::path name = std::filesystem::path(inputs[i]).filename();
+            if (uses[name] > 1) {
+                name = name.stem().string() + "." + std::to_string(i) + name.extension().string();
+            }
+            sorted[i] = (directory / name).string();
+            if (!taken.insert(sorted[i]).second) {
+                throw std::invalid_argument("Two batch inputs would both be sorted into " + sorted[i]);
+            }
+        }
+        return sorted;
+    }
+}
+
+std::vector<std::string> listBatchInputs(const std::string& directoryOrManifest) {
+    std::filesystem::path path(directoryOrManifest);
+    std::vector<std::string> inputs;
+    if (std::filesystem::is_directory(path)) {
+        for (const auto& entry : std::filesystem::directory_iterator(path)) {
+            if (entry.is_regular_file()) {
+                inputs.push_back(entry.path().string());
+            }
+        }
+        std::sort(inputs.begin(), inputs.end());
+        return inputs;
+    }
+
+    std::ifstream manifest(path);
+    if (!manifest.is_open()) {
+        throw std::runtime_error("Could not open batch directory or manifest " + directoryOrManifest);
+    }
+    std::string line;
+    while (std::getline(manifest, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        std::filesystem::path input(line);
+        inputs.push_back(input.is_absolute() ? input.string() : (path.parent_path() / input).string());
+    }
+    return inputs;
+}
+
+template <typename T>
+size_t estimateSortMemory(const std::string& filename) {
+    std::error_code error;
+    size_t bytes = static_cast<size_t>(std::filesystem::file_size(filename, error));
+    if (error) {
+        return 0;
+    }
+    size_t values = isBinaryDatasetPath(filename) ? bytes / sizeof(T) : bytes / 2;
+    return 2 * values * sizeof(T);
+}
+
+template <typename T>
+std::vector<SortReport> runBatch(const std::vector<std::string>& inputs, const BatchOptions& options) {
+    // Fail on bad strategy options and clashing outputs before any job is queued
+    makeSortStrategy<T>(options.sort);
+    std::vector<std::string> sortedFiles = sortedFilenames(inputs, options.sortedDirectory);
+
+    std::vector<SortReport> reports(inputs.size());
+    MemoryBudget budget(options.memoryBudgetBytes);
+    unsigned int jobs = std::max(1u, options.jobs);
+    ArenaPool arenas(options.memoryBudgetBytes / jobs);
+    WorkStealingPool pool(jobs);
+    // Concurrent jobs would reset each other's high-water marks and count each
+    // other's allocations, so with more than one job the batch is probed as a whole
+    bool probeBatch = jobs > 1 && inputs.size() > 1;
+    MemoryProbe batchMemory;
+    if (probeBatch) {
+        batchMemory.start();
+    }
+    {
+        // The dispatching thread blocks on the budget, so the pool holds all jobs threads
+        TaskGroup group(pool);
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            size_t reserved = budget.acquire(estimateSortMemory<T>(inputs[i]));
+            group.run([&, i, reserved] {
+                std::unique_ptr<ScratchArena> arena = arenas.acquire();
+                try {
+                    SortExecutor<T> executor(makeSortStrategy<T>(options.sort));
+                    executor.useScratch(*arena);
+                    executor.measureMemory(!probeBatch);
+                    reports[i] = executor.run(inputs[i], sortedFiles[i]);
+                } catch (const std::exception& e) {
+                    reports[i].inputFilename = inputs[i];
+                    reports[i].error = e.what();
+                }
+                arenas.release(std::move(arena));
+                budget.release(reserved);
+            });
+        }
+        group.wait();
+    }
+    if (probeBatch) {
+        MemoryUsage usage = batchMemory.stop();
+        for (SortReport& report : reports) {
+            if (report.error.empty()) {
+                report.memory.push_back({BATCH_MEMORY_PHASE, usage});
+            }
+        }
+    }
+    return reports;
+}
+
+void writeBatchReport(const std::string& filename, const std::vector<SortReport>& reports) {
+    std::ofstream out(filename, std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Could not open report file " + filename);
+    }
+    out << std::setprecision(9);
+
+    if (isJsonPath(filename)) {
+        out << "[\n";
+        for (size_t i = 0; i < reports.size(); ++i) {
+            const SortReport& r = reports[i];
+            out << "  {\"file\": \"" << jsonEscape(r.inputFilename) << "\", \"sorted\": \""
+                << jsonEscape(r.sortedFilename) << "\", \"algorithm\": \"" << jsonEscape(r.algorithm)
+                << "\", \"size\": " << r.size << ", \"parse_s\": " << r.timings.parse
+                << ", \"sort_s\": " << r.timings.sort << ", \"write_s\": " << r.timings.write
+                << ", \"total_s\": " << r.timings.total;
+            for (size_t event = 0; event < PERF_EVENT_COUNT; ++event) {
+                out << ", \"" << perfEventName(static_cast<PerfEvent>(event)) << "\": ";
+                if (r.counters.values[event]) {
+                    out << *r.counters.values[event];
+                } else {
+                    out << "null";
+                }
+            }
+            MemorySummary memory = summarizeMemory(r.memory);
+            out << ", \"" << MEMORY_COLUMNS[0] << "\": ";
+            if (memory.scope.empty()) {
+                out << "null";
+            } else {
+                out << "\"" << memory.scope << "\"";
+            }
+            for (size_t column = 0; column < 4; ++column) {
+                out << ", \"" << MEMORY_COLUMNS[column + 1] << "\": ";
+                if (memory.values[column]) {
+                    out << *memory.values[column];
+                } else {
+                    out << "null";
+                }
+            }
+            out << ", \"error\": ";
+            if (r.error.empty()) {
+                out << "null";
+            } else {
+                out << "\"" << jsonEscape(r.error) << "\"";
+            }
+            out << "}" << (i + 1 < reports.size() ? "," : "") << "\n";
+        }
+        out << "]\n";
+    } else {
+        out << "file,sorted,algorithm,size,parse_s,sort_s,write_s,total_s";
+        for (size_t event = 0; event < PERF_EVENT_COUNT; ++event) {
+            out << "," << perfEventName(static_cast<PerfEvent>(event));
+        }
+        for (const char* column : MEMORY_COLUMNS) {
+            out << "," << column;
+        }
+        out << ",error\n";
+        for (const SortReport& r : reports) {
+            out << csvQuote(r.inputFilename) << "," << csvQuote(r.sortedFilename) << "," << csvQuote(r.algorithm)
+                << "," << r.size << "," << r.timings.parse << "," << r.timings.sort << "," << r.timings.write
+                << "," << r.timings.total;
+            for (const auto& value : r.counters.values) {
+                out << ",";
+                if (value) {
+                    out << *value;
+                }
+            }
+            MemorySummary memory = summarizeMemory(r.memory);
+            out << "," << memory.scope;
+            for (const auto& value : memory.values) {
+                out << ",";
+                if (value) {
+                    out << *value;
+                }
+            }
+            out << "," << csvQuote(r.error) << "\n";
+        }
+    }
+
+    out.close();
+    if (out.fail()) {
+        throw std::runtime_error("Failed to write report file " + filename);
+    }
+}
+
+#define INSTANTIATE_BATCH_KEY(K) \
+    template size_t estimateSortMemory<K>(const std::string& filename); \
+    template std::vector<SortReport> runBatch<K>(const std::vector<std::string>& inputs, const BatchOptions& options);
+SORT_KEY_TYPES(INSTANTIATE_BATCH_KEY)
@@ -0,0 +1,58 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#ifndef ALGORITHMS_PROGRAMMING_EXERCISES_BATCH_SORT_H
+#define ALGORITHMS_PROGRAMMING_EXERCISES_BATCH_SORT_H
+
+#include "sort_algorithms.h"
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Configuration of a batch run
+struct BatchOptions {
+    // Strategy of every job; its threads setting applies inside each job
+    SortOptions sort;
+    unsigned int jobs = std::thread::hardware_concurrency();
+    // Estimated memory of all running jobs; a job larger than the budget runs alone
+    size_t memoryBudgetBytes = size_t(1) << 30;
+    // Where the sorted files go, under their input file names; empty sorts without writing them.
+    // Inputs sharing a file name get their batch position before the extension (data.2.txt).
+    std::filesystem::path sortedDirectory;
+};
+
+// Inputs of a batch: the regular files of a directory ordered by name, or the
+// lines of a manifest file (relative paths resolve against the manifest's
+// directory; blank lines and lines starting with # are skipped).
+// Throws std::runtime_error if the path cannot be read.
+std::vector<std::string> listBatchInputs(const std::string& directoryOrManifest);
+
+// Upper estimate of the memory sorting the file takes: the values plus the
+// strategy's scratch space. Text inputs need at least two bytes per value.
+template <typename T>
+size_t estimateSortMemory(const std::string& filename);
+
+// Phase name of the memory a concurrent batch measured as a whole
+inline constexpr const char* BATCH_MEMORY_PHASE = "batch (process-wide)";
+
+// Runs one SortExecutor job per input on a fixed pool of options.jobs threads.
+// A job is only started once its memory estimate fits the remaining budget.
+// Reports come back in input order; a failed job carries its error. With one
+// job at a time every report has its own memory phases; otherwise memory is
+// probed around the whole batch and every successful report carries that
+// process-wide usage as a single BATCH_MEMORY_PHASE phase.
+// Throws std::invalid_argument if the strategy options are invalid or two inputs
+// would still be sorted into the same file.
+template <typename T>
+std::vector<SortReport> runBatch(const std::vector<std::string>& inputs, const BatchOptions& options);
+
+// Writes all reports in one go: JSON for a .json filename, CSV otherwise. Memory
+// is folded into one set of columns per report, with memory_scope telling
+// per-file figures ("file") from the shared batch-wide ones ("batch").
+// Throws std::runtime_error if the file cannot be written.
+void writeBatchReport(const std::string& filename, const std::vector<SortReport>& reports);
+
+#endif //ALGORITHMS_PROGRAMMING_EXERCISES_BATCH_SORT_H
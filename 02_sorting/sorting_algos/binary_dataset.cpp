@@ -0,0 +1,242 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "binary_dataset.h"
+#include "data_reader.h"
+#include "record.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    template <typename U>
+    U toLittleEndian(U value) {
+        if constexpr (std::endian::native == std::endian::big && std::is_integral_v<U>) {
+            return std::byteswap(value);
+        } else if constexpr (std::endian::native == std::endian::big) {
+            using Bits = std::conditional_t<sizeof(U) == 4, uint32_t, uint64_t>;
+            return std::bit_cast<U>(std::byteswap(std::bit_cast<Bits>(value)));
+        } else {
+            return value;
+        }
+    }
+
+    template <typename U>
+    void storeField(unsigned char* header, size_t offset, U value) {
+        value = toLittleEndian(value);
+        std::memcpy(header + offset, &value, sizeof(U));
+    }
+
+    template <typename U>
+    U loadField(const char* header, size_t offset) {
+        U value;
+        std::memcpy(&value, header + offset, sizeof(U));
+        return toLittleEndian(value);
+    }
+
+    template <typename T>
+    void writeHeader(std::ofstream& out, uint64_t count, uint64_t checksum) {
+        unsigned char header[BinaryDataset::HEADER_SIZE] = {};
+        std::memcpy(header, BinaryDataset::MAGIC, sizeof(BinaryDataset::MAGIC));
+        storeField<uint32_t>(header, 8, static_cast<uint32_t>(datasetElementType<T>()));
+        storeField<uint32_t>(header, 12, sizeof(T));
+        storeField<uint64_t>(header, 16, count);
+        storeField<uint64_t>(header, 24, checksum);
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    }
+
+    constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+    constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+
+    struct DatasetHeader {
+        uint64_t count;
+        uint64_t checksum;
+    };
+
+    // Checks magic and element type; the caller validates the payload size
+    template <typename T>
+    DatasetHeader parseHeader(const char* header, size_t available, const std::string& filename) {
+        if (available < BinaryDataset::HEADER_SIZE
+            || std::memcmp(header, BinaryDataset::MAGIC, sizeof(BinaryDataset::MAGIC)) != 0) {
+            throw std::runtime_error(filename + " is not a binary dataset");
+        }
+        auto type = static_cast<DatasetElementType>(loadField<uint32_t>(header, 8));
+        uint32_t elementSize = loadField<uint32_t>(header, 12);
+        if (type != datasetElementType<T>() || elementSize != sizeof(T)) {
+            throw std::runtime_error(filename + " holds a different element type");
+        }
+        return {loadField<uint64_t>(header, 16), loadField<uint64_t>(header, 24)};
+    }
+
+    template <typename T>
+    void fromLittleEndian(T* values, size_t count) {
+        if constexpr (std::endian::native == std::endian::big) {
+            for (size_t i = 0; i < count; ++i) {
+                values[i] = toLittleEndian(values[i]);
+            }
+        }
+    }
+}
+
+bool isBinaryDatasetPath(const std::string& filename) {
+    const std::string extension = BinaryDataset::EXTENSION;
+    return filename.size() >= extension.size()
+        && filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+uint64_t datasetChecksum(const void* data, size_t size, uint64_t seed) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = seed;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, 8);
+        hash = (hash ^ toLittleEndian(word)) * FNV_PRIME;
+    }
+    if (i < size) {
+        uint64_t word = 0;
+        for (size_t shift = 0; i < size; ++i, shift += 8) {
+            word |= static_cast<uint64_t>(bytes[i]) << shift;
+        }
+        hash = (hash ^ word) * FNV_PRIME;
+    }
+    return hash;
+}
+
+template <typename T>
+BinaryDatasetWriter<T>::BinaryDatasetWriter(const std::string& filename)
+    : out_(filename, std::ios::binary | std::ios::trunc), checksum_(FNV_OFFSET) {
+    if (!out_.is_open()) {
+        throw std::runtime_error("Could not open file " + filename);
+    }
+    // Placeholder, rewritten by close()
+    writeHeader<T>(out_, 0, 0);
+    buffer_.reserve(BUFFER_ELEMENTS);
+}
+
+template <typename T>
+BinaryDatasetWriter<T>::~BinaryDatasetWriter() {
+    try {
+        close();
+    } catch (...) {
+        // Destructors must not throw; call close() explicitly to see errors
+    }
+}
+
+template <typename T>
+void BinaryDatasetWriter<T>::write(T value) {
+    buffer_.push_back(toLittleEndian(value));
+    if (buffer_.size() == BUFFER_ELEMENTS) {
+        flush();
+    }
+}
+
+template <typename T>
+void BinaryDatasetWriter<T>::flush() {
+    if (buffer_.empty()) {
+        return;
+    }
+    size_t bytes = buffer_.size() * sizeof(T);
+    checksum_ = datasetChecksum(buffer_.data(), bytes, checksum_);
+    out_.write(reinterpret_cast<const char*>(buffer_.data()), static_cast<std::streamsize>(bytes));
+    count_ += buffer_.size();
+    buffer_.clear();
+}
+
+template <typename T>
+void BinaryDatasetWriter<T>::close() {
+    if (!out_.is_open()) {
+        return;
+    }
+    flush();
+    out_.seekp(0);
+    writeHeader<T>(out_, count_, checksum_);
+    out_.close();
+    if (out_.fail()) {
+        throw std::runtime_error("Failed to write binary dataset");
+    }
+}
+
+template <typename T>
+void writeBinaryDataset(const std::string& filename, const std::vector<T>& values) {
+    BinaryDatasetWriter<T> writer(filename);
+    for (const T& value : values) {
+        writer.write(value);
+    }
+    writer.close();
+}
+
+template <typename T>
+std::vector<T> readBinaryDataset(const std::string& filename) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        throw std::runtime_error("Could not open file " + filename);
+    }
+    std::string_view contents = file.contents();
+    DatasetHeader header = parseHeader<T>(contents.data(), contents.size(), filename);
+
+    const char* payload = contents.data() + BinaryDataset::HEADER_SIZE;
+    size_t payloadSize = contents.size() - BinaryDataset::HEADER_SIZE;
+    if (header.count > payloadSize / sizeof(T) || header.count * sizeof(T) != payloadSize) {
+        throw std::runtime_error(filename + " is truncated or has trailing bytes");
+    }
+    if (datasetChecksum(payload, payloadSize) != header.checksum) {
+        throw std::runtime_error(filename + " failed the checksum");
+    }
+
+    std::vector<T> values(header.count);
+    std::memcpy(values.data(), payload, payloadSize);
+    fromLittleEndian(values.data(), values.size());
+    return values;
+}
+
+template <typename T>
+BinaryDatasetStream<T>::BinaryDatasetStream(const std::string& filename)
+    : in_(filename, std::ios::binary), checksum_(FNV_OFFSET) {
+    if (!in_.is_open()) {
+        throw std::runtime_error("Could not open file " + filename);
+    }
+    char header[BinaryDataset::HEADER_SIZE];
+    in_.read(header, sizeof(header));
+    DatasetHeader parsed = parseHeader<T>(header, static_cast<size_t>(in_.gcount()), filename);
+    count_ = remaining_ = parsed.count;
+    expectedChecksum_ = parsed.checksum;
+}
+
+template <typename T>
+size_t BinaryDatasetStream<T>::read(std::vector<T>& out, size_t maxCount) {
+    // The incremental checksum needs every piece but the last to be whole 64-bit words
+    constexpr size_t perWord = 8 / sizeof(T);
+    size_t wanted = static_cast<size_t>(std::min<uint64_t>(std::max(maxCount, perWord), remaining_));
+    if (wanted < remaining_) {
+        wanted -= wanted % perWord;
+    }
+    if (wanted == 0) {
+        return 0;
+    }
+
+    size_t base = out.size();
+    out.resize(base + wanted);
+    in_.read(reinterpret_cast<char*>(out.data() + base), static_cast<std::streamsize>(wanted * sizeof(T)));
+    if (static_cast<size_t>(in_.gcount()) != wanted * sizeof(T)) {
+        out.resize(base);
+        throw std::runtime_error("Binary dataset is truncated");
+    }
+    checksum_ = datasetChecksum(out.data() + base, wanted * sizeof(T), checksum_);
+    fromLittleEndian(out.data() + base, wanted);
+
+    remaining_ -= wanted;
+    if (remaining_ == 0 && checksum_ != expectedChecksum_) {
+        throw std::runtime_error("Binary dataset failed the checksum");
+    }
+    return wanted;
+}
+
+#define INSTANTIATE_BINARY_DATASET_KEY(K) \
+    template class BinaryDatasetWriter<K>; \
+    template void writeBinaryDataset<K>(const std::string& filename, const std::vector<K>& values); \
+    template std::vector<K> readBinaryDataset<K>(const std::string& filename); \
+    template class BinaryDatasetStream<K>;
+SORT_KEY_TYPES(INSTANTIATE_BINARY_DATASET_KEY)
@@ -0,0 +1,118 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#ifndef ALGORITHMS_PROGRAMMING_EXERCISES_BINARY_DATASET_H
+#define ALGORITHMS_PROGRAMMING_EXERCISES_BINARY_DATASET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Binary dataset container: a fixed 32-byte header followed by the raw
+// little-endian array. All header fields are little-endian as well.
+//
+//   offset  size  field
+//   0       8     magic "SORTDAT1"
+//   8       4     element type (DatasetElementType)
+//   12      4     element size in bytes
+//   16      8     element count
+//   24      8     checksum of the payload bytes (datasetChecksum)
+namespace BinaryDataset {
+    constexpr char MAGIC[8] = {'S', 'O', 'R', 'T', 'D', 'A', 'T', '1'};
+    constexpr size_t HEADER_SIZE = 32;
+    constexpr const char* EXTENSION = ".bin";
+}
+
+enum class DatasetElementType : uint32_t {
+    Int32 = 1,
+    UInt32 = 2,
+    Int64 = 3,
+    UInt64 = 4,
+    Float32 = 5,
+    Float64 = 6,
+};
+
+template <typename T>
+constexpr DatasetElementType datasetElementType() {
+    if constexpr (std::is_floating_point_v<T>) {
+        static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Unsupported floating-point width");
+        return sizeof(T) == 4 ? DatasetElementType::Float32 : DatasetElementType::Float64;
+    } else {
+        static_assert(std::is_integral_v<T> && (sizeof(T) == 4 || sizeof(T) == 8), "Unsupported key type");
+        if constexpr (sizeof(T) == 4) {
+            return std::is_signed_v<T> ? DatasetElementType::Int32 : DatasetElementType::UInt32;
+        } else {
+            return std::is_signed_v<T> ? DatasetElementType::Int64 : DatasetElementType::UInt64;
+        }
+    }
+}
+
+// True when the filename selects the binary format (by its extension)
+bool isBinaryDatasetPath(const std::string& filename);
+
+// FNV-1a style hash over 64-bit little-endian words (the tail is zero-padded),
+// cheap enough to stay below memory bandwidth. Can be computed incrementally
+// by feeding the previous result back as seed, as long as every chunk except
+// the last one is a multiple of 8 bytes long.
+uint64_t datasetChecksum(const void* data, size_t size, uint64_t seed = 0xcbf29ce484222325ULL);
+
+// Streams values into a binary dataset; the header is finalised by close()
+// (or the destructor) once the count and checksum are known.
+// Throws std::runtime_error if the file cannot be written.
+template <typename T>
+class BinaryDatasetWriter {
+public:
+    static constexpr size_t BUFFER_ELEMENTS = 1 << 16;
+
+    explicit BinaryDatasetWriter(const std::string& filename);
+    ~BinaryDatasetWriter();
+
+    void write(T value);
+    void close();
+
+private:
+    void flush();
+
+    std::ofstream out_;
+    std::vector<T> buffer_;
+    uint64_t count_ = 0;
+    uint64_t checksum_;
+};
+
+// Writes a complete binary dataset in one go
+template <typename T>
+void writeBinaryDataset(const std::string& filename, const std::vector<T>& values);
+
+// Loads a binary dataset with one mapping and one copy into the result.
+// Throws std::runtime_error on a bad magic, element type, size or checksum.
+template <typename T>
+std::vector<T> readBinaryDataset(const std::string& filename);
+
+// Reads a binary dataset in bounded pieces without mapping it as a whole.
+// The checksum is accumulated on the way and verified once the last element
+// was read. Throws std::runtime_error on a bad header or checksum.
+template <typename T>
+class BinaryDatasetStream {
+public:
+    explicit BinaryDatasetStream(const std::string& filename);
+
+    uint64_t count() const { return count_; }
+
+    // Appends up to maxCount values to out and returns how many were appended.
+    // Except for the final piece, counts are rounded down to whole 64-bit words
+    // (a maxCount below one word is raised to one word).
+    size_t read(std::vector<T>& out, size_t maxCount);
+
+private:
+    std::ifstream in_;
+    uint64_t count_ = 0;
+    uint64_t remaining_ = 0;
+    uint64_t expectedChecksum_ = 0;
+    uint64_t checksum_;
+};
+
+#endif //ALGORITHMS_PROGRAMMING_EXERCISES_BINARY_DATASET_H
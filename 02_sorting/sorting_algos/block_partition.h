@@ -0,0 +1,203 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#ifndef ALGORITHMS_PROGRAMMING_EXERCISES_BLOCK_PARTITION_H
+#define ALGORITHMS_PROGRAMMING_EXERCISES_BLOCK_PARTITION_H
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+// Pivot selection and partition kernels shared by PdqSort and Selection
+namespace BlockPartition {
+    // Ranges above this size pick their pivot with Tukey's ninther
+    constexpr size_t NINTHER_THRESHOLD = 128;
+    // Elements classified per block by the branchless partition (offsets fit in a byte)
+    constexpr size_t BLOCK_SIZE = 64;
+
+    template <typename T>
+    void sort2(T* a, T* b) {
+        if (*b < *a) {
+            std::iter_swap(a, b);
+        }
+    }
+
+    template <typename T>
+    void sort3(T* a, T* b, T* c) {
+        sort2(a, b);
+        sort2(b, c);
+        sort2(a, b);
+    }
+
+    // Swaps the misplaced elements recorded in the offset blocks.
+    // With unequal counts a cyclic permutation is cheaper than pairwise swaps.
+    template <typename T>
+    void swapOffsets(T* first, T* last, const unsigned char* offsetsLeft, const unsigned char* offsetsRight,
+                     size_t count, bool useSwaps) {
+        if (useSwaps) {
+            for (size_t i = 0; i < count; ++i) {
+                std::iter_swap(first + offsetsLeft[i], last - offsetsRight[i]);
+            }
+        } else if (count > 0) {
+            T* l = first + offsetsLeft[0];
+            T* r = last - offsetsRight[0];
+            T tmp(std::move(*l));
+            *l = std::move(*r);
+            for (size_t i = 1; i < count; ++i) {
+                l = first + offsetsLeft[i];
+                *r = std::move(*l);
+                r = last - offsetsRight[i];
+                *l = std::move(*r);
+            }
+            *r = std::move(tmp);
+        }
+    }
+
+    // Partitions [begin, end) around the pivot at *begin into < pivot and >= pivot.
+    // The comparisons only produce offsets (no branches on their outcome); the
+    // misplaced elements are swapped afterwards in batches.
+    // Returns the pivot's final position and whether the range was already partitioned.
+    template <typename T>
+    std::pair<T*, bool> partitionRight(T* begin, T* end) {
+        T pivot(std::move(*begin));
+        T* first = begin;
+        T* last = end;
+
+        // The median-of-3 guarantees an element >= pivot exists
+        while (*++first < pivot) {
+        }
+
+        // Guard the search only if nothing smaller than the pivot precedes first
+        if (first - 1 == begin) {
+            while (first < last && !(*--last < pivot)) {
+            }
+        } else {
+            while (!(*--last < pivot)) {
+            }
+        }
+
+        bool alreadyPartitioned = first >= last;
+        if (!alreadyPartitioned) {
+            std::iter_swap(first, last);
+            ++first;
+
+            alignas(64) unsigned char offsetsLeft[BLOCK_SIZE];
+            alignas(64) unsigned char offsetsRight[BLOCK_SIZE];
+            T* offsetsLeftBase = first;
+            T* offsetsRightBase = last;
+            size_t numLeft = 0, numRight = 0, startLeft = 0, startRight = 0;
+
+            while (first < last) {
+                // Decide how many unclassified elements each side examines in this round
+                size_t numUnknown = last - first;
+                size_t leftSplit = numLeft == 0 ? (numRight == 0 ? numUnknown / 2 : numUnknown) : 0;
+                size_t rightSplit = numRight == 0 ? (numUnknown - leftSplit) : 0;
+
+                size_t leftCount = std::min(leftSplit, BLOCK_SIZE);
+                for (size_t i = 0; i < leftCount; ++i) {
+                    offsetsLeft[numLeft] = static_cast<unsigned char>(i);
+                    numLeft += !(*first < pivot);
+                    ++first;
+                }
+
+                size_t rightCount = std::min(rightSplit, BLOCK_SIZE);
+                for (size_t i = 0; i < rightCount;) {
+                    offsetsRight[numRight] = static_cast<unsigned char>(++i);
+                    numRight += *--last < pivot;
+                }
+
+                size_t count = std::min(numLeft, numRight);
+                swapOffsets(offsetsLeftBase, offsetsRightBase, offsetsLeft + startLeft, offsetsRight + startRight,
+                            count, numLeft == numRight);
+                numLeft -= count;
+                numRight -= count;
+                startLeft += count;
+                startRight += count;
+
+                if (numLeft == 0) {
+                    startLeft = 0;
+                    offsetsLeftBase = first;
+                }
+                if (numRight == 0) {
+                    startRight = 0;
+                    offsetsRightBase = last;
+                }
+            }
+
+            // One side still holds misplaced elements; move them across the boundary
+            if (numLeft) {
+                const unsigned char* offsets = offsetsLeft + startLeft;
+                while (numLeft--) {
+                    std::iter_swap(offsetsLeftBase + offsets[numLeft], --last);
+                }
+                first = last;
+            }
+            if (numRight) {
+                const unsigned char* offsets = offsetsRight + startRight;
+                while (numRight--) {
+                    std::iter_swap(offsetsRightBase - offsets[numRight], first);
+                    ++first;
+                }
+                last = first;
+            }
+        }
+
+        T* pivotPos = first - 1;
+        *begin = std::move(*pivotPos);
+        *pivotPos = std::move(pivot);
+        return {pivotPos, alreadyPartitioned};
+    }
+
+    // Partitions into <= pivot and > pivot. Used when the pivot equals the element
+    // preceding the range, i.e. the range is full of keys equal to the pivot.
+    template <typename T>
+    T* partitionLeft(T* begin, T* end) {
+        T pivot(std::move(*begin));
+        T* first = begin;
+        T* last = end;
+
+        while (pivot < *--last) {
+        }
+
+        if (last + 1 == end) {
+            while (first < last && !(pivot < *++first)) {
+            }
+        } else {
+            while (!(pivot < *++first)) {
+            }
+        }
+
+        while (first < last) {
+            std::iter_swap(first, last);
+            while (pivot < *--last) {
+            }
+            while (!(pivot < *++first)) {
+            }
+        }
+
+        T* pivotPos = last;
+        *begin = std::move(*pivotPos);
+        *pivotPos = std::move(pivot);
+        return pivotPos;
+    }
+
+    // Moves the median-of-3 (ninther above NINTHER_THRESHOLD) of [begin, end) to *begin.
+    // Needs at least 8 elements.
+    template <typename T>
+    void choosePivot(T* begin, T* end) {
+        size_t size = end - begin;
+        size_t half = size / 2;
+        if (size > NINTHER_THRESHOLD) {
+            sort3(begin, begin + half, end - 1);
+            sort3(begin + 1, begin + (half - 1), end - 2);
+            sort3(begin + 2, begin + (half + 1), end - 3);
+            sort3(begin + (half - 1), begin + half, begin + (half + 1));
+            std::iter_swap(begin, begin + half);
+        } else {
+            sort3(begin + half, begin, end - 1);
+        }
+    }
+}
+
+#endif //ALGORITHMS_PROGRAMMING_EXERCISES_BLOCK_PARTITION_H
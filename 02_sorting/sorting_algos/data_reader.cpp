@@ -0,0 +1,245 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "data_reader.h"
+#include "binary_dataset.h"
+#include "record.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SORTING_HAS_MMAP 1
+#endif
+
+MappedFile::MappedFile(const std::string& filename) {
+#ifdef SORTING_HAS_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return;
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    open_ = true;
+    if (size_ > 0) {
+        void* address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            ::madvise(address, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(address);
+            mapped_ = true;
+        }
+    }
+    ::close(fd);
+    if (mapped_ || size_ == 0) {
+        return;
+    }
+    open_ = false;
+#endif
+
+    // Fallback: one bulk read into an owned buffer
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return;
+    }
+    buffer_.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    open_ = true;
+}
+
+MappedFile::~MappedFile() {
+#ifdef SORTING_HAS_MMAP
+    if (mapped_) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+}
+
+namespace {
+    enum class LineResult { Blank, Value, Invalid };
+
+    // The whitespace std::stoi skipped, plus the '\r' of CRLF line ends
+    bool isAsciiSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    // Parses one line (without its '\n') into value; whitespace around the number is ignored
+    template <typename T>
+    LineResult parseLine(const char* lineStart, const char* lineEnd, T& value) {
+        while (lineStart < lineEnd && isAsciiSpace(*lineStart)) {
+            ++lineStart;
+        }
+        while (lineEnd > lineStart && isAsciiSpace(*(lineEnd - 1))) {
+            --lineEnd;
+        }
+        if (lineEnd == lineStart) {
+            return LineResult::Blank;
+        }
+        // from_chars rejects a leading '+', accept it like std::stoi did (but only one sign)
+        if (*lineStart == '+') {
+            ++lineStart;
+            if (lineStart == lineEnd || *lineStart == '+' || *lineStart == '-') {
+                return LineResult::Invalid;
+            }
+        }
+        auto [ptr, ec] = std::from_chars(lineStart, lineEnd, value);
+        return (ec == std::errc() && ptr == lineEnd) ? LineResult::Value : LineResult::Invalid;
+    }
+
+    std::string lineText(const char* lineStart, const char* lineEnd) {
+        if (lineEnd > lineStart && *(lineEnd - 1) == '\r') {
+            --lineEnd;
+        }
+        return std::string(lineStart, lineEnd);
+    }
+}
+
+template <typename T>
+void parseNumbers(std::string_view text, std::vector<T>& out, std::vector<ParseError>& errors) {
+    // Every value ends at a newline (or at the end of the file), which bounds the count
+    size_t capacity = std::count(text.begin(), text.end(), '\n') + 1;
+    size_t base = out.size();
+    out.resize(base + capacity);
+    T* write = out.data() + base;
+
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+    const char* lineStart = begin;
+    size_t lineNumber = 1;
+
+    while (lineStart < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(lineStart, '\n', end - lineStart));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+
+        LineResult result = parseLine(lineStart, lineEnd, *write);
+        if (result == LineResult::Value) {
+            ++write;
+        } else if (result == LineResult::Invalid) {
+            errors.push_back({lineNumber, static_cast<size_t>(lineStart - begin), lineText(lineStart, lineEnd)});
+        }
+
+        lineStart = lineEnd + 1;
+        ++lineNumber;
+    }
+
+    out.resize(write - out.data());
+}
+
+void reportParseErrors(const std::string& filename, const std::vector<ParseError>& errors, size_t limit,
+                       size_t invalidLines) {
+    size_t printed = std::min(errors.size(), limit);
+    for (size_t i = 0; i < printed; ++i) {
+        std::cerr << "Invalid number in " << filename << " at line " << errors[i].line
+                  << " (offset " << errors[i].offset << "): \"" << errors[i].text << "\"" << std::endl;
+    }
+    if (invalidLines > printed) {
+        std::cerr << "... " << invalidLines - printed << " more invalid lines" << std::endl;
+    }
+}
+
+template <typename T>
+TextNumberStream<T>::TextNumberStream(const std::string& filename)
+    : in_(filename, std::ios::binary), buffer_(BLOCK_SIZE) {}
+
+template <typename T>
+bool TextNumberStream<T>::refill() {
+    // Keep the unfinished line, grow only if a single line fills the whole buffer
+    size_t remaining = end_ - begin_;
+    std::memmove(buffer_.data(), buffer_.data() + begin_, remaining);
+    fileOffset_ += begin_;
+    begin_ = 0;
+    end_ = remaining;
+    if (end_ == buffer_.size()) {
+        buffer_.resize(buffer_.size() * 2);
+    }
+
+    in_.read(buffer_.data() + end_, static_cast<std::streamsize>(buffer_.size() - end_));
+    size_t got = static_cast<size_t>(in_.gcount());
+    end_ += got;
+    if (got == 0) {
+        eof_ = true;
+    }
+    return got > 0;
+}
+
+template <typename T>
+size_t TextNumberStream<T>::read(std::vector<T>& out, size_t maxCount, std::vector<ParseError>& errors,
+                                 size_t maxErrors) {
+    size_t produced = 0;
+    T value{};
+    while (produced < maxCount) {
+        const char* lineStart = buffer_.data() + begin_;
+        const char* bufferEnd = buffer_.data() + end_;
+        const char* lineEnd = static_cast<const char*>(std::memchr(lineStart, '\n', bufferEnd - lineStart));
+        if (!lineEnd) {
+            if (!eof_ && refill()) {
+                continue;
+            }
+            if (begin_ == end_) {
+                break;
+            }
+            // Last line without a trailing newline
+            lineEnd = bufferEnd;
+        }
+
+        LineResult result = parseLine(lineStart, lineEnd, value);
+        if (result == LineResult::Value) {
+            out.push_back(value);
+            ++produced;
+        } else if (result == LineResult::Invalid) {
+            ++invalidLines_;
+            if (errors.size() < maxErrors) {
+                errors.push_back({lineNumber_, fileOffset_ + begin_, lineText(lineStart, lineEnd)});
+            }
+        }
+
+        begin_ = std::min(static_cast<size_t>(lineEnd - buffer_.data()) + 1, end_);
+        ++lineNumber_;
+    }
+    return produced;
+}
+
+template <typename T>
+ChunkSource<T>::ChunkSource(const std::string& filename, size_t maxReportedErrors)
+    : filename_(filename), maxReportedErrors_(maxReportedErrors) {
+    if (isBinaryDatasetPath(filename)) {
+        binary_ = std::make_unique<BinaryDatasetStream<T>>(filename);
+    } else {
+        text_ = std::make_unique<TextNumberStream<T>>(filename);
+        if (!text_->isOpen()) {
+            throw std::runtime_error("Could not open file " + filename);
+        }
+    }
+}
+
+template <typename T>
+ChunkSource<T>::~ChunkSource() {
+    reportParseErrors(filename_, errors_, maxReportedErrors_, text_ ? text_->invalidLines() : 0);
+}
+
+template <typename T>
+size_t ChunkSource<T>::read(std::vector<T>& out, size_t maxCount) {
+    return binary_ ? binary_->read(out, maxCount) : text_->read(out, maxCount, errors_, maxReportedErrors_);
+}
+
+#define INSTANTIATE_READERS_KEY(K) \
+    template void parseNumbers<K>(std::string_view text, std::vector<K>& out, std::vector<ParseError>& errors); \
+    template class TextNumberStream<K>; \
+    template class ChunkSource<K>;
+SORT_KEY_TYPES(INSTANTIATE_READERS_KEY)
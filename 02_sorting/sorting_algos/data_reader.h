@@ -0,0 +1,117 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#ifndef ALGORITHMS_PROGRAMMING_EXERCISES_DATA_READER_H
+#define ALGORITHMS_PROGRAMMING_EXERCISES_DATA_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Read-only view of a whole file. Uses mmap where available and falls back
+// to reading the file into an owned buffer otherwise.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return open_; }
+    std::string_view contents() const { return {data_, size_}; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool open_ = false;
+    bool mapped_ = false;
+    std::vector<char> buffer_;
+};
+
+// A line that could not be parsed as a number
+struct ParseError {
+    size_t line;    // 1-based line number
+    size_t offset;  // byte offset of the line start in the file
+    std::string text;
+};
+
+// Parses one number per line with std::from_chars, writing straight from the
+// mapped bytes into out. Floating-point keys accept the general format,
+// including inf and nan with an optional sign. The output is sized from the newline count up front,
+// so there is no reallocation. Spaces, tabs and '\r' around a number are ignored.
+// Blank lines are skipped; malformed lines are collected in errors and skipped.
+template <typename T>
+void parseNumbers(std::string_view text, std::vector<T>& out, std::vector<ParseError>& errors);
+
+// Prints the first limit errors to std::cerr and summarises the rest of the
+// invalidLines malformed lines; errors may hold only the first of them
+void reportParseErrors(const std::string& filename, const std::vector<ParseError>& errors, size_t limit,
+                       size_t invalidLines);
+
+// Incremental variant of parseNumbers for inputs that do not fit in memory:
+// reads the file in fixed-size blocks and hands out a bounded number of
+// values per call. Line numbers and offsets in errors refer to the whole file.
+template <typename T>
+class TextNumberStream {
+public:
+    static constexpr size_t BLOCK_SIZE = 1 << 20;
+
+    explicit TextNumberStream(const std::string& filename);
+
+    bool isOpen() const { return in_.is_open(); }
+
+    // Appends up to maxCount values to out. Returns how many were appended;
+    // fewer than maxCount means the end of the input was reached. Malformed
+    // lines go to errors while it holds fewer than maxErrors, and are counted either way.
+    size_t read(std::vector<T>& out, size_t maxCount, std::vector<ParseError>& errors,
+                size_t maxErrors = SIZE_MAX);
+
+    // Malformed lines seen so far
+    size_t invalidLines() const { return invalidLines_; }
+
+private:
+    bool refill();
+
+    std::ifstream in_;
+    std::vector<char> buffer_;
+    size_t begin_ = 0;       // first unparsed byte in buffer_
+    size_t end_ = 0;         // one past the last valid byte in buffer_
+    size_t fileOffset_ = 0;  // file offset of buffer_[0]
+    size_t lineNumber_ = 1;
+    size_t invalidLines_ = 0;
+    bool eof_ = false;
+};
+
+template <typename T>
+class BinaryDatasetStream;
+
+// Pulls bounded chunks of values from a text or binary input, picking the
+// reader by the filename extension. The first maxReportedErrors parse errors
+// of text inputs are kept, the rest only counted, and all are reported when
+// the source is destroyed.
+// Throws std::runtime_error if the file cannot be opened.
+template <typename T>
+class ChunkSource {
+public:
+    ChunkSource(const std::string& filename, size_t maxReportedErrors);
+    ~ChunkSource();
+
+    // Appends up to maxCount values to out and returns how many were appended (0 at the end)
+    size_t read(std::vector<T>& out, size_t maxCount);
+
+private:
+    std::string filename_;
+    size_t maxReportedErrors_;
+    std::unique_ptr<BinaryDatasetStream<T>> binary_;
+    std::unique_ptr<TextNumberStream<T>> text_;
+    std::vector<ParseError> errors_;  // the first maxReportedErrors_ only
+};
+
+#endif //ALGORITHMS_PROGRAMMING_EXERCISES_DATA_READER_H
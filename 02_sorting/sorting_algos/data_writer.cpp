@@ -0,0 +1,169 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "data_writer.h"
+#include "record.h"
+#include <cerrno>
+#include <charconv>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define SORTING_HAS_WRITEV 1
+#endif
+
+namespace {
+    // Room for the longest decimal representation of a value plus its newline
+    constexpr size_t MAX_LINE_LENGTH = 32;
+}
+
+template <typename T>
+NumberTextWriter<T>::NumberTextWriter(const std::string& filename) {
+#ifdef SORTING_HAS_WRITEV
+    fd_ = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool opened = fd_ >= 0;
+#else
+    out_.open(filename, std::ios::binary | std::ios::trunc);
+    bool opened = out_.is_open();
+#endif
+    if (!opened) {
+        throw std::runtime_error("Could not open file " + filename);
+    }
+    for (auto& buffer : buffers_) {
+        buffer.resize(BUFFER_SIZE);
+    }
+}
+
+template <typename T>
+NumberTextWriter<T>::~NumberTextWriter() {
+    try {
+        close();
+    } catch (...) {
+        // Destructors must not throw; call close() explicitly to see errors
+    }
+}
+
+template <typename T>
+void NumberTextWriter<T>::write(const T* values, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (BUFFER_SIZE - used_ < MAX_LINE_LENGTH) {
+            filled_[current_++] = used_;
+            used_ = 0;
+            if (current_ == BUFFER_COUNT) {
+                flush();
+            }
+        }
+        char* buffer = buffers_[current_].data();
+        auto [end, ec] = std::to_chars(buffer + used_, buffer + BUFFER_SIZE, values[i]);
+        *end++ = '\n';
+        used_ = end - buffer;
+    }
+}
+
+template <typename T>
+void NumberTextWriter<T>::flush() {
+    size_t count = current_;
+    if (current_ < BUFFER_COUNT) {
+        filled_[count++] = used_;
+    }
+#ifdef SORTING_HAS_WRITEV
+    iovec parts[BUFFER_COUNT];
+    for (size_t i = 0; i < count; ++i) {
+        parts[i] = {buffers_[i].data(), filled_[i]};
+    }
+    // writev may stop early; continue from the first byte it did not take
+    iovec* next = parts;
+    while (count > 0) {
+        ssize_t written = ::writev(fd_, next, static_cast<int>(count));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to write sorted output");
+        }
+        size_t remaining = static_cast<size_t>(written);
+        while (count > 0 && remaining >= next->iov_len) {
+            remaining -= next->iov_len;
+            ++next;
+            --count;
+        }
+        if (count > 0) {
+            next->iov_base = static_cast<char*>(next->iov_base) + remaining;
+            next->iov_len -= remaining;
+        }
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        out_.write(buffers_[i].data(), static_cast<std::streamsize>(filled_[i]));
+    }
+#endif
+    current_ = 0;
+    used_ = 0;
+}
+
+template <typename T>
+void NumberTextWriter<T>::close() {
+#ifdef SORTING_HAS_WRITEV
+    if (fd_ < 0) {
+        return;
+    }
+    try {
+        flush();
+    } catch (...) {
+        ::close(fd_);
+        fd_ = -1;
+        throw;
+    }
+    int result = ::close(fd_);
+    fd_ = -1;
+    if (result != 0) {
+        throw std::runtime_error("Failed to write sorted output");
+    }
+#else
+    if (!out_.is_open()) {
+        return;
+    }
+    flush();
+    out_.close();
+    if (out_.fail()) {
+        throw std::runtime_error("Failed to write sorted output");
+    }
+#endif
+}
+
+template <typename T>
+DatasetWriter<T>::DatasetWriter(const std::string& filename) {
+    if (isBinaryDatasetPath(filename)) {
+        binary_ = std::make_unique<BinaryDatasetWriter<T>>(filename);
+    } else {
+        text_ = std::make_unique<NumberTextWriter<T>>(filename);
+    }
+}
+
+template <typename T>
+void DatasetWriter<T>::write(const T* values, size_t count) {
+    if (binary_) {
+        for (size_t i = 0; i < count; ++i) {
+            binary_->write(values[i]);
+        }
+    } else {
+        text_->write(values, count);
+    }
+}
+
+template <typename T>
+void DatasetWriter<T>::close() {
+    if (binary_) {
+        binary_->close();
+    } else {
+        text_->close();
+    }
+}
+
+#define INSTANTIATE_WRITERS_KEY(K) \
+    template class NumberTextWriter<K>; \
+    template class DatasetWriter<K>;
+SORT_KEY_TYPES(INSTANTIATE_WRITERS_KEY)
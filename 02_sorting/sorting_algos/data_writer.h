@@ -0,0 +1,60 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#ifndef ALGORITHMS_PROGRAMMING_EXERCISES_DATA_WRITER_H
+#define ALGORITHMS_PROGRAMMING_EXERCISES_DATA_WRITER_H
+
+#include "binary_dataset.h"
+#include <array>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Writes one number per line, formatting with std::to_chars into a ring of
+// large reusable buffers. Once every buffer is full they are handed to the
+// kernel in a single writev call (a plain stream write where writev is missing).
+// Throws std::runtime_error if the file cannot be written.
+template <typename T>
+class NumberTextWriter {
+public:
+    static constexpr size_t BUFFER_SIZE = 1 << 20;
+    static constexpr size_t BUFFER_COUNT = 4;
+
+    explicit NumberTextWriter(const std::string& filename);
+    ~NumberTextWriter();
+
+    void write(const T* values, size_t count);
+    void close();
+
+private:
+    // Writes every filled buffer, including the partly filled current one
+    void flush();
+
+    int fd_ = -1;
+    std::ofstream out_;
+    std::array<std::vector<char>, BUFFER_COUNT> buffers_;
+    std::array<size_t, BUFFER_COUNT> filled_ {};
+    size_t current_ = 0;
+    size_t used_ = 0;
+};
+
+// Sorted-output sink that picks the binary container or the text format by
+// the filename extension, mirroring how the executors choose their reader.
+template <typename T>
+class DatasetWriter {
+public:
+    explicit DatasetWriter(const std::string& filename);
+
+    void write(const T* values, size_t count);
+    void write(const std::vector<T>& values) { write(values.data(), values.size()); }
+    void close();
+
+private:
+    std::unique_ptr<BinaryDatasetWriter<T>> binary_;
+    std::unique_ptr<NumberTextWriter<T>> text_;
+};
+
+#endif //ALGORITHMS_PROGRAMMING_EXERCISES_DATA_WRITER_H
@@ -0,0 +1,259 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "external_sort.h"
+#include "binary_dataset.h"
+#include "data_reader.h"
+#include "data_writer.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+namespace {
+    // Run files are raw native-endian arrays; they never leave this process
+    template <typename T>
+    class RunReader {
+    public:
+        RunReader(const std::filesystem::path& path, size_t bufferElements)
+            : in_(path, std::ios::binary), buffer_(bufferElements) {
+            if (!in_.is_open()) {
+                throw std::runtime_error("Could not open run file " + path.string());
+            }
+            refill();
+        }
+
+        bool exhausted() const { return position_ == size_; }
+        const T& head() const { return buffer_[position_]; }
+
+        void advance() {
+            if (++position_ == size_) {
+                refill();
+            }
+        }
+
+    private:
+        void refill() {
+            in_.read(reinterpret_cast<char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size() * sizeof(T)));
+            size_ = static_cast<size_t>(in_.gcount()) / sizeof(T);
+            position_ = 0;
+        }
+
+        std::ifstream in_;
+        std::vector<T> buffer_;
+        size_t position_ = 0;
+        size_t size_ = 0;
+    };
+
+    // Removes the spilled runs once the sort is done (or has failed)
+    struct TemporaryFiles {
+        std::vector<std::filesystem::path> paths;
+
+        ~TemporaryFiles() {
+            std::error_code ignored;
+            for (const auto& path : paths) {
+                std::filesystem::remove(path, ignored);
+            }
+        }
+    };
+
+    std::string uniqueRunPrefix() {
+        std::random_device device;
+        return "external_sort_" + std::to_string(device()) + "_";
+    }
+
+    // k-way merges the runs through a loser tree; every full block of bufferElements
+    // values (and the final partial one) is handed to write
+    template <typename T, typename Write>
+    void mergeRunFiles(const std::vector<std::filesystem::path>& runs, size_t bufferElements, Write write) {
+        std::vector<RunReader<T>> readers;
+        readers.reserve(runs.size());
+        for (const auto& path : runs) {
+            readers.emplace_back(path, bufferElements);
+        }
+
+        auto less = [&readers](size_t a, size_t b) {
+            if (a >= readers.size() || readers[a].exhausted()) {
+                return false;
+            }
+            if (b >= readers.size() || readers[b].exhausted()) {
+                return true;
+            }
+            return sortedOrderLess(readers[a].head(), readers[b].head());
+        };
+        LoserTree<decltype(less)> tree(std::max<size_t>(readers.size(), 1), less);
+
+        std::vector<T> output;
+        output.reserve(bufferElements);
+        while (!readers.empty()) {
+            size_t source = tree.winner();
+            RunReader<T>& reader = readers[source];
+            if (reader.exhausted()) {
+                break;
+            }
+            output.push_back(reader.head());
+            if (output.size() == bufferElements) {
+                write(output);
+                output.clear();
+            }
+            reader.advance();
+            tree.replay(source);
+        }
+        write(output);
+    }
+}
+
+template <typename T>
+ExternalSortExecutor<T>::ExternalSortExecutor(std::unique_ptr<SortStrategy<T>> strategy, size_t memoryBudgetBytes,
+                                              std::filesystem::path tempDirectory, size_t maxFanIn)
+    : strategy_(std::move(strategy)), memoryBudgetBytes_(memoryBudgetBytes), tempDirectory_(std::move(tempDirectory)) {
+    // Half of the budget holds the chunk, the other half is left for the strategy's scratch space
+    chunkElements_ = std::max(memoryBudgetBytes_ / (2 * sizeof(T)), MIN_BUFFER_ELEMENTS);
+    // One buffer per input run plus the output buffer
+    size_t buffers = memoryBudgetBytes_ / sizeof(T) / MIN_BUFFER_ELEMENTS;
+    fanIn_ = std::max<size_t>(std::min(buffers > 0 ? buffers - 1 : 0, maxFanIn), 2);
+}
+
+template <typename T>
+bool ExternalSortExecutor<T>::execute(const std::string& inputFilename, const std::string& sortedFilename,
+                                      const std::string& outputFilename) {
+    ExternalPhaseTimings timings;
+    TemporaryFiles runs;
+    size_t totalCount = 0;
+    size_t runCount = 0;
+    size_t mergePasses = 0;
+
+    try {
+        auto start = std::chrono::high_resolution_clock::now();
+        generateRuns(inputFilename, runs.paths, totalCount);
+        runCount = runs.paths.size();
+        auto merged = std::chrono::high_resolution_clock::now();
+        mergePasses = mergeRuns(runs.paths, sortedFilename);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        timings.runGeneration = std::chrono::duration<double>(merged - start).count();
+        timings.merge = std::chrono::duration<double>(end - merged).count();
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return false;
+    }
+
+    std::cout << "Runs: " << runCount << ", run generation: " << timings.runGeneration << "s, merge: "
+              << timings.merge << "s in " << mergePasses << " pass(es) of up to " << fanIn_ << " runs" << std::endl;
+    writeOutput(inputFilename, totalCount, runCount, mergePasses, timings, outputFilename);
+    return true;
+}
+
+template <typename T>
+void ExternalSortExecutor<T>::generateRuns(const std::string& inputFilename, std::vector<std::filesystem::path>& runs,
+                                           size_t& totalCount) {
+    ChunkSource<T> source(inputFilename, SortExecutor<T>::MAX_REPORTED_ERRORS);
+    std::vector<T> chunk;
+    chunk.reserve(chunkElements_);
+    const std::string prefix = uniqueRunPrefix();
+    totalCount = 0;
+
+    while (true) {
+        chunk.clear();
+        size_t count = source.read(chunk, chunkElements_);
+        if (count == 0) {
+            break;
+        }
+        totalCount += count;
+        // The strategies never see NaNs; they go to the ends of the run, which is then in sortedOrderLess order
+        NaNKeys<T> nans;
+        nans.extract(chunk);
+        strategy_->sort(chunk, scratch_);
+        orderSignedZeros(chunk);
+
+        std::filesystem::path path = tempDirectory_ / (prefix + std::to_string(runs.size()) + ".run");
+        // Listed before it is written, so a failure still removes it
+        runs.push_back(path);
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        for (const std::vector<T>* part : {&nans.negative, &chunk, &nans.positive}) {
+            out.write(reinterpret_cast<const char*>(part->data()),
+                      static_cast<std::streamsize>(part->size() * sizeof(T)));
+        }
+        out.close();
+        if (out.fail()) {
+            throw std::runtime_error("Could not write run file " + path.string());
+        }
+    }
+    // The merge gets the whole budget for its buffers
+    scratch_.release();
+}
+
+template <typename T>
+size_t ExternalSortExecutor<T>::mergeRuns(std::vector<std::filesystem::path>& runs,
+                                          const std::string& sortedFilename) {
+    // The budget is shared evenly between one read buffer per merged run and the output buffer
+    auto bufferElementsFor = [this](size_t sources) {
+        return std::max(memoryBudgetBytes_ / sizeof(T) / (sources + 1), MIN_BUFFER_ELEMENTS);
+    };
+
+    // Intermediate passes merge groups of fanIn_ runs until one final merge is left
+    size_t passes = 0;
+    const std::string prefix = uniqueRunPrefix();
+    while (runs.size() > fanIn_) {
+        ++passes;
+        const std::vector<std::filesystem::path> inputs = runs;
+        std::vector<std::filesystem::path> merged;
+        for (size_t first = 0; first < inputs.size(); first += fanIn_) {
+            std::vector<std::filesystem::path> group(inputs.begin() + first,
+                                                     inputs.begin() + std::min(first + fanIn_, inputs.size()));
+            if (group.size() == 1) {
+                merged.push_back(group.front());
+                continue;
+            }
+            std::filesystem::path path =
+                tempDirectory_ / (prefix + std::to_string(passes) + "_" + std::to_string(merged.size()) + ".run");
+            // Listed before it is written, so a failure still removes it
+            runs.push_back(path);
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            mergeRunFiles<T>(group, bufferElementsFor(group.size()), [&out](const std::vector<T>& block) {
+                out.write(reinterpret_cast<const char*>(block.data()),
+                          static_cast<std::streamsize>(block.size() * sizeof(T)));
+            });
+            out.close();
+            if (out.fail()) {
+                throw std::runtime_error("Could not write run file " + path.string());
+            }
+            merged.push_back(path);
+
+            std::error_code ignored;
+            for (const auto& consumed : group) {
+                std::filesystem::remove(consumed, ignored);
+            }
+        }
+        runs = std::move(merged);
+    }
+
+    DatasetWriter<T> writer(sortedFilename);
+    mergeRunFiles<T>(runs, bufferElementsFor(runs.size()), [&writer](const std::vector<T>& block) {
+        writer.write(block);
+    });
+    writer.close();
+    return passes + 1;
+}
+
+template <typename T>
+void ExternalSortExecutor<T>::writeOutput(const std::string& filename, size_t size, size_t runCount,
+                                          size_t mergePasses, const ExternalPhaseTimings& timings,
+                                          const std::string& outputFilename) {
+    std::ofstream outfile(outputFilename, std::ios::app);
+    if (outfile.is_open()) {
+        outfile << "Algorithm: External " << strategy_->getName() << ", File: " << filename << ", Size: " << size
+                << ", Runs: " << runCount << ", Merge passes: " << mergePasses
+                << ", Budget: " << memoryBudgetBytes_ << "B"
+                << ", Run generation: " << timings.runGeneration << "s, Merge: " << timings.merge << "s" << std::endl;
+        outfile.close();
+    } else {
+        std::cerr << "Unable to open output file: " << outputFilename << std::endl;
+    }
+}
+
+#define INSTANTIATE_EXTERNAL_SORT_KEY(K) template class ExternalSortExecutor<K>;
+SORT_KEY_TYPES(INSTANTIATE_EXTERNAL_SORT_KEY)
@@ -0,0 +1,126 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#ifndef ALGORITHMS_PROGRAMMING_EXERCISES_EXTERNAL_SORT_H
+#define ALGORITHMS_PROGRAMMING_EXERCISES_EXTERNAL_SORT_H
+
+#include "sort_algorithms.h"
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Tournament tree over k sorted sources. Each internal node remembers the
+// loser of its match, so replacing the winner's head costs one comparison
+// per level (log2 k) instead of the two a binary heap needs.
+// Less(a, b) compares the current heads of sources a and b; it must treat an
+// exhausted source as larger than everything.
+template <typename Less>
+class LoserTree {
+public:
+    LoserTree(size_t sources, Less less);
+
+    // Index of the source holding the smallest head
+    size_t winner() const { return tree_[0]; }
+
+    // Re-runs the matches on the path of source after its head changed
+    void replay(size_t source);
+
+private:
+    size_t leaves_;
+    std::vector<size_t> tree_;
+    Less less_;
+};
+
+template <typename Less>
+LoserTree<Less>::LoserTree(size_t sources, Less less) : leaves_(1), less_(std::move(less)) {
+    while (leaves_ < sources) {
+        leaves_ *= 2;
+    }
+    // Padding leaves are indices >= sources; less_ must treat them as exhausted
+    tree_.assign(leaves_, 0);
+    std::vector<size_t> winners(2 * leaves_);
+    for (size_t i = 0; i < leaves_; ++i) {
+        winners[leaves_ + i] = i;
+    }
+    for (size_t node = leaves_ - 1; node >= 1; --node) {
+        size_t a = winners[2 * node];
+        size_t b = winners[2 * node + 1];
+        bool aWins = !less_(b, a);
+        winners[node] = aWins ? a : b;
+        tree_[node] = aWins ? b : a;
+    }
+    tree_[0] = winners[1];
+}
+
+template <typename Less>
+void LoserTree<Less>::replay(size_t source) {
+    size_t winner = source;
+    for (size_t node = (leaves_ + source) / 2; node >= 1; node /= 2) {
+        // Ties go to the lower index so runs are merged stably
+        size_t other = tree_[node];
+        if (less_(other, winner) || (!less_(winner, other) && other < winner)) {
+            std::swap(tree_[node], winner);
+        }
+    }
+    tree_[0] = winner;
+}
+
+// Wall time of the external sort phases in seconds
+struct ExternalPhaseTimings {
+    double runGeneration = 0.0;  // read + sort + spill of every chunk
+    double merge = 0.0;          // every k-way merge pass, ending in the sorted output
+};
+
+// Sorts inputs larger than memory: bounded chunks are sorted with the given
+// strategy and spilled as runs to temporary files, which are then k-way merged
+// through a loser tree into the sorted output file. A merge reads at most
+// fanIn() runs at once, so the read buffers stay within the memory budget and
+// the open files stay bounded; with more runs, intermediate passes merge
+// groups of them into longer runs first.
+template <typename T>
+class ExternalSortExecutor {
+public:
+    static constexpr size_t MIN_BUFFER_ELEMENTS = 4096;
+    // Upper bound on the runs open at once, well below the usual descriptor limit of 1024
+    static constexpr size_t DEFAULT_MAX_FAN_IN = 256;
+
+    ExternalSortExecutor(std::unique_ptr<SortStrategy<T>> strategy, size_t memoryBudgetBytes,
+                         std::filesystem::path tempDirectory = std::filesystem::temp_directory_path(),
+                         size_t maxFanIn = DEFAULT_MAX_FAN_IN);
+
+    // Sorts inputFilename into sortedFilename and appends a results line to outputFilename.
+    // Formats follow the file extensions (.bin is the binary container). Returns false
+    // if the sort failed; the error is printed and no run file is left behind.
+    bool execute(const std::string& inputFilename, const std::string& sortedFilename,
+                 const std::string& outputFilename);
+
+    size_t chunkElements() const { return chunkElements_; }
+    // Runs merged at once: as many MIN_BUFFER_ELEMENTS buffers as fit the budget next
+    // to the output buffer, capped by maxFanIn, and at least 2
+    size_t fanIn() const { return fanIn_; }
+
+private:
+    // Appends every run file to runs before writing it, so the caller can remove them all
+    // on failure; the total element count is stored in totalCount
+    void generateRuns(const std::string& inputFilename, std::vector<std::filesystem::path>& runs,
+                      size_t& totalCount);
+    // Merges the runs into sortedFilename and returns the number of passes. Merged runs are
+    // deleted as soon as they are consumed; runs lists the run files still on disk throughout.
+    size_t mergeRuns(std::vector<std::filesystem::path>& runs, const std::string& sortedFilename);
+    void writeOutput(const std::string& filename, size_t size, size_t runCount, size_t mergePasses,
+                     const ExternalPhaseTimings& timings, const std::string& outputFilename);
+
+    std::unique_ptr<SortStrategy<T>> strategy_;
+    size_t memoryBudgetBytes_;
+    size_t chunkElements_;
+    size_t fanIn_;
+    std::filesystem::path tempDirectory_;
+    // Scratch of the chunk sorts, allocated for the first run and reused by the others
+    ScratchArena scratch_;
+};
+
+#endif //ALGORITHMS_PROGRAMMING_EXERCISES_EXTERNAL_SORT_H
@@ -0,0 +1,102 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "external_sort.h"
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    constexpr size_t DEFAULT_MEMORY_MB = 256;
+
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program << " <input_filename> <sorted_filename> <output_filename>"
+                  << " [--memory <MiB>] [--temp-dir <path>]"
+                  << " [--algorithm <name>] [--threads <count>] [--cutoff <elements>]"
+                  << " [--keys int|int64|uint64|float|double]" << std::endl;
+        std::cerr << "Algorithms:";
+        for (const auto& name : sortStrategyNames()) {
+            std::cerr << " " << name;
+        }
+        std::cerr << std::endl;
+    }
+
+    template <typename T>
+    int sortExternally(const SortOptions& options, size_t memoryBytes, const std::filesystem::path& tempDirectory,
+                       const std::string& inputFilename, const std::string& sortedFilename,
+                       const std::string& outputFilename) {
+        ExternalSortExecutor<T> executor(makeSortStrategy<T>(options), memoryBytes, tempDirectory);
+        return executor.execute(inputFilename, sortedFilename, outputFilename) ? 0 : 1;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 4) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::string inputFilename = argv[1];
+    std::string sortedFilename = argv[2];
+    std::string outputFilename = argv[3];
+
+    SortOptions options;
+    options.algorithm = "pdq";
+    size_t memoryMegabytes = DEFAULT_MEMORY_MB;
+    std::filesystem::path tempDirectory = std::filesystem::temp_directory_path();
+    std::string keys = "int";
+    try {
+        for (int i = 4; i < argc; ++i) {
+            std::string flag = argv[i];
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + flag);
+            }
+            std::string value = argv[++i];
+            if (flag == "--memory") {
+                memoryMegabytes = std::stoull(value);
+            } else if (flag == "--temp-dir") {
+                tempDirectory = value;
+            } else if (flag == "--algorithm") {
+                options.algorithm = value;
+            } else if (flag == "--threads") {
+                options.threads = std::stoul(value);
+            } else if (flag == "--cutoff") {
+                options.cutoff = std::stoull(value);
+            } else if (flag == "--keys") {
+                keys = value;
+            } else {
+                throw std::invalid_argument("Unknown option " + flag);
+            }
+        }
+
+        auto sort = [&](auto key) {
+            return sortExternally<decltype(key)>(options, memoryMegabytes << 20, tempDirectory, inputFilename,
+                                                 sortedFilename, outputFilename);
+        };
+        if (keys == "int") {
+            return sort(int{});
+        }
+        if (keys == "int64") {
+            return sort(int64_t{});
+        }
+        if (keys == "uint64") {
+            return sort(uint64_t{});
+        }
+        if (keys == "float") {
+            return sort(float{});
+        }
+        if (keys == "double") {
+            return sort(double{});
+        }
+        throw std::invalid_argument("Unknown key type " + keys);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "sort_algorithms.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+template <typename T>
+std::pmr::vector<uint64_t> IndirectSort<T>::sortedPairs(const std::vector<T>& arr,
+                                                        std::pmr::memory_resource& scratch) {
+    const size_t n = arr.size();
+    if (n > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("IndirectSort indexes at most 2^32 - 1 elements");
+    }
+
+    // The order-preserving unsigned key goes to the high half, the position to the low half
+    std::pmr::vector<uint64_t> pairs(n, &scratch);
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t key = RadixSort<Key>::toKey(KeyProjection<T>::key(arr[i]));
+        pairs[i] = (key << 32) | i;
+    }
+    keyStrategy_->sort(pairs, scratch);
+    return pairs;
+}
+
+template <typename T>
+void IndirectSort<T>::gather(std::vector<T>& arr, const std::pmr::vector<uint64_t>& pairs, std::vector<T>& out) {
+    // Writes are sequential; the scattered reads are prefetched a few positions ahead
+    const size_t n = pairs.size();
+    out.clear();
+    out.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+#if defined(__GNUC__)
+        if (i + PREFETCH_DISTANCE < n) {
+            __builtin_prefetch(&arr[static_cast<uint32_t>(pairs[i + PREFETCH_DISTANCE])]);
+        }
+#endif
+        out.push_back(std::move(arr[static_cast<uint32_t>(pairs[i])]));
+    }
+}
+
+template <typename T>
+void IndirectSort<T>::sort(std::vector<T>& arr) {
+    if (arr.size() < 2) {
+        return;
+    }
+    std::pmr::vector<uint64_t> pairs = sortedPairs(arr, *std::pmr::get_default_resource());
+    std::vector<T> sorted;
+    gather(arr, pairs, sorted);
+    arr.swap(sorted);
+}
+
+template <typename T>
+void IndirectSort<T>::sort(std::vector<T>& arr, std::pmr::memory_resource& scratch) {
+    if (arr.size() < 2) {
+        return;
+    }
+    std::pmr::vector<uint64_t> pairs = sortedPairs(arr, scratch);
+    gather(arr, pairs, spare_);
+    arr.swap(spare_);
+    // Only the capacity is kept; the moved-from values go now
+    spare_.clear();
+}
+
+template class IndirectSort<int>;
+#define INSTANTIATE_INDIRECT_SORT(P) template class IndirectSort<Record<P>>;
+SORT_RECORD_PAYLOADS(INSTANTIATE_INDIRECT_SORT)
@@ -0,0 +1,244 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "input_distributions.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+    constexpr uint64_t NEARLY_SORTED_SWAP_PERCENT = 1;
+    // Mixed into the seed so the swap stream differs from every block substream
+    constexpr uint64_t SWAP_STREAM = 0x5e0b1a5ed5a9ULL;
+
+    const std::vector<std::pair<std::string, Distribution>>& registry() {
+        static const std::vector<std::pair<std::string, Distribution>> entries = {
+            {"random", Distribution::Random},
+            {"unique", Distribution::Unique},
+            {"sorted", Distribution::Sorted},
+            {"reversed", Distribution::Reversed},
+            {"nearly_sorted", Distribution::NearlySorted},
+            {"few_unique", Distribution::FewUnique},
+            {"organ_pipe", Distribution::OrganPipe},
+            {"zipf", Distribution::Zipf},
+        };
+        return entries;
+    }
+
+    // log1p(x) / x and expm1(x) / x, with their series near zero
+    double helper1(double x) {
+        return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+    }
+
+    double helper2(double x) {
+        return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+    }
+
+    template <typename T>
+    uint64_t resolveDomain(uint64_t domain) {
+        // Every non-negative key, i.e. max + 1, which fits uint64_t for the signed types
+        constexpr uint64_t full = static_cast<uint64_t>(std::numeric_limits<T>::max()) + 1;
+        if (domain == 0) {
+            return full;
+        }
+        if (domain > full) {
+            throw std::invalid_argument("Key domain does not fit the key type");
+        }
+        return domain;
+    }
+}
+
+std::vector<std::string> distributionNames() {
+    std::vector<std::string> names;
+    for (const auto& entry : registry()) {
+        names.push_back(entry.first);
+    }
+    return names;
+}
+
+Distribution parseDistribution(const std::string& name) {
+    for (const auto& entry : registry()) {
+        if (entry.first == name) {
+            return entry.second;
+        }
+    }
+    throw std::invalid_argument("Unknown distribution: " + name);
+}
+
+std::string distributionName(Distribution distribution) {
+    for (const auto& entry : registry()) {
+        if (entry.second == distribution) {
+            return entry.first;
+        }
+    }
+    return "unknown";
+}
+
+ZipfDistribution::ZipfDistribution(uint64_t n, double exponent) : n_(n), exponent_(exponent) {
+    if (n == 0 || !(exponent > 0.0)) {
+        throw std::invalid_argument("Zipf needs at least one rank and a positive exponent");
+    }
+    hIntegralX1_ = hIntegral(1.5) - 1.0;
+    hIntegralN_ = hIntegral(static_cast<double>(n) + 0.5);
+    s_ = 2.0 - hIntegralInverse(hIntegral(2.5) - h(2.0));
+}
+
+double ZipfDistribution::h(double x) const {
+    return std::exp(-exponent_ * std::log(x));
+}
+
+double ZipfDistribution::hIntegral(double x) const {
+    double logX = std::log(x);
+    return helper2((1.0 - exponent_) * logX) * logX;
+}
+
+double ZipfDistribution::hIntegralInverse(double x) const {
+    double t = std::max(x * (1.0 - exponent_), -1.0);
+    return std::exp(helper1(t) * x);
+}
+
+uint64_t ZipfDistribution::operator()(std::mt19937_64& rng) const {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    while (true) {
+        double u = hIntegralN_ + unit(rng) * (hIntegralX1_ - hIntegralN_);
+        double x = hIntegralInverse(u);
+        double rounded = std::floor(x + 0.5);
+        uint64_t k = rounded < 1.0 ? 1
+                   : rounded >= static_cast<double>(n_) ? n_
+                   : static_cast<uint64_t>(rounded);
+        double kd = static_cast<double>(k);
+        if (kd - x <= s_ || u >= hIntegral(kd + 0.5) - h(kd)) {
+            return k;
+        }
+    }
+}
+
+template <typename T>
+DistributionGenerator<T>::DistributionGenerator(Distribution distribution, uint64_t count, const DistributionOptions& options)
+    : distribution_(distribution), count_(count), domain_(resolveDomain<T>(options.domain)), seed_(options.seed),
+      uniqueKeys_(std::clamp<uint64_t>(options.uniqueKeys, 1, domain_)),
+      permutation_(domain_, options.seed) {
+    if (distribution == Distribution::Unique && count > domain_) {
+        throw std::invalid_argument("Cannot draw " + std::to_string(count) + " unique keys from a domain of "
+                                    + std::to_string(domain_));
+    }
+    if (distribution == Distribution::Zipf) {
+        zipf_.emplace(domain_, options.zipfExponent);
+    }
+    if (distribution == Distribution::NearlySorted && count > 1) {
+        buildDisplacements(options.swaps.value_or(count * NEARLY_SORTED_SWAP_PERCENT / 100));
+    }
+}
+
+template <typename T>
+void DistributionGenerator<T>::buildDisplacements(uint64_t swaps) {
+    // Composes the swaps in order, tracking only the positions they touched
+    std::mt19937_64 rng(mix64(seed_ ^ SWAP_STREAM));
+    std::uniform_int_distribution<uint64_t> index(0, count_ - 1);
+    std::unordered_map<uint64_t, uint64_t> source;
+    auto at = [&](uint64_t position) -> uint64_t& {
+        return source.try_emplace(position, position).first->second;
+    };
+    for (uint64_t i = 0; i < swaps; ++i) {
+        uint64_t a = index(rng);
+        uint64_t b = index(rng);
+        std::swap(at(a), at(b));
+    }
+    for (const auto& [position, from] : source) {
+        if (position != from) {
+            displaced_.emplace_back(position, from);
+        }
+    }
+    std::sort(displaced_.begin(), displaced_.end());
+}
+
+template <typename T>
+uint64_t DistributionGenerator<T>::sortedKey(uint64_t index) const {
+    return static_cast<uint64_t>(static_cast<unsigned __int128>(index) * domain_ / count_);
+}
+
+template <typename T>
+size_t DistributionGenerator<T>::generateBlock(uint64_t block, T* out) const {
+    uint64_t first = block * BLOCK_SIZE;
+    if (first >= count_) {
+        return 0;
+    }
+    size_t n = static_cast<size_t>(std::min<uint64_t>(BLOCK_SIZE, count_ - first));
+    std::mt19937_64 rng(mix64(seed_ ^ mix64(block)));
+
+    switch (distribution_) {
+        case Distribution::Random: {
+            std::uniform_int_distribution<uint64_t> keys(0, domain_ - 1);
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = static_cast<T>(keys(rng));
+            }
+            break;
+        }
+        case Distribution::Unique:
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = static_cast<T>(permutation_(first + i));
+            }
+            break;
+        case Distribution::Sorted:
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = static_cast<T>(sortedKey(first + i));
+            }
+            break;
+        case Distribution::Reversed:
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = static_cast<T>(sortedKey(count_ - 1 - (first + i)));
+            }
+            break;
+        case Distribution::NearlySorted: {
+            auto next = std::lower_bound(displaced_.begin(), displaced_.end(), std::make_pair(first, uint64_t(0)));
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t position = first + i;
+                uint64_t from = position;
+                if (next != displaced_.end() && next->first == position) {
+                    from = (next++)->second;
+                }
+                out[i] = static_cast<T>(sortedKey(from));
+            }
+            break;
+        }
+        case Distribution::FewUnique: {
+            std::uniform_int_distribution<uint64_t> pick(0, uniqueKeys_ - 1);
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = static_cast<T>(permutation_(pick(rng)));
+            }
+            break;
+        }
+        case Distribution::OrganPipe:
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t position = first + i;
+                out[i] = static_cast<T>(sortedKey(std::min(position, count_ - 1 - position)));
+            }
+            break;
+        case Distribution::Zipf:
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = static_cast<T>(permutation_((*zipf_)(rng) - 1));
+            }
+            break;
+    }
+    return n;
+}
+
+template <typename T>
+std::vector<T> generateDistribution(Distribution distribution, size_t n, uint64_t seed) {
+    DistributionOptions options;
+    options.seed = seed;
+    DistributionGenerator<T> generator(distribution, n, options);
+    std::vector<T> values(n);
+    for (uint64_t block = 0; block < generator.blockCount(); ++block) {
+        generator.generateBlock(block, values.data() + block * DistributionGenerator<T>::BLOCK_SIZE);
+    }
+    return values;
+}
+
+template class DistributionGenerator<int>;
+template class DistributionGenerator<int64_t>;
+template std::vector<int> generateDistribution<int>(Distribution distribution, size_t n, uint64_t seed);
+template std::vector<int64_t> generateDistribution<int64_t>(Distribution distribution, size_t n, uint64_t seed);
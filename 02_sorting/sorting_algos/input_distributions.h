@@ -0,0 +1,106 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#ifndef ALGORITHMS_PROGRAMMING_EXERCISES_INPUT_DISTRIBUTIONS_H
+#define ALGORITHMS_PROGRAMMING_EXERCISES_INPUT_DISTRIBUTIONS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "unique_permutation.h"
+
+// Input shapes used to exercise the sort strategies
+enum class Distribution {
+    Random,        // uniform keys over the domain, repeats allowed
+    Unique,        // distinct keys in shuffled order (a prefix of a seeded permutation of the domain)
+    Sorted,        // ascending, evenly spread over the domain
+    Reversed,      // descending
+    NearlySorted,  // ascending with k random swaps (1% of the count by default)
+    FewUnique,     // uniform over a handful of distinct keys
+    OrganPipe,     // ascending then descending
+    Zipf,          // Zipf-distributed ranks, mapped to scattered keys
+};
+
+// Names accepted by parseDistribution, in declaration order
+std::vector<std::string> distributionNames();
+
+// Throws std::invalid_argument for unknown names
+Distribution parseDistribution(const std::string& name);
+std::string distributionName(Distribution distribution);
+
+// Tuning knobs of the generator; the defaults are what the benchmark uses
+struct DistributionOptions {
+    uint64_t domain = 0;            // keys are drawn from [0, domain); 0 selects every non-negative key
+    uint64_t seed = 12345;
+    std::optional<uint64_t> swaps;  // NearlySorted; 1% of the count when unset
+    uint64_t uniqueKeys = 16;       // FewUnique
+    double zipfExponent = 1.0;      // Zipf
+};
+
+// Zipf sampler over the ranks 1..n using rejection-inversion
+// (Hörmann & Derflinger), so it needs no table and works for huge n.
+class ZipfDistribution {
+public:
+    // Throws std::invalid_argument for n == 0 or a non-positive exponent
+    ZipfDistribution(uint64_t n, double exponent);
+
+    uint64_t operator()(std::mt19937_64& rng) const;
+
+private:
+    double h(double x) const;
+    double hIntegral(double x) const;
+    double hIntegralInverse(double x) const;
+
+    uint64_t n_;
+    double exponent_;
+    double hIntegralX1_;
+    double hIntegralN_;
+    double s_;
+};
+
+// Produces a dataset block by block. Block b depends only on the options
+// and on b (every block draws from its own seeded substream), so blocks can
+// be generated on any thread, in any order, and simply concatenated.
+// Memory is O(1) except for NearlySorted, which keeps its O(swaps) displacements.
+template <typename T>
+class DistributionGenerator {
+public:
+    static constexpr size_t BLOCK_SIZE = 1 << 16;
+
+    // Throws std::invalid_argument if the domain does not fit T or is
+    // smaller than count for Distribution::Unique
+    DistributionGenerator(Distribution distribution, uint64_t count, const DistributionOptions& options = {});
+
+    uint64_t count() const { return count_; }
+    uint64_t blockCount() const { return (count_ + BLOCK_SIZE - 1) / BLOCK_SIZE; }
+
+    // Writes the elements of the given block to out (room for BLOCK_SIZE values) and returns their number
+    size_t generateBlock(uint64_t block, T* out) const;
+
+private:
+    // Key of position index in the ascending arrangement
+    uint64_t sortedKey(uint64_t index) const;
+    void buildDisplacements(uint64_t swaps);
+
+    Distribution distribution_;
+    uint64_t count_;
+    uint64_t domain_;
+    uint64_t seed_;
+    uint64_t uniqueKeys_;
+    UniquePermutation permutation_;
+    std::optional<ZipfDistribution> zipf_;  // Zipf only, so its exponent is not checked for the others
+    // NearlySorted: (position, source position) for every position the swaps moved, by position
+    std::vector<std::pair<uint64_t, uint64_t>> displaced_;
+};
+
+// Whole dataset in memory; deterministic for a given seed
+template <typename T>
+std::vector<T> generateDistribution(Distribution distribution, size_t n, uint64_t seed);
+
+#endif //ALGORITHMS_PROGRAMMING_EXERCISES_INPUT_DISTRIBUTIONS_H
@@ -3,24 +3,65 @@
 //
 
 #include "sort_algorithms.h"
+#include "string_sort.h"
 
 template<typename T>
 void InsertionSort<T>::sort(std::vector<T> &arr)
 {
-    int n = arr.size();
-    for (int i = 1; i < n; ++i) {
-        T key = arr[i];
-        int j = i - 1;
+    sortRange(arr.data(), arr.data() + arr.size());
+}
+
+template<typename T>
+void InsertionSort<T>::sortRange(T* first, T* last)
+{
+    if (first == last) {
+        return;
+    }
+    for (T* i = first + 1; i != last; ++i) {
+        T key = std::move(*i);
+        T* j = i;
 
-        /* Move elements of arr[0..i-1], that are
+        /* Move elements of [first, i), that are
            greater than key, to one position ahead
            of their current position */
-        while (j >= 0 && arr[j] > key) {
-            arr[j + 1] = arr[j];
-            j = j - 1;
+        while (j != first && *(j - 1) > key) {
+            *j = std::move(*(j - 1));
+            --j;
+        }
+        *j = std::move(key);
+    }
+}
+
+template<typename T>
+bool InsertionSort<T>::partialSortRange(T* first, T* last, size_t moveLimit)
+{
+    if (first == last) {
+        return true;
+    }
+    size_t moved = 0;
+    for (T* i = first + 1; i != last; ++i) {
+        if (!(*(i - 1) > *i)) {
+            continue;
+        }
+        T key = std::move(*i);
+        T* j = i;
+        while (j != first && *(j - 1) > key) {
+            *j = std::move(*(j - 1));
+            --j;
+        }
+        *j = std::move(key);
+
+        moved += i - j;
+        if (moved > moveLimit) {
+            return false;
         }
-        arr[j + 1] = key;
     }
+    return true;
 }
 
-template class InsertionSort<int>;
\ No newline at end of file
+#define INSTANTIATE_INSERTION_SORT_KEY(K) template class InsertionSort<K>;
+SORT_KEY_TYPES(INSTANTIATE_INSERTION_SORT_KEY)
+template class InsertionSort<std::string_view>;
+template class InsertionSort<MultikeyQuicksort::KeyedString>;
+#define INSTANTIATE_INSERTION_SORT(P) template class InsertionSort<Record<P>>;
+SORT_RECORD_PAYLOADS(INSTANTIATE_INSERTION_SORT)
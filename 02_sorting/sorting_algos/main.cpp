@@ -2,23 +2,205 @@
 // Created by keret on 2026. 02. 15..
 //
 
+#include "batch_sort.h"
 #include "sort_algorithms.h"
+#include "string_sort.h"
 #include <iostream>
 #include <string>
 #include <vector>
 #include <memory>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program << " <input_filename> <output_filename>"
+                  << " [--algorithm <name>] [--threads <count>] [--cutoff <elements>]"
+                  << " [--mode direct|indirect] [--sorted <sorted_filename>]"
+                  << " [--top-k <k>] [--quantiles <q1,q2,...>] [--keys int|int64|uint64|float|double|string]"
+                  << std::endl;
+        std::cerr << "       " << program << " --batch <directory_or_manifest> <report.csv|report.json>"
+                  << " [--jobs <count>] [--memory <MiB>] [--sorted-dir <directory>]"
+                  << " [--algorithm <name>] [--threads <count>] [--cutoff <elements>] [--mode direct|indirect]"
+                  << " [--keys int|int64|uint64|float|double]" << std::endl;
+        std::cerr << "Algorithms:";
+        for (const auto& name : sortStrategyNames()) {
+            std::cerr << " " << name;
+        }
+        std::cerr << std::endl;
+        std::cerr << "String key algorithms:";
+        for (const auto& name : lineSortStrategyNames()) {
+            std::cerr << " " << name;
+        }
+        std::cerr << std::endl;
+    }
+
+    // Comma-separated quantiles, each in [0, 1]
+    std::vector<double> parseQuantiles(const std::string& value) {
+        std::vector<double> quantiles;
+        size_t start = 0;
+        while (start <= value.size()) {
+            size_t comma = std::min(value.find(',', start), value.size());
+            double q = std::stod(value.substr(start, comma - start));
+            if (!(q >= 0.0 && q <= 1.0)) {
+                throw std::invalid_argument("Quantile " + value.substr(start, comma - start) + " is outside [0, 1]");
+            }
+            quantiles.push_back(q);
+            start = comma + 1;
+        }
+        return quantiles;
+    }
+
+    // Calls run with a value of the numeric key type named by keys and returns its result
+    template <typename Run>
+    int withKeyType(const std::string& keys, Run run) {
+        if (keys == "int") {
+            return run(int{});
+        }
+        if (keys == "int64") {
+            return run(int64_t{});
+        }
+        if (keys == "uint64") {
+            return run(uint64_t{});
+        }
+        if (keys == "float") {
+            return run(float{});
+        }
+        if (keys == "double") {
+            return run(double{});
+        }
+        throw std::invalid_argument("Unknown key type " + keys);
+    }
+
+    template <typename T>
+    int sortBatch(const std::string& inputFilename, const std::string& reportFilename, const BatchOptions& options) {
+        std::vector<std::string> inputs = listBatchInputs(inputFilename);
+        std::vector<SortReport> reports = runBatch<T>(inputs, options);
+        writeBatchReport(reportFilename, reports);
+
+        size_t failed = 0;
+        for (const auto& report : reports) {
+            if (!report.error.empty()) {
+                std::cerr << report.inputFilename << ": " << report.error << std::endl;
+                ++failed;
+            }
+        }
+        std::cout << "Sorted " << reports.size() - failed << " of " << reports.size() << " files, report written to "
+                  << reportFilename << std::endl;
+        return failed == 0 ? 0 : 1;
+    }
+
+    template <typename T>
+    int sortFile(const std::string& inputFilename, const std::string& outputFilename, const SortOptions& options,
+                 const SelectionQuery& query, const std::string& sortedFilename) {
+        SortExecutor<T> executor(makeSortStrategy<T>(options));
+        if (query.topK > 0 || !query.quantiles.empty()) {
+            // Only a few ranks are needed, so the input is selected from instead of sorted
+            executor.executeSelection(inputFilename, outputFilename, query, sortedFilename);
+        } else {
+            // Writing the sorted data switches to the pipelined parse / sort / merge / write mode
+            executor.execute(inputFilename, outputFilename, sortedFilename);
+        }
+        return 0;
+    }
+}
 
 int main(int argc, char *argv[]) {
     if (argc < 3) {
-        std::cerr << "Usage: " << argv[0] << " <input_filename> <output_filename>" << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    bool batch = std::string(argv[1]) == "--batch";
+    if (batch && argc < 4) {
+        printUsage(argv[0]);
         return 1;
     }
+    int firstOption = batch ? 4 : 3;
+    std::string inputFilename = argv[firstOption - 2];
+    std::string outputFilename = argv[firstOption - 1];
 
-    std::string inputFilename = argv[1];
-    std::string outputFilename = argv[2];
-    std::unique_ptr<SortStrategy<int>> strategy = std::make_unique<InsertionSort<int>>();
-    SortExecutor<int> executor(std::move(strategy));
-    executor.execute(inputFilename, outputFilename);
+    SortOptions options;
+    BatchOptions batchOptions;
+    SelectionQuery query;
+    bool threadsGiven = false;
+    bool algorithmGiven = false;
+    std::string keys = "int";
+    std::string sortedFilename;
+    try {
+        for (int i = firstOption; i < argc; ++i) {
+            std::string flag = argv[i];
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + flag);
+            }
+            std::string value = argv[++i];
+            if (flag == "--algorithm") {
+                options.algorithm = value;
+                algorithmGiven = true;
+            } else if (flag == "--threads") {
+                options.threads = std::stoul(value);
+                threadsGiven = true;
+            } else if (flag == "--cutoff") {
+                options.cutoff = std::stoull(value);
+            } else if (flag == "--sorted") {
+                sortedFilename = value;
+            } else if (batch && flag == "--jobs") {
+                batchOptions.jobs = std::stoul(value);
+            } else if (batch && flag == "--memory") {
+                batchOptions.memoryBudgetBytes = std::stoull(value) << 20;
+            } else if (batch && flag == "--sorted-dir") {
+                batchOptions.sortedDirectory = value;
+            } else if (!batch && flag == "--top-k") {
+                query.topK = std::stoull(value);
+            } else if (!batch && flag == "--quantiles") {
+                query.quantiles = parseQuantiles(value);
+            } else if (flag == "--keys") {
+                if (batch && value == "string") {
+                    throw std::invalid_argument("Batch mode sorts numeric keys only");
+                }
+                keys = value;
+            } else if (flag == "--mode") {
+                if (value != "direct" && value != "indirect") {
+                    throw std::invalid_argument("Unknown mode " + value);
+                }
+                options.indirect = value == "indirect";
+            } else {
+                throw std::invalid_argument("Unknown option " + flag);
+            }
+        }
+
+        if (batch) {
+            // Parallelism comes from running files side by side, so each job sorts single-threaded by default
+            if (!threadsGiven) {
+                options.threads = 1;
+            }
+            batchOptions.sort = options;
+            return withKeyType(keys, [&](auto key) {
+                return sortBatch<decltype(key)>(inputFilename, outputFilename, batchOptions);
+            });
+        }
+
+        if (keys == "string") {
+            // Every line is a key, compared bytewise
+            if (query.topK > 0 || !query.quantiles.empty()) {
+                throw std::invalid_argument("Selection queries are only supported for numeric keys");
+            }
+            if (!algorithmGiven) {
+                options.algorithm = "mkqs";
+            }
+            LineSortExecutor executor(makeLineSortStrategy(options));
+            executor.execute(inputFilename, outputFilename, sortedFilename);
+            return 0;
+        }
+
+        return withKeyType(keys, [&](auto key) {
+            return sortFile<decltype(key)>(inputFilename, outputFilename, options, query, sortedFilename);
+        });
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
 
     return 0;
 }
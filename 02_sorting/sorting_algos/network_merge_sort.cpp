@@ -0,0 +1,43 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "sort_algorithms.h"
+#include <algorithm>
+#include <iterator>
+
+template <typename T>
+void NetworkMergeSort<T>::sortValues(T* values, size_t n, std::pmr::memory_resource& scratch) {
+    if (n < 2) {
+        return;
+    }
+
+    for (size_t start = 0; start < n; start += BLOCK_SIZE) {
+        SmallSortKernel<T>::sortRange(values + start, values + std::min(start + BLOCK_SIZE, n));
+    }
+    if (n <= BLOCK_SIZE) {
+        return;
+    }
+
+    std::pmr::vector<T> buffer(n, &scratch);
+    T* from = values;
+    T* to = buffer.data();
+    for (size_t width = BLOCK_SIZE; width < n; width *= 2) {
+        for (size_t left = 0; left < n; left += 2 * width) {
+            size_t mid = std::min(left + width, n);
+            size_t right = std::min(left + 2 * width, n);
+            std::merge(std::make_move_iterator(from + left), std::make_move_iterator(from + mid),
+                       std::make_move_iterator(from + mid), std::make_move_iterator(from + right), to + left);
+        }
+        std::swap(from, to);
+    }
+
+    if (from != values) {
+        std::move(from, from + n, values);
+    }
+}
+
+#define INSTANTIATE_NETWORK_MERGE_SORT_KEY(K) template class NetworkMergeSort<K>;
+SORT_KEY_TYPES(INSTANTIATE_NETWORK_MERGE_SORT_KEY)
+#define INSTANTIATE_NETWORK_MERGE_SORT(P) template class NetworkMergeSort<Record<P>>;
+SORT_RECORD_PAYLOADS(INSTANTIATE_NETWORK_MERGE_SORT)
@@ -0,0 +1,112 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "sort_algorithms.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+    // Below this size the sequential kernel switches from merging to the small-range kernel
+    constexpr size_t SMALL_SORT_THRESHOLD = 32;
+}
+
+template <typename T>
+ParallelMergeSort<T>::ParallelMergeSort(unsigned int threadCount, size_t cutoff)
+    : threadCount_(std::max(1u, threadCount)), cutoff_(std::max<size_t>(cutoff, SMALL_SORT_THRESHOLD)) {}
+
+template <typename T>
+std::string ParallelMergeSort<T>::getName() const {
+    return "Parallel Merge Sort (" + std::to_string(threadCount_) + " threads)";
+}
+
+template <typename T>
+void ParallelMergeSort<T>::sortValues(T* values, size_t n, std::pmr::memory_resource& scratch) {
+    if (n < 2) {
+        return;
+    }
+    // Only the calling thread allocates; the workers just write into the buffer
+    std::pmr::vector<T> buffer(n, &scratch);
+    // The workers start here rather than in the constructor, so perf counters opened
+    // around the sort inherit into them. The calling thread joins in while waiting,
+    // so the pool holds threadCount - 1 workers.
+    std::unique_ptr<WorkStealingPool> pool;
+    if (threadCount_ > 1 && n > cutoff_) {
+        pool = std::make_unique<WorkStealingPool>(threadCount_ - 1);
+    }
+    sortInto(pool.get(), values, buffer.data(), n, true);
+}
+
+template <typename T>
+void ParallelMergeSort<T>::sortInto(WorkStealingPool* pool, T* src, T* dst, size_t n, bool resultInSrc) {
+    if (!pool || n <= cutoff_) {
+        sequentialSortInto(src, dst, n, resultInSrc);
+        return;
+    }
+
+    // Sort both halves into the opposite buffer, then merge back into the target
+    size_t half = n / 2;
+    {
+        TaskGroup group(*pool);
+        group.run([=, this] { sortInto(pool, src, dst, half, !resultInSrc); });
+        sortInto(pool, src + half, dst + half, n - half, !resultInSrc);
+        group.wait();
+    }
+
+    T* from = resultInSrc ? dst : src;
+    T* to = resultInSrc ? src : dst;
+    mergeInto(pool, from, half, from + half, n - half, to);
+}
+
+template <typename T>
+void ParallelMergeSort<T>::sequentialSortInto(T* src, T* dst, size_t n, bool resultInSrc) {
+    if (n <= SMALL_SORT_THRESHOLD) {
+        SmallSortKernel<T>::sortRange(src, src + n);
+        if (!resultInSrc) {
+            std::move(src, src + n, dst);
+        }
+        return;
+    }
+
+    size_t half = n / 2;
+    sequentialSortInto(src, dst, half, !resultInSrc);
+    sequentialSortInto(src + half, dst + half, n - half, !resultInSrc);
+
+    T* from = resultInSrc ? dst : src;
+    T* to = resultInSrc ? src : dst;
+    std::merge(std::make_move_iterator(from), std::make_move_iterator(from + half),
+               std::make_move_iterator(from + half), std::make_move_iterator(from + n), to);
+}
+
+template <typename T>
+void ParallelMergeSort<T>::mergeInto(WorkStealingPool* pool, T* left, size_t leftSize, T* right, size_t rightSize,
+                                     T* out) {
+    if (!pool || leftSize + rightSize <= cutoff_) {
+        std::merge(std::make_move_iterator(left), std::make_move_iterator(left + leftSize),
+                   std::make_move_iterator(right), std::make_move_iterator(right + rightSize), out);
+        return;
+    }
+
+    // Split the larger run at its midpoint and find the matching split in the other run.
+    // Ties keep left-run elements first, so the merge stays stable.
+    size_t leftSplit;
+    size_t rightSplit;
+    if (leftSize >= rightSize) {
+        leftSplit = leftSize / 2;
+        rightSplit = std::lower_bound(right, right + rightSize, left[leftSplit]) - right;
+    } else {
+        rightSplit = rightSize / 2;
+        leftSplit = std::upper_bound(left, left + leftSize, right[rightSplit]) - left;
+    }
+
+    TaskGroup group(*pool);
+    group.run([=, this] { mergeInto(pool, left, leftSplit, right, rightSplit, out); });
+    mergeInto(pool, left + leftSplit, leftSize - leftSplit, right + rightSplit, rightSize - rightSplit,
+              out + leftSplit + rightSplit);
+    group.wait();
+}
+
+#define INSTANTIATE_PARALLEL_MERGE_SORT_KEY(K) template class ParallelMergeSort<K>;
+SORT_KEY_TYPES(INSTANTIATE_PARALLEL_MERGE_SORT_KEY)
+#define INSTANTIATE_PARALLEL_MERGE_SORT(P) template class ParallelMergeSort<Record<P>>;
+SORT_RECORD_PAYLOADS(INSTANTIATE_PARALLEL_MERGE_SORT)
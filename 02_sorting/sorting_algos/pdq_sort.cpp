@@ -0,0 +1,123 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "sort_algorithms.h"
+#include "block_partition.h"
+#include "string_sort.h"
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+namespace {
+    // Element budget of the partial insertion sort tried on already partitioned ranges
+    constexpr size_t PARTIAL_INSERTION_LIMIT = 8;
+    // The smallest threshold for which the pivot selection and shuffles stay in bounds
+    constexpr size_t MIN_THRESHOLD = 8;
+}
+
+template <typename T>
+PdqSort<T>::PdqSort(size_t insertionThreshold, bool useSmallSortKernel)
+    : insertionThreshold_(std::max(insertionThreshold, MIN_THRESHOLD)), useSmallSortKernel_(useSmallSortKernel) {
+    if (useSmallSortKernel_) {
+        insertionThreshold_ = std::min(insertionThreshold_, SmallSortKernel<T>::MAX_SIZE);
+    }
+}
+
+template <typename T>
+std::string PdqSort<T>::getName() const {
+    return useSmallSortKernel_ ? "Pattern-Defeating Quicksort (network kernel)" : "Pattern-Defeating Quicksort";
+}
+
+template <typename T>
+void PdqSort<T>::sort(std::vector<T>& arr) {
+    sortRange(arr.data(), arr.data() + arr.size());
+}
+
+template <typename T>
+void PdqSort<T>::sortRange(T* first, T* last) const {
+    size_t n = last - first;
+    if (n < 2) {
+        return;
+    }
+    sortLoop(first, last, std::bit_width(n), true);
+}
+
+template <typename T>
+void PdqSort<T>::sortLoop(T* begin, T* end, int badAllowed, bool leftmost) const {
+    while (true) {
+        size_t size = end - begin;
+        if (size < insertionThreshold_) {
+            if (useSmallSortKernel_) {
+                SmallSortKernel<T>::sortRange(begin, end);
+            } else {
+                InsertionSort<T>::sortRange(begin, end);
+            }
+            return;
+        }
+
+        // Move the chosen pivot to *begin
+        BlockPartition::choosePivot(begin, end);
+
+        // The element before the range is a previous pivot. If it is not smaller than this
+        // pivot, everything equal to it can be put in place at once.
+        if (!leftmost && !(*(begin - 1) < *begin)) {
+            begin = BlockPartition::partitionLeft(begin, end) + 1;
+            continue;
+        }
+
+        auto [pivotPos, alreadyPartitioned] = BlockPartition::partitionRight(begin, end);
+
+        size_t leftSize = pivotPos - begin;
+        size_t rightSize = end - (pivotPos + 1);
+        bool highlyUnbalanced = leftSize < size / 8 || rightSize < size / 8;
+
+        if (highlyUnbalanced) {
+            // Too many bad pivots: guarantee O(n log n) with heapsort
+            if (--badAllowed == 0) {
+                std::make_heap(begin, end);
+                std::sort_heap(begin, end);
+                return;
+            }
+
+            // Break up patterns that produced the bad pivot
+            if (leftSize >= insertionThreshold_) {
+                std::iter_swap(begin, begin + leftSize / 4);
+                std::iter_swap(pivotPos - 1, pivotPos - leftSize / 4);
+                if (leftSize > BlockPartition::NINTHER_THRESHOLD) {
+                    std::iter_swap(begin + 1, begin + (leftSize / 4 + 1));
+                    std::iter_swap(begin + 2, begin + (leftSize / 4 + 2));
+                    std::iter_swap(pivotPos - 2, pivotPos - (leftSize / 4 + 1));
+                    std::iter_swap(pivotPos - 3, pivotPos - (leftSize / 4 + 2));
+                }
+            }
+            if (rightSize >= insertionThreshold_) {
+                std::iter_swap(pivotPos + 1, pivotPos + (1 + rightSize / 4));
+                std::iter_swap(end - 1, end - rightSize / 4);
+                if (rightSize > BlockPartition::NINTHER_THRESHOLD) {
+                    std::iter_swap(pivotPos + 2, pivotPos + (2 + rightSize / 4));
+                    std::iter_swap(pivotPos + 3, pivotPos + (3 + rightSize / 4));
+                    std::iter_swap(end - 2, end - (1 + rightSize / 4));
+                    std::iter_swap(end - 3, end - (2 + rightSize / 4));
+                }
+            }
+        } else if (alreadyPartitioned
+                   && InsertionSort<T>::partialSortRange(begin, pivotPos, PARTIAL_INSERTION_LIMIT)
+                   && InsertionSort<T>::partialSortRange(pivotPos + 1, end, PARTIAL_INSERTION_LIMIT)) {
+            // A well-balanced partition that needed no swaps is likely (nearly) sorted already
+            return;
+        }
+
+        // Recurse into the left part, loop on the right one
+        sortLoop(begin, pivotPos, badAllowed, leftmost);
+        begin = pivotPos + 1;
+        leftmost = false;
+    }
+}
+
+#define INSTANTIATE_PDQ_SORT_KEY(K) template class PdqSort<K>;
+SORT_KEY_TYPES(INSTANTIATE_PDQ_SORT_KEY)
+template class PdqSort<std::string_view>;
+template class PdqSort<MultikeyQuicksort::KeyedString>;
+#define INSTANTIATE_PDQ_SORT(P) template class PdqSort<Record<P>>;
+SORT_RECORD_PAYLOADS(INSTANTIATE_PDQ_SORT)
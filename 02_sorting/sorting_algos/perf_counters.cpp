@@ -0,0 +1,178 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "perf_counters.h"
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define SORTING_HAS_PERF_EVENTS 1
+#endif
+
+namespace {
+    const char* const EVENT_NAMES[PERF_EVENT_COUNT] = {
+        "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "page_faults",
+    };
+
+#ifdef SORTING_HAS_PERF_EVENTS
+    struct EventConfig {
+        uint32_t type;
+        uint64_t config;
+    };
+
+    constexpr uint64_t cacheReadMiss(uint64_t cache) {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+
+    const EventConfig EVENT_CONFIGS[PERF_EVENT_COUNT] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, cacheReadMiss(PERF_COUNT_HW_CACHE_L1D)},
+        {PERF_TYPE_HW_CACHE, cacheReadMiss(PERF_COUNT_HW_CACHE_LL)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    };
+
+    // Joins the group led by groupFd, or starts one when groupFd is -1
+    int openEvent(const EventConfig& event, int groupFd) {
+        perf_event_attr attr {};
+        attr.size = sizeof(attr);
+        attr.type = event.type;
+        attr.config = event.config;
+        // Members follow the leader, which starts disabled
+        attr.disabled = groupFd < 0 ? 1 : 0;
+        attr.inherit = 1;
+        // User space only, so the default perf_event_paranoid level of 2 suffices
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+    }
+#endif
+}
+
+std::string perfEventName(PerfEvent event) {
+    return EVENT_NAMES[static_cast<size_t>(event)];
+}
+
+std::optional<double> PerfCounts::ipc() const {
+    auto cycles = get(PerfEvent::Cycles);
+    auto instructions = get(PerfEvent::Instructions);
+    if (!cycles || !instructions || *cycles == 0) {
+        return std::nullopt;
+    }
+    return static_cast<double>(*instructions) / static_cast<double>(*cycles);
+}
+
+std::string PerfCounts::format() const {
+    std::ostringstream out;
+    for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        out << (i ? ", " : "") << EVENT_NAMES[i] << "=";
+        if (values[i]) {
+            out << *values[i];
+        } else {
+            out << "n/a";
+        }
+    }
+    out << ", ipc=";
+    if (auto value = ipc()) {
+        out << *value;
+    } else {
+        out << "n/a";
+    }
+    return out.str();
+}
+
+PerfCounterGroup::PerfCounterGroup() {
+    fds_.fill(-1);
+#ifdef SORTING_HAS_PERF_EVENTS
+    int firstError = 0;
+    for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        fds_[i] = openEvent(EVENT_CONFIGS[i], leaderFd());
+        if (fds_[i] < 0 && firstError == 0) {
+            firstError = errno;
+        }
+    }
+    if (!available()) {
+        unavailableReason_ = std::string("perf_event_open failed: ") + std::strerror(firstError);
+    }
+#else
+    unavailableReason_ = "perf_event_open is only available on Linux";
+#endif
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+#ifdef SORTING_HAS_PERF_EVENTS
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+#endif
+}
+
+bool PerfCounterGroup::available() const {
+    return leaderFd() >= 0;
+}
+
+int PerfCounterGroup::leaderFd() const {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            return fd;
+        }
+    }
+    return -1;
+}
+
+void PerfCounterGroup::start() {
+#ifdef SORTING_HAS_PERF_EVENTS
+    int leader = leaderFd();
+    if (leader >= 0) {
+        ::ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ::ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+PerfCounts PerfCounterGroup::stop() {
+    PerfCounts counts;
+#ifdef SORTING_HAS_PERF_EVENTS
+    int leader = leaderFd();
+    if (leader < 0) {
+        return counts;
+    }
+    ::ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // Event count, time enabled, time running, then one value per member in opening order.
+    // The values already include the inherited counters of threads the region started.
+    uint64_t data[3 + PERF_EVENT_COUNT] = {};
+    ssize_t bytes = ::read(leader, data, sizeof(data));
+    if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t))) {
+        return counts;
+    }
+    // A group that never got scheduled has no meaningful values
+    uint64_t enabled = data[1];
+    uint64_t running = data[2];
+    if (running == 0) {
+        return counts;
+    }
+    size_t member = 0;
+    for (size_t i = 0; i < PERF_EVENT_COUNT && member < data[0]; ++i) {
+        if (fds_[i] < 0) {
+            continue;
+        }
+        uint64_t value = data[3 + member++];
+        // The whole group is scheduled together, so one scale factor fits every member
+        counts.values[i] = running < enabled
+            ? static_cast<uint64_t>(static_cast<double>(value) * enabled / running)
+            : value;
+    }
+#endif
+    return counts;
+}
@@ -0,0 +1,72 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#ifndef ALGORITHMS_PROGRAMMING_EXERCISES_PERF_COUNTERS_H
+#define ALGORITHMS_PROGRAMMING_EXERCISES_PERF_COUNTERS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+// Events collected around a measured region, in PerfCounts::values order
+enum class PerfEvent {
+    Cycles,
+    Instructions,
+    L1DMisses,
+    LLCMisses,
+    BranchMisses,
+    PageFaults,
+};
+
+constexpr size_t PERF_EVENT_COUNT = 6;
+
+// Name used in reports, e.g. "llc_misses"
+std::string perfEventName(PerfEvent event);
+
+// Counter values of one region; an event the host could not count stays empty.
+// Values are scaled up if the kernel multiplexed the counter.
+struct PerfCounts {
+    std::array<std::optional<uint64_t>, PERF_EVENT_COUNT> values;
+
+    std::optional<uint64_t> get(PerfEvent event) const { return values[static_cast<size_t>(event)]; }
+    // Instructions per cycle, when both were counted
+    std::optional<double> ipc() const;
+    // "name=value" pairs separated by ", ", with "n/a" for missing events
+    std::string format() const;
+};
+
+// User-space counters of the calling thread via Linux perf_event_open, opened
+// as one group so they are scheduled together and ratios like IPC compare the
+// same intervals. Threads created after the group opens are included; pool
+// workers that already exist are not, which is why ParallelMergeSort starts its
+// workers inside sort(). Opening never throws: events the kernel refuses
+// (no PMU in a VM or container, perf_event_paranoid, non-Linux hosts) are
+// just left out, and unavailableReason() explains why none could be opened.
+class PerfCounterGroup {
+public:
+    PerfCounterGroup();
+    ~PerfCounterGroup();
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    bool available() const;
+    const std::string& unavailableReason() const { return unavailableReason_; }
+
+    // Resets and enables every open counter
+    void start();
+    // Disables the counters and returns their values since start()
+    PerfCounts stop();
+
+private:
+    // First event that opened; the others joined its group
+    int leaderFd() const;
+
+    std::array<int, PERF_EVENT_COUNT> fds_;
+    std::string unavailableReason_;
+};
+
+#endif //ALGORITHMS_PROGRAMMING_EXERCISES_PERF_COUNTERS_H
@@ -0,0 +1,126 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "sort_algorithms.h"
+#include <algorithm>
+#include <array>
+
+template <typename T>
+void RadixSort<T>::sortValues(T* values, size_t n, std::pmr::memory_resource& scratch) {
+    if (n < 2) {
+        return;
+    }
+    std::pmr::vector<T> buffer(n, &scratch);
+    sortInto(values, buffer.data(), n, PASSES, true);
+}
+
+template <typename T>
+void RadixSort<T>::sortInto(T* src, T* dst, size_t n, size_t passes, bool resultInSrc) {
+    if (passes == 0 || n < INSERTION_THRESHOLD) {
+        // Insertion sort on the keys, so floats keep the totalOrder of the radix passes
+        for (size_t i = 1; i < n; ++i) {
+            T value = src[i];
+            Key key = toKey(value);
+            size_t j = i;
+            for (; j > 0 && key < toKey(src[j - 1]); --j) {
+                src[j] = src[j - 1];
+            }
+            src[j] = value;
+        }
+        if (!resultInSrc) {
+            std::copy(src, src + n, dst);
+        }
+        return;
+    }
+    if (n <= LSD_THRESHOLD) {
+        lsdSortInto(src, dst, n, passes, resultInSrc);
+        return;
+    }
+
+    // Skip the high bytes every key shares, then split on the first one that varies
+    std::array<size_t, RADIX> count;
+    unsigned int shift;
+    while (true) {
+        shift = (passes - 1) * 8;
+        count.fill(0);
+        for (size_t i = 0; i < n; ++i) {
+            ++count[(toKey(src[i]) >> shift) & 0xFF];
+        }
+        if (count[(toKey(src[0]) >> shift) & 0xFF] != n) {
+            break;
+        }
+        if (--passes == 0) {
+            sortInto(src, dst, n, 0, resultInSrc);
+            return;
+        }
+    }
+
+    std::array<size_t, RADIX> offsets;
+    size_t sum = 0;
+    for (size_t digit = 0; digit < RADIX; ++digit) {
+        offsets[digit] = sum;
+        sum += count[digit];
+    }
+    for (size_t i = 0; i < n; ++i) {
+        dst[offsets[(toKey(src[i]) >> shift) & 0xFF]++] = src[i];
+    }
+
+    // The buckets now live in dst, so the roles of the buffers swap for them
+    size_t begin = 0;
+    for (size_t digit = 0; digit < RADIX; ++digit) {
+        if (count[digit] > 0) {
+            sortInto(dst + begin, src + begin, count[digit], passes - 1, !resultInSrc);
+        }
+        begin += count[digit];
+    }
+}
+
+template <typename T>
+void RadixSort<T>::lsdSortInto(T* src, T* dst, size_t n, size_t passes, bool resultInSrc) {
+    // One read pass fills the histogram of every digit. The bytes above passes are
+    // counted too: a loop of fixed length unrolls, and their passes are skipped anyway.
+    std::array<std::array<size_t, RADIX>, PASSES> counts;
+    for (auto& count : counts) {
+        count.fill(0);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        Key key = toKey(src[i]);
+        for (size_t pass = 0; pass < PASSES; ++pass) {
+            ++counts[pass][(key >> (pass * 8)) & 0xFF];
+        }
+    }
+
+    T* from = src;
+    T* to = dst;
+    for (size_t pass = 0; pass < passes; ++pass) {
+        auto& count = counts[pass];
+        const unsigned int shift = pass * 8;
+
+        // Every key has the same digit here, the pass would not reorder anything
+        if (count[(toKey(from[0]) >> shift) & 0xFF] == n) {
+            continue;
+        }
+
+        std::array<size_t, RADIX> offsets;
+        size_t sum = 0;
+        for (size_t digit = 0; digit < RADIX; ++digit) {
+            offsets[digit] = sum;
+            sum += count[digit];
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            to[offsets[(toKey(from[i]) >> shift) & 0xFF]++] = from[i];
+        }
+        std::swap(from, to);
+    }
+
+    // The executed passes left the result in the other buffer
+    T* target = resultInSrc ? src : dst;
+    if (from != target) {
+        std::copy(from, from + n, target);
+    }
+}
+
+#define INSTANTIATE_RADIX_SORT_KEY(K) template class RadixSort<K>;
+SORT_KEY_TYPES(INSTANTIATE_RADIX_SORT_KEY)
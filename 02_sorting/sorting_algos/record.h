@@ -0,0 +1,43 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#ifndef ALGORITHMS_PROGRAMMING_EXERCISES_RECORD_H
+#define ALGORITHMS_PROGRAMMING_EXERCISES_RECORD_H
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// A sort key followed by an opaque payload. Records compare by key only,
+// so the comparison-based strategies sort them directly.
+template <size_t PayloadBytes>
+struct Record {
+    int key;
+    unsigned char payload[PayloadBytes];
+
+    friend std::weak_ordering operator<=>(const Record& a, const Record& b) { return a.key <=> b.key; }
+    friend bool operator==(const Record& a, const Record& b) { return a.key == b.key; }
+};
+
+// Payload sizes the strategies are instantiated for; X is invoked with each of them
+#define SORT_RECORD_PAYLOADS(X) X(8) X(32) X(64) X(128) X(256)
+
+// Plain key types the strategies, readers, writers and executors are instantiated for
+#define SORT_KEY_TYPES(X) X(int) X(int64_t) X(uint64_t) X(float) X(double)
+
+// The key a value is ordered by: the value itself for plain keys
+template <typename T>
+struct KeyProjection {
+    using Key = T;
+    static Key key(const T& value) { return value; }
+};
+
+template <size_t PayloadBytes>
+struct KeyProjection<Record<PayloadBytes>> {
+    using Key = int;
+    static Key key(const Record<PayloadBytes>& record) { return record.key; }
+};
+
+#endif //ALGORITHMS_PROGRAMMING_EXERCISES_RECORD_H
@@ -0,0 +1,73 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "scratch_arena.h"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+
+ScratchArena::~ScratchArena() {
+    for (const Block& block : blocks_) {
+        freeBlock(block);
+    }
+}
+
+void ScratchArena::release() {
+    if (live_ != 0) {
+        throw std::logic_error("ScratchArena released while allocations are live");
+    }
+    for (const Block& block : blocks_) {
+        freeBlock(block);
+    }
+    blocks_.clear();
+    used_ = 0;
+    capacity_ = 0;
+}
+
+void* ScratchArena::do_allocate(size_t bytes, size_t alignment) {
+    // Offset of the first suitably aligned byte at or after used_ in the last block
+    auto alignedStart = [this, alignment] {
+        auto base = reinterpret_cast<uintptr_t>(blocks_.back().data);
+        return (base + used_ + alignment - 1) / alignment * alignment - base;
+    };
+    if (blocks_.empty() || alignedStart() + bytes > blocks_.back().size) {
+        // Growing geometrically keeps the block count logarithmic within one round
+        addBlock(std::max(bytes + alignment, 2 * capacity_));
+    }
+    size_t start = alignedStart();
+    used_ = start + bytes;
+    ++live_;
+    return blocks_.back().data + start;
+}
+
+void ScratchArena::do_deallocate(void*, size_t, size_t) {
+    if (--live_ != 0) {
+        return;
+    }
+    used_ = 0;
+    if (blocks_.size() > 1) {
+        // The next round gets everything this one needed in a single block
+        size_t total = capacity_;
+        for (const Block& block : blocks_) {
+            freeBlock(block);
+        }
+        blocks_.clear();
+        capacity_ = 0;
+        addBlock(total);
+    }
+}
+
+void ScratchArena::addBlock(size_t size) {
+    size = (size + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+    auto* data = static_cast<std::byte*>(::operator new(size, std::align_val_t(BLOCK_ALIGNMENT)));
+    blocks_.push_back({data, size});
+    used_ = 0;
+    capacity_ += size;
+    ++blockAllocations_;
+}
+
+void ScratchArena::freeBlock(const Block& block) {
+    ::operator delete(block.data, block.size, std::align_val_t(BLOCK_ALIGNMENT));
+}
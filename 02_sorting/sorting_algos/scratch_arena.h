@@ -0,0 +1,56 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#ifndef ALGORITHMS_PROGRAMMING_EXERCISES_SCRATCH_ARENA_H
+#define ALGORITHMS_PROGRAMMING_EXERCISES_SCRATCH_ARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+// Scratch memory kept by a caller that sorts repeatedly (the executors, the
+// benchmark, batch workers). Allocations are bumped out of cache-line aligned
+// blocks and only come back as a whole: once every allocation was returned,
+// the blocks are merged into one that fits the whole previous round, so the
+// next sort of a similar size needs no allocation and touches no fresh pages.
+// Not thread-safe; strategies allocate from the calling thread only.
+class ScratchArena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t BLOCK_ALIGNMENT = 64;
+
+    ScratchArena() = default;
+    ~ScratchArena() override;
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    // Bytes held in blocks
+    size_t capacity() const { return capacity_; }
+    // Blocks taken from the system so far
+    size_t blockAllocations() const { return blockAllocations_; }
+
+    // Returns the blocks to the system. Only allowed while nothing is allocated.
+    void release();
+
+private:
+    struct Block {
+        std::byte* data;
+        size_t size;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    void addBlock(size_t size);
+    static void freeBlock(const Block& block);
+
+    std::vector<Block> blocks_;  // allocations are bumped out of the last one
+    size_t used_ = 0;            // bytes used in the last block
+    size_t live_ = 0;            // allocations not yet returned
+    size_t capacity_ = 0;
+    size_t blockAllocations_ = 0;
+};
+
+#endif //ALGORITHMS_PROGRAMMING_EXERCISES_SCRATCH_ARENA_H
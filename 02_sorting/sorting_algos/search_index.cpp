@@ -0,0 +1,265 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "search_index.h"
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    template <typename T>
+    void requireSorted(const std::vector<T>& sorted) {
+        if (!std::is_sorted(sorted.begin(), sorted.end())) {
+            throw std::invalid_argument("Search indexes are built from sorted keys");
+        }
+    }
+
+    // Keys of the node smaller than key; a fixed-length loop without early exit
+    template <typename T>
+    size_t countLess(const CacheLineNode<T>& node, const T& key) {
+        size_t count = 0;
+        for (size_t j = 0; j < CacheLineNode<T>::KEYS; ++j) {
+            count += node.keys[j] < key;
+        }
+        return count;
+    }
+}
+
+template <typename T>
+size_t BinarySearchIndex<T>::lowerBound(const T& key) const {
+    return std::lower_bound(keys_.begin(), keys_.end(), key) - keys_.begin();
+}
+
+template <typename T>
+bool BinarySearchIndex<T>::contains(const T& key) const {
+    return std::binary_search(keys_.begin(), keys_.end(), key);
+}
+
+template <typename T>
+void BinarySearchIndex<T>::lowerBound(const T* keys, size_t count, size_t* positions) const {
+    for (size_t i = 0; i < count; ++i) {
+        positions[i] = lowerBound(keys[i]);
+    }
+}
+
+template <typename T>
+void BinarySearchIndex<T>::contains(const T* keys, size_t count, bool* found) const {
+    for (size_t i = 0; i < count; ++i) {
+        found[i] = contains(keys[i]);
+    }
+}
+
+template <typename T>
+EytzingerIndex<T>::EytzingerIndex(const std::vector<T>& sorted) : size_(sorted.size()) {
+    requireSorted(sorted);
+    if (size_ > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("EytzingerIndex stores 32-bit positions");
+    }
+    nodes_.resize(size_ / LINE_KEYS + 1);
+    ranks_.resize(size_ + 1);
+
+    // An in-order walk of the implicit tree visits the slots in key order
+    std::vector<size_t> path;
+    size_t next = 0;
+    size_t slot = 1;
+    while (slot <= size_ || !path.empty()) {
+        while (slot <= size_) {
+            path.push_back(slot);
+            slot *= 2;
+        }
+        slot = path.back();
+        path.pop_back();
+        nodes_[slot / LINE_KEYS].keys[slot % LINE_KEYS] = sorted[next];
+        ranks_[slot] = static_cast<uint32_t>(next++);
+        slot = 2 * slot + 1;
+    }
+}
+
+template <typename T>
+void EytzingerIndex<T>::prefetchDescendants(size_t slot) const {
+    // Line slot holds slots slot * LINE_KEYS onwards; clamped so the address stays inside the array
+    __builtin_prefetch(nodes_.data() + std::min(slot, nodes_.size() - 1));
+}
+
+template <typename T>
+size_t EytzingerIndex<T>::findSlot(const T& key) const {
+    size_t slot = 1;
+    while (slot <= size_) {
+        prefetchDescendants(slot);
+        slot = 2 * slot + (at(slot) < key);
+    }
+    // The path bits after the last left turn are all ones; dropping them and that turn gives its slot
+    return slot >> (std::countr_one(slot) + 1);
+}
+
+template <typename T>
+size_t EytzingerIndex<T>::lowerBound(const T& key) const {
+    size_t slot = findSlot(key);
+    return slot ? ranks_[slot] : size_;
+}
+
+template <typename T>
+bool EytzingerIndex<T>::contains(const T& key) const {
+    size_t slot = findSlot(key);
+    return slot && !(key < at(slot));
+}
+
+template <typename T>
+template <typename Emit>
+void EytzingerIndex<T>::walkBatch(const T* keys, size_t count, Emit emit) const {
+    // Every search ends after at most bit_width(size) steps; finished ones keep their slot
+    const int depth = std::bit_width(size_);
+    size_t slots[SearchIndex<T>::BATCH_GROUP];
+    for (size_t base = 0; base < count; base += SearchIndex<T>::BATCH_GROUP) {
+        size_t group = std::min(SearchIndex<T>::BATCH_GROUP, count - base);
+        std::fill(slots, slots + group, size_t(1));
+        for (int level = 0; level < depth; ++level) {
+            for (size_t i = 0; i < group; ++i) {
+                size_t slot = slots[i];
+                bool inside = slot <= size_;
+                // Slot 0 is a valid dummy read for searches that already left the tree
+                size_t next = 2 * slot + (at(inside ? slot : 0) < keys[base + i]);
+                slots[i] = inside ? next : slot;
+                prefetchDescendants(slots[i]);
+            }
+        }
+        for (size_t i = 0; i < group; ++i) {
+            emit(base + i, slots[i] >> (std::countr_one(slots[i]) + 1));
+        }
+    }
+}
+
+template <typename T>
+void EytzingerIndex<T>::lowerBound(const T* keys, size_t count, size_t* positions) const {
+    walkBatch(keys, count, [&](size_t query, size_t slot) { positions[query] = slot ? ranks_[slot] : size_; });
+}
+
+template <typename T>
+void EytzingerIndex<T>::contains(const T* keys, size_t count, bool* found) const {
+    walkBatch(keys, count, [&](size_t query, size_t slot) { found[query] = slot && !(keys[query] < at(slot)); });
+}
+
+template <typename T>
+StaticBTree<T>::StaticBTree(const std::vector<T>& sorted) : size_(sorted.size()) {
+    requireSorted(sorted);
+    constexpr T PADDING = std::numeric_limits<T>::max();
+
+    // Layer sizes bottom-up, then laid out root first
+    std::vector<size_t> layerSizes = {std::max<size_t>(1, (size_ + LINE_KEYS - 1) / LINE_KEYS)};
+    while (layerSizes.back() > 1) {
+        layerSizes.push_back((layerSizes.back() + FANOUT - 1) / FANOUT);
+    }
+    size_t offset = 0;
+    for (auto it = layerSizes.rbegin(); it != layerSizes.rend(); ++it) {
+        layerOffsets_.push_back(offset);
+        offset += *it;
+    }
+    nodes_.resize(offset);
+    leafOffset_ = layerOffsets_.back();
+
+    size_t leaves = layerSizes.front();
+    for (size_t position = 0; position < leaves * LINE_KEYS; ++position) {
+        nodes_[leafOffset_ + position / LINE_KEYS].keys[position % LINE_KEYS] =
+            position < size_ ? sorted[position] : PADDING;
+    }
+
+    // Separator j of a node is the largest key under child j. The last child of a
+    // layer gets the padding key instead, so keys above every stored one still
+    // descend into existing nodes and end up past the last position.
+    size_t leavesPerChild = 1;
+    for (size_t height = 1; height < layerSizes.size(); ++height) {
+        size_t children = layerSizes[height - 1];
+        size_t layerOffset = layerOffsets_[layerSizes.size() - 1 - height];
+        for (size_t node = 0; node < layerSizes[height]; ++node) {
+            for (size_t j = 0; j < LINE_KEYS; ++j) {
+                size_t child = node * FANOUT + j;
+                T separator = PADDING;
+                if (child + 1 < children) {
+                    size_t lastLeaf = std::min((child + 1) * leavesPerChild, leaves) - 1;
+                    separator = nodes_[leafOffset_ + lastLeaf].keys[LINE_KEYS - 1];
+                }
+                nodes_[layerOffset + node].keys[j] = separator;
+            }
+        }
+        leavesPerChild *= FANOUT;
+    }
+}
+
+template <typename T>
+size_t StaticBTree<T>::lowerBound(const T& key) const {
+    size_t node = 0;
+    for (size_t layer = 0; layer + 1 < layerOffsets_.size(); ++layer) {
+        node = node * FANOUT + countLess(nodes_[layerOffsets_[layer] + node], key);
+    }
+    return std::min(node * LINE_KEYS + countLess(nodes_[leafOffset_ + node], key), size_);
+}
+
+template <typename T>
+bool StaticBTree<T>::contains(const T& key) const {
+    size_t position = lowerBound(key);
+    return position < size_ && !(key < keyAt(position));
+}
+
+template <typename T>
+template <typename Emit>
+void StaticBTree<T>::walkBatch(const T* keys, size_t count, Emit emit) const {
+    // All leaves are equally deep, so the group descends one layer at a time
+    size_t nodes[SearchIndex<T>::BATCH_GROUP];
+    for (size_t base = 0; base < count; base += SearchIndex<T>::BATCH_GROUP) {
+        size_t group = std::min(SearchIndex<T>::BATCH_GROUP, count - base);
+        std::fill(nodes, nodes + group, size_t(0));
+        for (size_t layer = 0; layer + 1 < layerOffsets_.size(); ++layer) {
+            const CacheLineNode<T>* level = nodes_.data() + layerOffsets_[layer];
+            const CacheLineNode<T>* below = nodes_.data() + layerOffsets_[layer + 1];
+            for (size_t i = 0; i < group; ++i) {
+                nodes[i] = nodes[i] * FANOUT + countLess(level[nodes[i]], keys[base + i]);
+                __builtin_prefetch(below + nodes[i]);
+            }
+        }
+        for (size_t i = 0; i < group; ++i) {
+            emit(base + i, nodes[i] * LINE_KEYS + countLess(nodes_[leafOffset_ + nodes[i]], keys[base + i]));
+        }
+    }
+}
+
+template <typename T>
+void StaticBTree<T>::lowerBound(const T* keys, size_t count, size_t* positions) const {
+    walkBatch(keys, count, [&](size_t query, size_t position) { positions[query] = std::min(position, size_); });
+}
+
+template <typename T>
+void StaticBTree<T>::contains(const T* keys, size_t count, bool* found) const {
+    walkBatch(keys, count, [&](size_t query, size_t position) {
+        found[query] = position < size_ && !(keys[query] < keyAt(position));
+    });
+}
+
+std::vector<std::string> searchIndexNames() {
+    return {"binary", "eytzinger", "btree"};
+}
+
+template <typename T>
+std::unique_ptr<SearchIndex<T>> makeSearchIndex(const std::string& name, const std::vector<T>& sorted) {
+    if (name == "binary") {
+        return std::make_unique<BinarySearchIndex<T>>(sorted);
+    }
+    if (name == "eytzinger") {
+        return std::make_unique<EytzingerIndex<T>>(sorted);
+    }
+    if (name == "btree") {
+        return std::make_unique<StaticBTree<T>>(sorted);
+    }
+    throw std::invalid_argument("Unknown search index: " + name);
+}
+
+template class BinarySearchIndex<int>;
+template class BinarySearchIndex<int64_t>;
+template class EytzingerIndex<int>;
+template class EytzingerIndex<int64_t>;
+template class StaticBTree<int>;
+template class StaticBTree<int64_t>;
+template std::unique_ptr<SearchIndex<int>> makeSearchIndex<int>(const std::string& name, const std::vector<int>& sorted);
+template std::unique_ptr<SearchIndex<int64_t>> makeSearchIndex<int64_t>(const std::string& name,
+                                                                        const std::vector<int64_t>& sorted);
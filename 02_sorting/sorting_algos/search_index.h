@@ -0,0 +1,147 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#ifndef ALGORITHMS_PROGRAMMING_EXERCISES_SEARCH_INDEX_H
+#define ALGORITHMS_PROGRAMMING_EXERCISES_SEARCH_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Read-only index over sorted keys answering lower-bound and membership
+// queries. Positions always refer to the sorted input the index was built from.
+template <typename T>
+class SearchIndex {
+public:
+    // Queries of a batch walk the layout in lockstep groups of this size, so
+    // their cache misses overlap instead of being paid one after the other
+    static constexpr size_t BATCH_GROUP = 16;
+
+    virtual ~SearchIndex() = default;
+
+    // Position of the first key not less than key; size() if there is none
+    virtual size_t lowerBound(const T& key) const = 0;
+    virtual bool contains(const T& key) const = 0;
+
+    // Batched forms: positions / found receive one entry per query
+    virtual void lowerBound(const T* keys, size_t count, size_t* positions) const = 0;
+    virtual void contains(const T* keys, size_t count, bool* found) const = 0;
+
+    virtual size_t size() const = 0;
+    virtual std::string getName() const = 0;
+};
+
+// Baseline: std::lower_bound over a copy of the sorted keys; batches are plain loops
+template <typename T>
+class BinarySearchIndex : public SearchIndex<T> {
+public:
+    explicit BinarySearchIndex(const std::vector<T>& sorted) : keys_(sorted) {}
+
+    size_t lowerBound(const T& key) const override;
+    bool contains(const T& key) const override;
+    void lowerBound(const T* keys, size_t count, size_t* positions) const override;
+    void contains(const T* keys, size_t count, bool* found) const override;
+
+    size_t size() const override { return keys_.size(); }
+    std::string getName() const override { return "Binary Search"; }
+
+private:
+    std::vector<T> keys_;
+};
+
+// Keys of one cache line; node i of a layout occupies exactly line i
+template <typename T>
+struct alignas(64) CacheLineNode {
+    static constexpr size_t KEYS = 64 / sizeof(T);
+    T keys[KEYS];
+};
+
+// Eytzinger (BFS) layout: the implicit binary search tree is stored level by
+// level, so the first levels of every search share a few hot cache lines, and
+// the 64 / sizeof(T) descendants four levels (for int) below slot k sit
+// together in line k, which is prefetched while the next levels are compared.
+// Sorted positions are recovered from a 32-bit rank per slot.
+template <typename T>
+class EytzingerIndex : public SearchIndex<T> {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "The search layouts copy keys into cache lines");
+    static constexpr size_t LINE_KEYS = CacheLineNode<T>::KEYS;
+
+    // Throws std::invalid_argument if sorted is not sorted and
+    // std::length_error if its positions do not fit 32 bits
+    explicit EytzingerIndex(const std::vector<T>& sorted);
+
+    size_t lowerBound(const T& key) const override;
+    bool contains(const T& key) const override;
+    void lowerBound(const T* keys, size_t count, size_t* positions) const override;
+    void contains(const T* keys, size_t count, bool* found) const override;
+
+    size_t size() const override { return size_; }
+    std::string getName() const override { return "Eytzinger"; }
+
+private:
+    // Slot holding the lower bound of key, 0 if every key is smaller
+    size_t findSlot(const T& key) const;
+    // Calls emit(query, slot) for every query, walking BATCH_GROUP queries at a time
+    template <typename Emit>
+    void walkBatch(const T* keys, size_t count, Emit emit) const;
+
+    const T& at(size_t slot) const { return nodes_[slot / LINE_KEYS].keys[slot % LINE_KEYS]; }
+    void prefetchDescendants(size_t slot) const;
+
+    size_t size_;
+    std::vector<CacheLineNode<T>> nodes_;  // slot k at nodes_[k / LINE_KEYS]; slot 0 unused
+    std::vector<uint32_t> ranks_;          // sorted position of every slot
+};
+
+// Static B+-tree (S+-tree) with one cache line per node: the leaves are the
+// sorted keys in line-sized blocks (padded with the largest key), and every
+// inner node stores the largest key of each of its first LINE_KEYS children,
+// having LINE_KEYS + 1 of them. A lookup touches one line per level and
+// picks the child by counting smaller keys, a loop the compiler vectorises.
+template <typename T>
+class StaticBTree : public SearchIndex<T> {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "The search layouts copy keys into cache lines");
+    static constexpr size_t LINE_KEYS = CacheLineNode<T>::KEYS;
+    static constexpr size_t FANOUT = LINE_KEYS + 1;
+
+    // Throws std::invalid_argument if sorted is not sorted
+    explicit StaticBTree(const std::vector<T>& sorted);
+
+    size_t lowerBound(const T& key) const override;
+    bool contains(const T& key) const override;
+    void lowerBound(const T* keys, size_t count, size_t* positions) const override;
+    void contains(const T* keys, size_t count, bool* found) const override;
+
+    size_t size() const override { return size_; }
+    std::string getName() const override { return "Static B+-tree"; }
+
+private:
+    // Calls emit(query, position) for every query, with position possibly in the padding
+    template <typename Emit>
+    void walkBatch(const T* keys, size_t count, Emit emit) const;
+
+    const T& keyAt(size_t position) const {
+        return nodes_[leafOffset_ + position / LINE_KEYS].keys[position % LINE_KEYS];
+    }
+
+    size_t size_;
+    std::vector<CacheLineNode<T>> nodes_;  // layers from the root down, leaves last
+    std::vector<size_t> layerOffsets_;     // first node of every layer, root first
+    size_t leafOffset_ = 0;
+};
+
+// Names accepted by makeSearchIndex, in registration order
+std::vector<std::string> searchIndexNames();
+
+// Builds the index registered under name over the sorted keys.
+// Throws std::invalid_argument for unknown names.
+template <typename T>
+std::unique_ptr<SearchIndex<T>> makeSearchIndex(const std::string& name, const std::vector<T>& sorted);
+
+#endif //ALGORITHMS_PROGRAMMING_EXERCISES_SEARCH_INDEX_H
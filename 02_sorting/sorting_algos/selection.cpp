@@ -0,0 +1,232 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "sort_algorithms.h"
+#include "block_partition.h"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define SELECTION_HAS_AVX2 1
+#endif
+
+namespace {
+    // Places every rank of [rankFirst, rankLast) (ascending, relative to base) within
+    // [from, to): the middle rank splits the range, each half takes its own ranks.
+    template <typename T>
+    void multiSelect(T* base, size_t from, size_t to, const size_t* rankFirst, const size_t* rankLast) {
+        while (rankFirst != rankLast) {
+            const size_t* middle = rankFirst + (rankLast - rankFirst) / 2;
+            Selection<T>::nthElement(base + from, base + *middle, base + to);
+            multiSelect(base, from, *middle, rankFirst, middle);
+            from = *middle + 1;
+            rankFirst = middle + 1;
+        }
+    }
+
+#ifdef SELECTION_HAS_AVX2
+    // For every 8-bit lane mask, the permutation that moves the selected lanes to the front
+    struct CompressTable {
+        alignas(32) int lanes[256][8] = {};
+
+        CompressTable() {
+            for (unsigned int mask = 0; mask < 256; ++mask) {
+                int count = 0;
+                for (int lane = 0; lane < 8; ++lane) {
+                    if (mask >> lane & 1) {
+                        lanes[mask][count++] = lane;
+                    }
+                }
+            }
+        }
+    };
+
+    const CompressTable& compressTable() {
+        static const CompressTable table;
+        return table;
+    }
+
+    // Compares eight lanes against the bound, then packs the lanes below it to the
+    // front of the register with one permute and stores all eight. Only the packed
+    // lanes count, the rest is overwritten by the next store. The store never runs
+    // ahead of the loads, so filtering in place is safe.
+    __attribute__((target("avx2"))) size_t filterBelowAvx2(const int* in, size_t n, int bound, int* out) {
+        const CompressTable& table = compressTable();
+        const __m256i limit = _mm256_set1_epi32(bound);
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            __m256i below = _mm256_cmpgt_epi32(limit, values);
+            auto mask = static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(below)));
+            __m256i permutation = _mm256_load_si256(reinterpret_cast<const __m256i*>(table.lanes[mask]));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + count),
+                                _mm256_permutevar8x32_epi32(values, permutation));
+            count += std::popcount(mask);
+        }
+        for (; i < n; ++i) {
+            out[count] = in[i];
+            count += in[i] < bound;
+        }
+        return count;
+    }
+#endif
+}
+
+template <typename T>
+void Selection<T>::nthElement(T* first, T* nth, T* last) {
+    if (nth >= last || last - first < 2) {
+        return;
+    }
+    T* begin = first;
+    T* end = last;
+    int badAllowed = std::bit_width(static_cast<size_t>(last - first));
+    bool leftmost = true;
+
+    while (static_cast<size_t>(end - begin) >= INSERTION_THRESHOLD) {
+        size_t size = end - begin;
+        BlockPartition::choosePivot(begin, end);
+
+        // Same equal-key shortcut as PdqSort: keys equal to the previous pivot are final
+        if (!leftmost && !(*(begin - 1) < *begin)) {
+            begin = BlockPartition::partitionLeft(begin, end) + 1;
+            if (nth < begin) {
+                return;
+            }
+            continue;
+        }
+
+        T* pivotPos = BlockPartition::partitionRight(begin, end).first;
+        if (pivotPos == nth) {
+            return;
+        }
+
+        size_t leftSize = pivotPos - begin;
+        size_t rightSize = end - (pivotPos + 1);
+        bool highlyUnbalanced = leftSize < size / 8 || rightSize < size / 8;
+
+        if (nth < pivotPos) {
+            end = pivotPos;
+        } else {
+            begin = pivotPos + 1;
+            leftmost = false;
+        }
+
+        // Too many bad pivots: a full sort of what is left bounds the cost by O(n log n)
+        if (highlyUnbalanced && --badAllowed == 0) {
+            PdqSort<T>().sortRange(begin, end);
+            return;
+        }
+    }
+    InsertionSort<T>::sortRange(begin, end);
+}
+
+template <typename T>
+void Selection<T>::partialSort(T* first, T* middle, T* last) {
+    if (middle == first) {
+        return;
+    }
+    nthElement(first, middle - 1, last);
+    PdqSort<T>().sortRange(first, middle - 1);
+}
+
+template <typename T>
+std::vector<T> Selection<T>::quantiles(std::vector<T>& data, const std::vector<double>& qs) {
+    if (data.empty()) {
+        throw std::invalid_argument("Quantiles of an empty input");
+    }
+    std::vector<size_t> ranks;
+    ranks.reserve(qs.size());
+    for (double q : qs) {
+        if (!(q >= 0.0 && q <= 1.0)) {
+            throw std::invalid_argument("Quantile " + std::to_string(q) + " is outside [0, 1]");
+        }
+        ranks.push_back(static_cast<size_t>(q * static_cast<double>(data.size() - 1)));
+    }
+
+    std::vector<size_t> distinct = ranks;
+    std::sort(distinct.begin(), distinct.end());
+    distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+    multiSelect(data.data(), 0, data.size(), distinct.data(), distinct.data() + distinct.size());
+
+    std::vector<T> values;
+    values.reserve(ranks.size());
+    for (size_t rank : ranks) {
+        values.push_back(data[rank]);
+    }
+    return values;
+}
+
+template <typename T>
+size_t Selection<T>::filterBelow(const T* in, size_t n, const T& bound, T* out) {
+    // Branch-free: every value is copied, only those below the bound advance the output
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        out[count] = in[i];
+        count += in[i] < bound;
+    }
+    return count;
+}
+
+template <>
+size_t Selection<int>::filterBelow(const int* in, size_t n, const int& bound, int* out) {
+#ifdef SELECTION_HAS_AVX2
+    // Uses the same run-time AVX2 check as the sorting network kernels
+    if (SortingNetwork::usesAvx2()) {
+        return filterBelowAvx2(in, n, bound, out);
+    }
+#endif
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        out[count] = in[i];
+        count += in[i] < bound;
+    }
+    return count;
+}
+
+template <typename T>
+TopK<T>::TopK(size_t k) : k_(k), buffer_(k ? 2 * k + FILTER_BATCH : 0) {}
+
+template <typename T>
+void TopK<T>::push(const T* values, size_t count) {
+    if (k_ == 0) {
+        return;
+    }
+    for (size_t offset = 0; offset < count; offset += FILTER_BATCH) {
+        size_t batch = std::min(FILTER_BATCH, count - offset);
+        if (bounded_) {
+            filled_ += Selection<T>::filterBelow(values + offset, batch, bound_, buffer_.data() + filled_);
+        } else {
+            std::copy(values + offset, values + offset + batch, buffer_.data() + filled_);
+            filled_ += batch;
+        }
+        if (filled_ >= 2 * k_) {
+            shrink();
+        }
+    }
+}
+
+template <typename T>
+void TopK<T>::shrink() {
+    Selection<T>::nthElement(buffer_.data(), buffer_.data() + (k_ - 1), buffer_.data() + filled_);
+    filled_ = k_;
+    bound_ = buffer_[k_ - 1];
+    bounded_ = true;
+}
+
+template <typename T>
+std::vector<T> TopK<T>::result() const {
+    std::vector<T> values(buffer_.begin(), buffer_.begin() + filled_);
+    size_t keep = std::min(k_, filled_);
+    Selection<T>::partialSort(values.data(), values.data() + keep, values.data() + values.size());
+    values.resize(keep);
+    return values;
+}
+
+#define INSTANTIATE_SELECTION_KEY(K) \
+    template class Selection<K>; \
+    template class TopK<K>;
+SORT_KEY_TYPES(INSTANTIATE_SELECTION_KEY)
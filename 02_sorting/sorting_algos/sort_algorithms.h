@@ -5,41 +5,554 @@
 #ifndef ALGORITHMS_PROGRAMMING_EXERCISES_SORT_ALGORITHMS_H
 #define ALGORITHMS_PROGRAMMING_EXERCISES_SORT_ALGORITHMS_H
 
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 #include <fstream>
 #include <string>
 #include <vector>
 #include <memory>
+#include <memory_resource>
+#include <bit>
 #include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <thread>
+
+#include "memory_stats.h"
+#include "perf_counters.h"
+#include "record.h"
+#include "scratch_arena.h"
+#include "sorting_network.h"
+#include "thread_pool.h"
 
 template <typename T>
 class SortStrategy {
 public:
     virtual ~SortStrategy() = default;
     virtual void sort(std::vector<T>& arr) = 0;
+    // Same, for callers that sort repeatedly: scratch memory comes from the given
+    // resource (normally a ScratchArena they keep), so it is reused across calls
+    // instead of allocated every time. Strategies without scratch keep this default.
+    virtual void sort(std::vector<T>& arr, std::pmr::memory_resource&) { sort(arr); }
+    // Same for values that live in a memory resource themselves, so a caller can keep
+    // its whole working set there (IndirectSort's key pairs). The strategies only need
+    // the element range and override this; the default takes a detour through a std::vector.
+    virtual void sort(std::pmr::vector<T>& arr, std::pmr::memory_resource& scratch);
     virtual std::string getName() const = 0;
 };
 
+template <typename T>
+void SortStrategy<T>::sort(std::pmr::vector<T>& arr, std::pmr::memory_resource& scratch) {
+    std::vector<T> values(std::make_move_iterator(arr.begin()), std::make_move_iterator(arr.end()));
+    sort(values, scratch);
+    std::move(values.begin(), values.end(), arr.begin());
+}
+
 template <typename T>
 class InsertionSort : public SortStrategy<T> {
 public:
     void sort(std::vector<T>& arr) override;
+    void sort(std::pmr::vector<T>& arr, std::pmr::memory_resource&) override {
+        sortRange(arr.data(), arr.data() + arr.size());
+    }
     std::string getName() const override { return "Insertion Sort"; }
+
+    // Range kernel used by the recursive strategies for their small partitions
+    static void sortRange(T* first, T* last);
+
+    // Same as sortRange, but gives up once more than moveLimit elements have been shifted.
+    // Returns true if [first, last) ended up sorted.
+    static bool partialSortRange(T* first, T* last, size_t moveLimit);
+};
+
+// Base-case kernel for small ranges used by the recursive strategies:
+// the insertion kernel in general, the vectorised sorting network for int.
+template <typename T>
+struct SmallSortKernel {
+    static constexpr size_t MAX_SIZE = 32;
+    static void sortRange(T* first, T* last) { InsertionSort<T>::sortRange(first, last); }
+};
+
+template <>
+struct SmallSortKernel<int> {
+    static constexpr size_t MAX_SIZE = SortingNetwork::MAX_BLOCK;
+    static void sortRange(int* first, int* last) { SortingNetwork::sortRange(first, last); }
+};
+
+// Sorts fixed-size blocks with SmallSortKernel, then merges the sorted blocks
+// bottom-up, ping-ponging between the input and one scratch buffer.
+template <typename T>
+class NetworkMergeSort : public SortStrategy<T> {
+public:
+    static constexpr size_t BLOCK_SIZE = SmallSortKernel<T>::MAX_SIZE;
+
+    void sort(std::vector<T>& arr) override { sort(arr, *std::pmr::get_default_resource()); }
+    void sort(std::vector<T>& arr, std::pmr::memory_resource& scratch) override {
+        sortValues(arr.data(), arr.size(), scratch);
+    }
+    void sort(std::pmr::vector<T>& arr, std::pmr::memory_resource& scratch) override {
+        sortValues(arr.data(), arr.size(), scratch);
+    }
+    std::string getName() const override { return "Sorting Network Merge Sort"; }
+
+private:
+    void sortValues(T* values, size_t n, std::pmr::memory_resource& scratch);
+};
+
+// Top-down merge sort whose halves are forked onto a work-stealing pool.
+// Ranges at or below the cutoff are sorted by the sequential kernel; large
+// merges are split by binary search so the final levels run in parallel too.
+template <typename T>
+class ParallelMergeSort : public SortStrategy<T> {
+public:
+    static constexpr size_t DEFAULT_CUTOFF = 1 << 14;
+
+    explicit ParallelMergeSort(unsigned int threadCount = std::thread::hardware_concurrency(),
+                               size_t cutoff = DEFAULT_CUTOFF);
+
+    void sort(std::vector<T>& arr) override { sort(arr, *std::pmr::get_default_resource()); }
+    void sort(std::vector<T>& arr, std::pmr::memory_resource& scratch) override {
+        sortValues(arr.data(), arr.size(), scratch);
+    }
+    void sort(std::pmr::vector<T>& arr, std::pmr::memory_resource& scratch) override {
+        sortValues(arr.data(), arr.size(), scratch);
+    }
+    std::string getName() const override;
+
+private:
+    void sortValues(T* values, size_t n, std::pmr::memory_resource& scratch);
+    // Sorts src[0..n); the result ends up in src when resultInSrc is set, in dst otherwise.
+    // The other buffer is used as scratch. Without a pool everything runs on the calling thread.
+    void sortInto(WorkStealingPool* pool, T* src, T* dst, size_t n, bool resultInSrc);
+    void sequentialSortInto(T* src, T* dst, size_t n, bool resultInSrc);
+    void mergeInto(WorkStealingPool* pool, T* left, size_t leftSize, T* right, size_t rightSize, T* out);
+
+    unsigned int threadCount_;
+    size_t cutoff_;
+};
+
+// Pattern-defeating quicksort (pdqsort): median-of-3 / ninther pivots,
+// branchless block partitioning, detection of already partitioned and
+// equal-key ranges, and a heapsort fallback once too many unbalanced
+// partitions were seen. Partitions below the threshold go to InsertionSort
+// (or to the SmallSortKernel when requested).
+template <typename T>
+class PdqSort : public SortStrategy<T> {
+public:
+    static constexpr size_t DEFAULT_THRESHOLD = 24;
+
+    // With useSmallSortKernel, partitions below the threshold go to SmallSortKernel
+    // instead (the threshold is then capped at its MAX_SIZE)
+    explicit PdqSort(size_t insertionThreshold = DEFAULT_THRESHOLD, bool useSmallSortKernel = false);
+
+    void sort(std::vector<T>& arr) override;
+    void sort(std::pmr::vector<T>& arr, std::pmr::memory_resource&) override {
+        sortRange(arr.data(), arr.data() + arr.size());
+    }
+    std::string getName() const override;
+
+    // Sorts [first, last) in place; exposed so other strategies can reuse it as a kernel
+    void sortRange(T* first, T* last) const;
+
+private:
+    void sortLoop(T* begin, T* end, int badAllowed, bool leftmost) const;
+
+    size_t insertionThreshold_;
+    bool useSmallSortKernel_;
+};
+
+// Adaptive, stable merge sort in the style of TimSort: natural ascending
+// runs (and strictly descending ones, reversed in place) are detected,
+// runs shorter than the minimum run length are extended by InsertionSort,
+// and the run stack is merged under the length invariants with galloping
+// once one run keeps winning. Presorted inputs run in close to O(n).
+template <typename T>
+class TimSort : public SortStrategy<T> {
+public:
+    // Inputs below this size are a single insertion-sorted run
+    static constexpr size_t MIN_MERGE = 32;
+    // Consecutive wins of one run after which a merge switches to galloping
+    static constexpr size_t MIN_GALLOP = 7;
+
+    void sort(std::vector<T>& arr) override { sort(arr, *std::pmr::get_default_resource()); }
+    void sort(std::vector<T>& arr, std::pmr::memory_resource& scratch) override {
+        sortValues(arr.data(), arr.size(), scratch);
+    }
+    void sort(std::pmr::vector<T>& arr, std::pmr::memory_resource& scratch) override {
+        sortValues(arr.data(), arr.size(), scratch);
+    }
+    std::string getName() const override { return "TimSort"; }
+
+private:
+    void sortValues(T* values, size_t n, std::pmr::memory_resource& scratch);
+};
+
+// Unsigned key type and digit count for a key width in bytes.
+// Only the 32- and 64-bit widths are specialised.
+template <size_t Bytes>
+struct RadixKeyTraits;
+
+template <>
+struct RadixKeyTraits<4> {
+    using type = uint32_t;
+    static constexpr size_t passes = 4;
+};
+
+template <>
+struct RadixKeyTraits<8> {
+    using type = uint64_t;
+    static constexpr size_t passes = 8;
+};
+
+// Byte-wise radix sort for integer and floating-point keys. Ranges that fit
+// in cache are sorted LSD: all digit histograms are built in one read pass,
+// digits that are constant across the range are skipped, and the scatter
+// passes ping-pong between the range and the scratch buffer. Larger ranges
+// are first split MSD on their highest varying byte, so the remaining passes
+// run on cache-resident buckets instead of streaming the whole input once per
+// byte. Floating-point keys are ordered like IEEE 754 totalOrder:
+// -NaN < -inf < ... < -0.0 < +0.0 < ... < +inf < +NaN.
+template <typename T>
+class RadixSort : public SortStrategy<T> {
+    static_assert(std::is_arithmetic_v<T> && (sizeof(T) == 4 || sizeof(T) == 8),
+                  "RadixSort supports 32- and 64-bit integer and floating-point keys");
+
+public:
+    using Key = typename RadixKeyTraits<sizeof(T)>::type;
+    static constexpr size_t PASSES = RadixKeyTraits<sizeof(T)>::passes;
+    static constexpr size_t RADIX = 256;
+    // Ranges up to this size (2 MiB of keys, about the L2 / L3 boundary) are LSD sorted
+    static constexpr size_t LSD_THRESHOLD = (1 << 21) / sizeof(T);
+    // Buckets below this size are insertion sorted on their keys
+    static constexpr size_t INSERTION_THRESHOLD = 64;
+
+    void sort(std::vector<T>& arr) override { sort(arr, *std::pmr::get_default_resource()); }
+    void sort(std::vector<T>& arr, std::pmr::memory_resource& scratch) override {
+        sortValues(arr.data(), arr.size(), scratch);
+    }
+    void sort(std::pmr::vector<T>& arr, std::pmr::memory_resource& scratch) override {
+        sortValues(arr.data(), arr.size(), scratch);
+    }
+    std::string getName() const override { return "Radix Sort"; }
+
+    // Maps a key to an unsigned value with the same ordering. Signed integers get
+    // their sign bit flipped. Floats are sign-magnitude: positive ones get the sign
+    // bit set, negative ones have every bit inverted so larger magnitudes sort first.
+    static Key toKey(T value) {
+        constexpr Key SIGN_BIT = Key(1) << (sizeof(T) * 8 - 1);
+        if constexpr (std::is_floating_point_v<T>) {
+            Key bits = std::bit_cast<Key>(value);
+            return (bits & SIGN_BIT) ? ~bits : bits | SIGN_BIT;
+        } else {
+            Key key = static_cast<Key>(value);
+            if constexpr (std::is_signed_v<T>) {
+                key ^= SIGN_BIT;
+            }
+            return key;
+        }
+    }
+
+private:
+    void sortValues(T* values, size_t n, std::pmr::memory_resource& scratch);
+    // Sorts src[0, n) on its low passes bytes (the higher ones are equal across the
+    // range); the result ends up in src when resultInSrc is set, in dst otherwise.
+    // The other buffer is used as scratch.
+    static void sortInto(T* src, T* dst, size_t n, size_t passes, bool resultInSrc);
+    static void lsdSortInto(T* src, T* dst, size_t n, size_t passes, bool resultInSrc);
+};
+
+// Sorts values through their keys: (key, index) pairs packed into 64-bit
+// words are sorted by the key strategy, index breaking ties so the result is
+// stable, then the values are permuted in one prefetched gather pass. A large
+// record is thus moved once instead of on every swap or merge step.
+template <typename T>
+class IndirectSort : public SortStrategy<T> {
+public:
+    using Key = typename KeyProjection<T>::Key;
+    static_assert(std::is_integral_v<Key> && sizeof(Key) == 4, "IndirectSort packs 32-bit keys");
+
+    // Positions ahead of the gather whose source record is prefetched
+    static constexpr size_t PREFETCH_DISTANCE = 16;
+
+    explicit IndirectSort(std::unique_ptr<SortStrategy<uint64_t>> keyStrategy) : keyStrategy_(std::move(keyStrategy)) {}
+
+    // Throw std::length_error for inputs whose indices do not fit 32 bits. The values are
+    // gathered into a second vector that is swapped with arr (permuting in place would chase
+    // one cache miss after another). The first gathers into a new vector. The second takes
+    // the pairs and the key strategy's scratch from scratch, and gathers into the buffer arr
+    // had on the previous call, so repeated sorts alternate between two warm buffers.
+    void sort(std::vector<T>& arr) override;
+    void sort(std::vector<T>& arr, std::pmr::memory_resource& scratch) override;
+    std::string getName() const override { return keyStrategy_->getName() + " (indirect)"; }
+
+private:
+    // (key, index) pairs in sorted order
+    std::pmr::vector<uint64_t> sortedPairs(const std::vector<T>& arr, std::pmr::memory_resource& scratch);
+    // Replaces the contents of out with the values of arr in pair order
+    void gather(std::vector<T>& arr, const std::pmr::vector<uint64_t>& pairs, std::vector<T>& out);
+
+    std::unique_ptr<SortStrategy<uint64_t>> keyStrategy_;
+    // Buffer of the previous arena sort's input, reused for the next gather
+    std::vector<T> spare_;
+};
+
+// Order statistics without a full sort. nthElement is an introselect over
+// the branchless block partition of PdqSort: only the side holding the
+// wanted rank is partitioned further, and a range that keeps producing
+// unbalanced partitions is finished by PdqSort instead.
+template <typename T>
+class Selection {
+public:
+    // Ranges below this size are finished by InsertionSort
+    static constexpr size_t INSERTION_THRESHOLD = 24;
+
+    // Reorders [first, last) so that *nth holds the element a full sort would put
+    // there, nothing before it is greater and nothing after it is smaller
+    static void nthElement(T* first, T* nth, T* last);
+
+    // Moves the middle - first smallest elements to [first, middle) in sorted
+    // order; the rest is left in unspecified order
+    static void partialSort(T* first, T* middle, T* last);
+
+    // Values at the given quantiles (each in [0, 1], rank floor(q * (n - 1))), in
+    // the order asked for. All ranks are placed by one recursive multi-selection,
+    // so q quantiles cost O(n log q) instead of q separate selections.
+    // Throws std::invalid_argument for an empty input or a quantile outside [0, 1].
+    static std::vector<T> quantiles(std::vector<T>& data, const std::vector<double>& qs);
+
+    // Copies the values of [in, in + n) that are smaller than bound to out, keeping
+    // their order, and returns how many were copied. out may equal in. For int the
+    // comparison and compaction run eight lanes at a time with AVX2 when available.
+    static size_t filterBelow(const T* in, size_t n, const T& bound, T* out);
 };
 
+// The k smallest values of a stream in O(k) memory (buffered quickselect).
+// Values below the current bound are filtered into a buffer of 2k; a full
+// buffer is cut back to its k smallest with Selection::nthElement, and the
+// k-th smallest becomes the new, tighter bound.
+template <typename T>
+class TopK {
+public:
+    // Values filtered per step; the buffer holds 2k plus one batch
+    static constexpr size_t FILTER_BATCH = 1024;
+
+    explicit TopK(size_t k);
+
+    void push(const T* values, size_t count);
+    void push(const std::vector<T>& values) { push(values.data(), values.size()); }
+
+    // The k smallest values seen so far (fewer if the stream was shorter), ascending
+    std::vector<T> result() const;
+
+private:
+    void shrink();
+
+    size_t k_;
+    std::vector<T> buffer_;
+    size_t filled_ = 0;
+    bool bounded_ = false;  // set once k values were seen; bound_ is then the k-th smallest
+    T bound_{};
+};
+
+// Command-line selectable configuration for the strategy factory
+struct SortOptions {
+    std::string algorithm = "insertion";
+    bool indirect = false;  // wrap the strategy in IndirectSort
+    unsigned int threads = std::thread::hardware_concurrency();
+    size_t cutoff = 0;  // 0 keeps the strategy's default
+};
+
+// Names accepted by makeSortStrategy, in registration order
+std::vector<std::string> sortStrategyNames();
+
+// Builds the strategy registered under options.algorithm.
+// Throws std::invalid_argument for unknown names and for combinations the
+// type does not support (radix on records, indirect mode on 64-bit keys).
+template <typename T>
+std::unique_ptr<SortStrategy<T>> makeSortStrategy(const SortOptions& options);
+
+// Wall time of each executor phase in seconds. In the pipelined mode the
+// phases overlap: parse and write only count the time the sorting thread
+// waited for the reader or the writer, so parse + sort + write == total.
+struct PhaseTimings {
+    double parse = 0.0;
+    double sort = 0.0;
+    double write = 0.0;
+    double total = 0.0;
+};
+
+// Memory used by one executor phase. Overlapping phases (the pipelined
+// mode) are measured as a single "pipeline" phase.
+struct PhaseMemory {
+    std::string phase;
+    MemoryUsage usage;
+};
+
+// Outcome of one executor run
+struct SortReport {
+    std::string inputFilename;
+    std::string sortedFilename;  // empty when the sorted data was not written
+    std::string algorithm;
+    size_t size = 0;
+    PhaseTimings timings;
+    PerfCounts counters;
+    std::string countersUnavailable;  // why no counter could be opened, empty otherwise
+    std::vector<PhaseMemory> memory;  // in phase order
+    std::string error;                // empty on success
+};
+
+// Prints the timings, counters and memory of a successful run
+void printSortReport(const SortReport& report);
+
+// Appends the results line of a run to outputFilename
+void appendSortReport(const SortReport& report, const std::string& outputFilename);
+
+// Order-statistic queries the executor answers instead of a full sort
+struct SelectionQuery {
+    size_t topK = 0;               // the k smallest values, streamed from the input; 0 skips them
+    std::vector<double> quantiles; // each in [0, 1], selected from the input loaded in memory
+};
+
+template <typename T>
+struct SelectionResult {
+    std::vector<T> smallest;   // ascending
+    std::vector<T> quantiles;  // in query order
+};
+
+// NaN keys taken out of the input before sorting: operator< is no strict weak
+// order with them, so the comparison strategies never see them. The executor
+// writes them at the ends, where IEEE 754 totalOrder (and RadixSort) puts
+// them: the negative ones first, the positive ones last.
+template <typename T>
+struct NaNKeys {
+    std::vector<T> negative;
+    std::vector<T> positive;
+
+    size_t size() const { return negative.size() + positive.size(); }
+
+    // Moves the NaNs out of values, keeping the order of the rest; a no-op for integer keys
+    void extract(std::vector<T>& values) {
+        if constexpr (std::is_floating_point_v<T>) {
+            auto kept = values.begin();
+            for (T value : values) {
+                if (std::isnan(value)) {
+                    (std::signbit(value) ? negative : positive).push_back(value);
+                } else {
+                    *kept++ = value;
+                }
+            }
+            values.erase(kept, values.end());
+        }
+    }
+};
+
+// Writes the zeros of a sorted run -0.0 first, where totalOrder (and RadixSort)
+// puts them; the comparison strategies see the two as equal and leave them in
+// whatever order they come out. A no-op for integer keys
+template <typename T>
+void orderSignedZeros(std::vector<T>& sorted) {
+    if constexpr (std::is_floating_point_v<T>) {
+        auto [first, last] = std::equal_range(sorted.begin(), sorted.end(), T(0));
+        auto negative = std::count_if(first, last, [](T value) { return std::signbit(value); });
+        std::fill(first, first + negative, -T(0));
+        std::fill(first + negative, last, T(0));
+    }
+}
+
+// operator< with -0.0 ordered before +0.0, so merging runs keeps orderSignedZeros' order
+template <typename T>
+bool signedZeroLess(T a, T b) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return a < b || (a == b && std::signbit(a) && !std::signbit(b));
+    } else {
+        return a < b;
+    }
+}
+
+// The order the executors write keys in: negative NaNs first and positive ones last,
+// as NaNKeys places them, and signedZeroLess in between. Runs written in this
+// order can be merged with it, NaNs included.
+template <typename T>
+bool sortedOrderLess(T a, T b) {
+    if constexpr (std::is_floating_point_v<T>) {
+        auto rank = [](T value) { return std::isnan(value) ? (std::signbit(value) ? 0 : 2) : 1; };
+        if (rank(a) != rank(b)) {
+            return rank(a) < rank(b);
+        }
+        if (rank(a) != 1) {
+            return false;
+        }
+    }
+    return signedZeroLess(a, b);
+}
+
 template <typename T>
 class SortExecutor {
 public:
-    SortExecutor(std::unique_ptr<SortStrategy<T>> strategy) : strategy_(std::move(strategy)) {}
+    // Malformed lines beyond this many are only counted, not printed
+    static constexpr size_t MAX_REPORTED_ERRORS = 10;
+
+    static constexpr size_t DEFAULT_PIPELINE_CHUNK = 1 << 20;
+    // Elements the final merge emits per block handed to the writer
+    static constexpr size_t OUTPUT_BLOCK_ELEMENTS = 1 << 16;
+
+    SortExecutor(std::unique_ptr<SortStrategy<T>> strategy, size_t pipelineChunkElements = DEFAULT_PIPELINE_CHUNK)
+        : strategy_(std::move(strategy)), pipelineChunkElements_(pipelineChunkElements) {}
+
+    // Sorts with scratch memory from an arena the caller keeps across executors (batch workers)
+    void useScratch(ScratchArena& arena) { scratch_ = &arena; }
+    // MemoryProbe resets process-wide high-water marks, so callers running several
+    // executors at once switch the probes off and measure around all of them instead
+    void measureMemory(bool enabled) { measureMemory_ = enabled; }
+
+    // Sorts inputFilename and reports the result without printing anything; failures end up in
+    // SortReport::error. Without sortedFilename the input is sorted in memory as a whole.
+    // With it, the run is pipelined and the sorted data is written there (format by extension):
+    // chunk N + 1 is parsed while chunk N is sorted, the sorted chunks are k-way merged,
+    // and every merged block is written while the next one is produced.
+    SortReport run(const std::string& inputFilename, const std::string& sortedFilename = {});
+
+    // run() that prints the timings and appends a results line to outputFilename
+    void execute(const std::string& inputFilename, const std::string& outputFilename,
+                 const std::string& sortedFilename = {});
+
+    // Alternative to run() for queries that need a few ranks, not the sorted data:
+    // the top k are streamed chunk by chunk through TopK, the quantiles are picked by
+    // Selection::quantiles. The strategy is not used, and NaN keys are left out.
+    // Failures end up in SortReport::error.
+    SortReport select(const std::string& inputFilename, const SelectionQuery& query, SelectionResult<T>& result);
 
-    void execute(const std::string& inputFilename, const std::string& outputFilename);
+    // select() that prints the answers and appends a results line to outputFilename.
+    // With sortedFilename, the k smallest values are written there.
+    void executeSelection(const std::string& inputFilename, const std::string& outputFilename,
+                          const SelectionQuery& query, const std::string& sortedFilename = {});
 
 private:
     std::unique_ptr<SortStrategy<T>> strategy_;
+    size_t pipelineChunkElements_;
+    // Reused by every sort of this executor unless useScratch() lent another one
+    ScratchArena ownScratch_;
+    ScratchArena* scratch_ = &ownScratch_;
+    bool measureMemory_ = true;
 
+    // Throws std::runtime_error if the input cannot be read
     std::vector<T> readData(const std::string& filename);
-    double measureSortTime(std::vector<T>& data);
-    void writeOutput(const std::string& filename, size_t size, double elapsed, const std::string& outputFilename);
+    void runInMemory(SortReport& report);
+    void runPipelined(SortReport& report);
+    // Hands consume(chunk) every chunk of the input while the next one is read ahead;
+    // the time spent waiting for the reader goes to timings.parse
+    template <typename Consume>
+    void readChunks(const std::string& filename, PhaseTimings& timings, Consume consume);
+    // Pipeline stages: returns the sorted chunks (their NaNs go to nans), then merges them into the writer
+    std::vector<std::vector<T>> sortChunks(const std::string& filename, NaNKeys<T>& nans, PhaseTimings& timings);
+    void writeMerged(std::vector<std::vector<T>>& chunks, const NaNKeys<T>& nans, const std::string& sortedFilename,
+                     PhaseTimings& timings);
+    // Also collects the hardware counters of the sort into the report (left empty where unavailable)
+    double measureSortTime(std::vector<T>& data, SortReport& report);
+    void writeSelectionOutput(const SortReport& report, const std::string& answer, const std::string& outputFilename);
 };
 
 #endif //ALGORITHMS_PROGRAMMING_EXERCISES_SORT_ALGORITHMS_H
\ No newline at end of file
@@ -0,0 +1,1329 @@
+#include <gtest/gtest.h>
+#include "sort_algorithms.h"
+#include "batch_sort.h"
+#include "data_reader.h"
+#include "binary_dataset.h"
+#include "data_writer.h"
+#include "external_sort.h"
+#include "input_distributions.h"
+#include "perf_counters.h"
+#include "search_index.h"
+#include "string_sort.h"
+#include <cstdio>
+#include <iomanip>
+#include <compare>
+#include <cmath>
+#include <fstream>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+    std::vector<int> randomVector(size_t n, unsigned int seed, int maxValue = 1000000) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> dist(0, maxValue);
+        std::vector<int> values(n);
+        for (auto& v : values) {
+            v = dist(rng);
+        }
+        return values;
+    }
+
+    void expectSortsLikeStd(SortStrategy<int>& strategy, std::vector<int> values) {
+        std::vector<int> expected = values;
+        std::sort(expected.begin(), expected.end());
+        strategy.sort(values);
+        EXPECT_EQ(values, expected) << strategy.getName();
+    }
+}
+
+// Insertion sort on a small random input
+TEST(SortAlgorithmsTest, InsertionSortRandom) {
+    InsertionSort<int> strategy;
+    expectSortsLikeStd(strategy, randomVector(500, 1));
+}
+
+// Empty and single-element inputs are left untouched
+TEST(SortAlgorithmsTest, TrivialInputs) {
+    ParallelMergeSort<int> strategy(4, 64);
+    expectSortsLikeStd(strategy, {});
+    expectSortsLikeStd(strategy, {42});
+}
+
+// Parallel merge sort with a small cutoff so the forked and merged paths are exercised
+TEST(SortAlgorithmsTest, ParallelMergeSortRandom) {
+    ParallelMergeSort<int> strategy(4, 64);
+    expectSortsLikeStd(strategy, randomVector(100000, 2));
+}
+
+// Many duplicates stress the split search in the parallel merge
+TEST(SortAlgorithmsTest, ParallelMergeSortDuplicates) {
+    ParallelMergeSort<int> strategy(3, 64);
+    expectSortsLikeStd(strategy, randomVector(50000, 3, 7));
+}
+
+// A single thread falls back to the sequential kernel
+TEST(SortAlgorithmsTest, ParallelMergeSortSingleThread) {
+    ParallelMergeSort<int> strategy(1);
+    expectSortsLikeStd(strategy, randomVector(20000, 4));
+}
+
+// Radix sort on bounded non-negative keys, like the generator output
+TEST(SortAlgorithmsTest, RadixSortRandom) {
+    RadixSort<int> strategy;
+    expectSortsLikeStd(strategy, randomVector(100000, 6));
+}
+
+// Negative keys are ordered before positive ones via the sign-bit flip
+TEST(SortAlgorithmsTest, RadixSortNegativeKeys) {
+    RadixSort<int> strategy;
+    std::vector<int> values = randomVector(10000, 7);
+    for (size_t i = 0; i < values.size(); i += 3) {
+        values[i] = -values[i];
+    }
+    expectSortsLikeStd(strategy, values);
+}
+
+// 64-bit keys use the eight-digit specialisation
+TEST(SortAlgorithmsTest, RadixSort64BitKeys) {
+    std::mt19937_64 rng(8);
+    std::vector<uint64_t> values(20000);
+    for (auto& v : values) {
+        v = rng();
+    }
+    std::vector<uint64_t> expected = values;
+    std::sort(expected.begin(), expected.end());
+    RadixSort<uint64_t> strategy;
+    strategy.sort(values);
+    EXPECT_EQ(values, expected);
+}
+
+// Inputs above the LSD threshold are split MSD first; keys sharing their high bytes skip those digits
+TEST(SortAlgorithmsTest, RadixSortMsdSplit) {
+    std::mt19937_64 rng(9);
+    std::vector<uint64_t> values(3 * RadixSort<uint64_t>::LSD_THRESHOLD);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = i % 2 ? rng() : (uint64_t(0xAB) << 56) | (rng() >> 40);
+    }
+    std::vector<uint64_t> expected = values;
+    std::sort(expected.begin(), expected.end());
+    RadixSort<uint64_t> strategy;
+    strategy.sort(values);
+    EXPECT_EQ(values, expected);
+
+    std::vector<int> ints = randomVector(2 * RadixSort<int>::LSD_THRESHOLD, 10);
+    RadixSort<int> intStrategy;
+    expectSortsLikeStd(intStrategy, ints);
+}
+
+// Floats follow IEEE 754 totalOrder: NaNs by sign at the ends, -0.0 before +0.0
+TEST(SortAlgorithmsTest, RadixSortFloatTotalOrder) {
+    constexpr double NAN_VALUE = std::numeric_limits<double>::quiet_NaN();
+    constexpr double INF = std::numeric_limits<double>::infinity();
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> dist(-1e9, 1e9);
+    for (size_t n : {size_t(1000), 2 * RadixSort<double>::LSD_THRESHOLD}) {
+        std::vector<double> values(n);
+        for (auto& v : values) {
+            v = dist(rng);
+        }
+        std::vector<double> specials = {NAN_VALUE, -NAN_VALUE, 0.0, -0.0, INF, -INF,
+                                        std::numeric_limits<double>::denorm_min(),
+                                        -std::numeric_limits<double>::denorm_min()};
+        for (size_t i = 0; i < specials.size(); ++i) {
+            values[i * 97] = specials[i];
+        }
+        std::vector<double> expected = values;
+        std::sort(expected.begin(), expected.end(), [](double a, double b) { return std::strong_order(a, b) < 0; });
+        RadixSort<double> strategy;
+        strategy.sort(values);
+        EXPECT_EQ(std::memcmp(values.data(), expected.data(), n * sizeof(double)), 0) << n;
+        EXPECT_TRUE(std::isnan(values.front()) && std::signbit(values.front()));
+        EXPECT_TRUE(std::isnan(values.back()) && !std::signbit(values.back()));
+    }
+
+    std::vector<float> floats = {1.5f, -0.0f, 0.0f, -2.5f, std::numeric_limits<float>::infinity(), -1e-30f};
+    RadixSort<float> floatStrategy;
+    floatStrategy.sort(floats);
+    EXPECT_EQ(floats, (std::vector<float>{-2.5f, -1e-30f, -0.0f, 0.0f, 1.5f, std::numeric_limits<float>::infinity()}));
+    EXPECT_TRUE(std::signbit(floats[2]) && !std::signbit(floats[3]));
+}
+
+// Every strategy sorts the wider and floating-point key types it is instantiated for
+TEST(SortAlgorithmsTest, AllStrategiesSortEveryKeyType) {
+    std::mt19937_64 rng(12);
+    std::vector<int64_t> wide(30000);
+    std::vector<double> reals(30000);
+    for (size_t i = 0; i < wide.size(); ++i) {
+        wide[i] = static_cast<int64_t>(rng());
+        reals[i] = std::ldexp(static_cast<double>(static_cast<int64_t>(rng())), -40);
+    }
+    for (const auto& name : sortStrategyNames()) {
+        if (name == "insertion") {
+            continue;
+        }
+        SortOptions options;
+        options.algorithm = name;
+        options.threads = 2;
+        std::vector<int64_t> wideSorted = wide;
+        makeSortStrategy<int64_t>(options)->sort(wideSorted);
+        EXPECT_TRUE(std::is_sorted(wideSorted.begin(), wideSorted.end())) << name;
+        std::vector<double> realsSorted = reals;
+        makeSortStrategy<double>(options)->sort(realsSorted);
+        EXPECT_TRUE(std::is_sorted(realsSorted.begin(), realsSorted.end())) << name;
+        std::vector<double> expected = reals;
+        std::sort(expected.begin(), expected.end());
+        EXPECT_EQ(realsSorted, expected) << name;
+    }
+    SortOptions indirect;
+    indirect.algorithm = "radix";
+    indirect.indirect = true;
+    EXPECT_THROW(makeSortStrategy<float>(indirect), std::invalid_argument);
+}
+
+// The insertion kernel only sorts the requested range
+TEST(SortAlgorithmsTest, InsertionSortRangeKernel) {
+    std::vector<int> values = {9, 8, 5, 3, 4, 1, 0};
+    InsertionSort<int>::sortRange(values.data() + 1, values.data() + 6);
+    EXPECT_EQ(values, (std::vector<int>{9, 1, 3, 4, 5, 8, 0}));
+}
+
+// The partial kernel gives up on inputs that need too many moves
+TEST(SortAlgorithmsTest, InsertionSortPartialGivesUp) {
+    std::vector<int> values = {5, 4, 3, 2, 1, 0};
+    EXPECT_FALSE(InsertionSort<int>::partialSortRange(values.data(), values.data() + values.size(), 4));
+    std::vector<int> nearlySorted = {0, 1, 3, 2, 4, 5};
+    EXPECT_TRUE(InsertionSort<int>::partialSortRange(nearlySorted.data(), nearlySorted.data() + 6, 4));
+    EXPECT_TRUE(std::is_sorted(nearlySorted.begin(), nearlySorted.end()));
+}
+
+// pdqsort on random input and on the patterns it is designed to defeat
+TEST(SortAlgorithmsTest, PdqSortPatterns) {
+    PdqSort<int> strategy;
+    std::vector<int> random = randomVector(100000, 9);
+    expectSortsLikeStd(strategy, random);
+
+    std::vector<int> sorted = random;
+    std::sort(sorted.begin(), sorted.end());
+    expectSortsLikeStd(strategy, sorted);
+    expectSortsLikeStd(strategy, std::vector<int>(sorted.rbegin(), sorted.rend()));
+    expectSortsLikeStd(strategy, std::vector<int>(50000, 7));
+    expectSortsLikeStd(strategy, randomVector(100000, 10, 3));
+
+    std::vector<int> organPipe(100000);
+    for (size_t i = 0; i < organPipe.size(); ++i) {
+        organPipe[i] = static_cast<int>(std::min(i, organPipe.size() - i));
+    }
+    expectSortsLikeStd(strategy, organPipe);
+}
+
+// Every small size around the insertion threshold
+TEST(SortAlgorithmsTest, PdqSortSmallSizes) {
+    PdqSort<int> strategy(8);
+    for (size_t n = 0; n < 300; ++n) {
+        expectSortsLikeStd(strategy, randomVector(n, 11 + n, 50));
+    }
+}
+
+// Every block size of the network sorts, including duplicates and extreme keys,
+// on the selected kernels and on the scalar fallback
+TEST(SortAlgorithmsTest, SortingNetworkBlocks) {
+    for (size_t n : {8u, 16u, 32u, 64u}) {
+        for (unsigned int seed = 0; seed < 50; ++seed) {
+            std::vector<int> values = randomVector(n, 100 + seed, seed % 2 ? 10 : 1000000);
+            values[seed % n] = INT_MIN;
+            values[(seed * 7) % n] = INT_MAX;
+            std::vector<int> expected = values;
+            std::sort(expected.begin(), expected.end());
+            std::vector<int> scalar = values;
+            SortingNetwork::sortBlock(values.data(), n);
+            EXPECT_EQ(values, expected) << "n = " << n;
+            SortingNetwork::sortBlockScalar(scalar.data(), n);
+            EXPECT_EQ(scalar, expected) << "scalar, n = " << n;
+        }
+    }
+    EXPECT_THROW(SortingNetwork::sortBlock(nullptr, 12), std::invalid_argument);
+    EXPECT_THROW(SortingNetwork::sortBlockScalar(nullptr, 12), std::invalid_argument);
+}
+
+// Ranges that are not a block size are padded
+TEST(SortAlgorithmsTest, SortingNetworkRanges) {
+    for (size_t n = 0; n <= SortingNetwork::MAX_BLOCK; ++n) {
+        std::vector<int> values = randomVector(n, 200 + n);
+        std::vector<int> expected = values;
+        std::sort(expected.begin(), expected.end());
+        SortingNetwork::sortRange(values.data(), values.data() + n);
+        EXPECT_EQ(values, expected) << "n = " << n;
+    }
+}
+
+// Block sorting plus bottom-up merging, with a ragged last block
+TEST(SortAlgorithmsTest, NetworkMergeSortRandom) {
+    NetworkMergeSort<int> strategy;
+    expectSortsLikeStd(strategy, randomVector(100003, 17));
+    expectSortsLikeStd(strategy, randomVector(50, 18));
+}
+
+// pdqsort with the network as its base case
+TEST(SortAlgorithmsTest, PdqSortNetworkKernel) {
+    PdqSort<int> strategy(64, true);
+    expectSortsLikeStd(strategy, randomVector(100000, 19));
+    expectSortsLikeStd(strategy, randomVector(100000, 20, 5));
+}
+
+// TimSort on random input, on presorted shapes and on many short runs
+TEST(SortAlgorithmsTest, TimSortPatterns) {
+    TimSort<int> strategy;
+    std::vector<int> random = randomVector(100000, 24);
+    expectSortsLikeStd(strategy, random);
+    expectSortsLikeStd(strategy, randomVector(100000, 25, 3));
+
+    std::vector<int> sorted = random;
+    std::sort(sorted.begin(), sorted.end());
+    expectSortsLikeStd(strategy, sorted);
+    expectSortsLikeStd(strategy, std::vector<int>(sorted.rbegin(), sorted.rend()));
+    for (Distribution distribution : {Distribution::NearlySorted, Distribution::OrganPipe}) {
+        expectSortsLikeStd(strategy, generateDistribution<int>(distribution, 100000, 26));
+    }
+
+    // Concatenated sorted runs of varied lengths exercise the stack invariants and galloping
+    std::vector<int> runs;
+    std::mt19937 rng(27);
+    while (runs.size() < 200000) {
+        std::vector<int> run = randomVector(1 + rng() % 5000, rng(), 1000);
+        std::sort(run.begin(), run.end());
+        runs.insert(runs.end(), run.begin(), run.end());
+    }
+    expectSortsLikeStd(strategy, runs);
+    for (size_t n = 0; n < 100; ++n) {
+        expectSortsLikeStd(strategy, randomVector(n, 300 + n, 20));
+    }
+}
+
+// Equal keys keep their input order
+TEST(SortAlgorithmsTest, TimSortIsStable) {
+    std::vector<Record<8>> records(50000);
+    std::vector<int> keys = randomVector(records.size(), 28, 50);
+    for (size_t i = 0; i < records.size(); ++i) {
+        records[i].key = keys[i];
+        uint32_t position = static_cast<uint32_t>(i);
+        std::memcpy(records[i].payload, &position, sizeof(position));
+    }
+    std::vector<Record<8>> expected = records;
+    std::stable_sort(expected.begin(), expected.end());
+    TimSort<Record<8>> strategy;
+    strategy.sort(records);
+    for (size_t i = 0; i < records.size(); ++i) {
+        ASSERT_EQ(std::memcmp(&records[i], &expected[i], sizeof(Record<8>)), 0) << i;
+    }
+}
+
+// Every registered name produces a working strategy
+TEST(SortAlgorithmsTest, FactoryBuildsAllStrategies) {
+    for (const auto& name : sortStrategyNames()) {
+        SortOptions options;
+        options.algorithm = name;
+        options.threads = 2;
+        auto strategy = makeSortStrategy<int>(options);
+        ASSERT_NE(strategy, nullptr);
+        expectSortsLikeStd(*strategy, randomVector(3000, 5));
+    }
+}
+
+// Sorting through an arena gives the same result, and repeated sorts of the same size reuse its memory
+TEST(SortAlgorithmsTest, ScratchArenaIsReused) {
+    std::vector<int> expected = randomVector(40000, 6);
+    std::sort(expected.begin(), expected.end());
+    for (const auto& name : sortStrategyNames()) {
+        if (name == "insertion") {
+            continue;
+        }
+        for (bool indirect : {false, true}) {
+            SortOptions options;
+            options.algorithm = name;
+            options.threads = 2;
+            options.indirect = indirect;
+            auto strategy = makeSortStrategy<int>(options);
+            ScratchArena scratch;
+            std::vector<int> values = randomVector(40000, 6);
+            strategy->sort(values, scratch);
+            EXPECT_EQ(values, expected) << strategy->getName();
+            size_t blocks = scratch.blockAllocations();
+            for (int run = 0; run < 3; ++run) {
+                values = randomVector(40000, 7 + run);
+                strategy->sort(values, scratch);
+                EXPECT_TRUE(std::is_sorted(values.begin(), values.end())) << strategy->getName();
+            }
+            EXPECT_EQ(scratch.blockAllocations(), blocks) << strategy->getName();
+        }
+    }
+}
+
+// A warm indirect sort takes its key pairs from the arena and gathers into the previous input's buffer
+TEST(SortAlgorithmsTest, IndirectPairsComeFromArena) {
+    std::vector<int> keys = randomVector(20000, 24);
+    for (const char* name : {"radix", "pdq", "network_merge", "tim"}) {
+        SortOptions options;
+        options.algorithm = name;
+        options.indirect = true;
+        auto strategy = makeSortStrategy<Record<32>>(options);
+        ScratchArena scratch;
+        std::vector<Record<32>> values(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            values[i].key = keys[i];
+        }
+        strategy->sort(values, scratch);
+        std::reverse(values.begin(), values.end());
+
+        AllocationCounts before = allocationCounts();
+        strategy->sort(values, scratch);
+        AllocationCounts after = allocationCounts();
+        // Only bookkeeping such as TimSort's run stack, nothing that grows with the input
+        EXPECT_LT(after.bytes - before.bytes, 1024u) << name;
+        EXPECT_GE(scratch.capacity(), values.size() * sizeof(uint64_t)) << name;
+        EXPECT_TRUE(std::is_sorted(values.begin(), values.end())) << name;
+    }
+}
+
+// Records sort by key through every strategy, directly and indirectly
+TEST(SortAlgorithmsTest, RecordsDirectAndIndirect) {
+    std::vector<int> keys = randomVector(5000, 22, 100);
+    std::vector<Record<64>> records(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        records[i].key = keys[i];
+        std::fill(std::begin(records[i].payload), std::end(records[i].payload), static_cast<unsigned char>(i));
+    }
+    std::vector<Record<64>> expected = records;
+    std::stable_sort(expected.begin(), expected.end());
+
+    for (const auto& name : sortStrategyNames()) {
+        for (bool indirect : {false, true}) {
+            SortOptions options;
+            options.algorithm = name;
+            options.threads = 2;
+            options.indirect = indirect;
+            if (name == "radix" && !indirect) {
+                EXPECT_THROW(makeSortStrategy<Record<64>>(options), std::invalid_argument);
+                continue;
+            }
+            std::vector<Record<64>> values = records;
+            makeSortStrategy<Record<64>>(options)->sort(values);
+            ASSERT_EQ(values.size(), expected.size());
+            for (size_t i = 0; i < values.size(); ++i) {
+                ASSERT_EQ(values[i].key, expected[i].key) << name;
+                // The indirect mode is stable, so even the payloads match the stable reference
+                if (indirect) {
+                    ASSERT_EQ(values[i].payload[0], expected[i].payload[0]) << name;
+                }
+            }
+        }
+    }
+}
+
+// Unknown names are rejected
+TEST(SortAlgorithmsTest, FactoryRejectsUnknownName) {
+    SortOptions options;
+    options.algorithm = "bogosort";
+    EXPECT_THROW(makeSortStrategy<int>(options), std::invalid_argument);
+}
+
+// nthElement and partialSort agree with a full sort on random, duplicate-heavy and presorted inputs
+TEST(SelectionTest, NthElementAndPartialSort) {
+    std::vector<std::vector<int>> inputs = {randomVector(100000, 41), randomVector(50000, 42, 3)};
+    std::vector<int> ascending(30000);
+    for (size_t i = 0; i < ascending.size(); ++i) {
+        ascending[i] = static_cast<int>(i);
+    }
+    inputs.push_back(ascending);
+    inputs.emplace_back(ascending.rbegin(), ascending.rend());
+
+    for (const auto& input : inputs) {
+        std::vector<int> expected = input;
+        std::sort(expected.begin(), expected.end());
+        for (size_t rank : {size_t(0), input.size() / 3, input.size() - 1}) {
+            std::vector<int> values = input;
+            Selection<int>::nthElement(values.data(), values.data() + rank, values.data() + values.size());
+            ASSERT_EQ(values[rank], expected[rank]);
+            EXPECT_LE(*std::max_element(values.begin(), values.begin() + rank), values[rank]);
+            EXPECT_GE(*std::min_element(values.begin() + rank, values.end()), values[rank]);
+        }
+
+        std::vector<int> values = input;
+        Selection<int>::partialSort(values.data(), values.data() + 1000, values.data() + values.size());
+        EXPECT_TRUE(std::equal(values.begin(), values.begin() + 1000, expected.begin()));
+    }
+}
+
+// Quantiles, the vectorised filter and the streamed top k match their sorted definitions
+TEST(SelectionTest, QuantilesFilterAndTopK) {
+    std::vector<int> values = randomVector(100003, 43);
+    std::vector<int> expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<double> qs = {0.99, 0.0, 0.5, 1.0, 0.5};
+    std::vector<int> data = values;
+    std::vector<int> quantiles = Selection<int>::quantiles(data, qs);
+    ASSERT_EQ(quantiles.size(), qs.size());
+    for (size_t i = 0; i < qs.size(); ++i) {
+        EXPECT_EQ(quantiles[i], expected[static_cast<size_t>(qs[i] * (expected.size() - 1))]);
+    }
+    EXPECT_THROW(Selection<int>::quantiles(data, {1.5}), std::invalid_argument);
+
+    // In place, including a scalar tail after the eight-lane blocks
+    std::vector<int> filtered = values;
+    size_t kept = Selection<int>::filterBelow(filtered.data(), filtered.size(), 500000, filtered.data());
+    std::vector<int> below;
+    std::copy_if(values.begin(), values.end(), std::back_inserter(below), [](int v) { return v < 500000; });
+    filtered.resize(kept);
+    EXPECT_EQ(filtered, below);
+
+    for (size_t k : {size_t(1), size_t(100), size_t(5000), size_t(200000)}) {
+        TopK<int> topK(k);
+        for (size_t offset = 0; offset < values.size(); offset += 7777) {
+            topK.push(values.data() + offset, std::min<size_t>(7777, values.size() - offset));
+        }
+        size_t keep = std::min(k, expected.size());
+        EXPECT_EQ(topK.result(), std::vector<int>(expected.begin(), expected.begin() + keep)) << k;
+    }
+}
+
+// Every index layout answers single and batched queries like std::lower_bound,
+// including sizes that leave the last cache line and tree level partially filled
+TEST(SearchIndexTest, MatchesLowerBound) {
+    for (size_t size : {size_t(0), size_t(1), size_t(15), size_t(16), size_t(17), size_t(289), size_t(100003)}) {
+        std::vector<int> sorted = randomVector(size, 51, 200000);
+        std::sort(sorted.begin(), sorted.end());
+        std::vector<int> queries = randomVector(3001, 52, 200002);
+        queries.push_back(-1);
+        queries.push_back(std::numeric_limits<int>::max());
+
+        for (const auto& name : searchIndexNames()) {
+            auto index = makeSearchIndex<int>(name, sorted);
+            ASSERT_EQ(index->size(), size);
+            std::vector<size_t> positions(queries.size());
+            std::unique_ptr<bool[]> found(new bool[queries.size()]);
+            index->lowerBound(queries.data(), queries.size(), positions.data());
+            index->contains(queries.data(), queries.size(), found.get());
+            for (size_t i = 0; i < queries.size(); ++i) {
+                size_t expected = std::lower_bound(sorted.begin(), sorted.end(), queries[i]) - sorted.begin();
+                bool present = std::binary_search(sorted.begin(), sorted.end(), queries[i]);
+                ASSERT_EQ(index->lowerBound(queries[i]), expected) << name << " size " << size;
+                ASSERT_EQ(positions[i], expected) << name << " size " << size;
+                ASSERT_EQ(index->contains(queries[i]), present) << name;
+                ASSERT_EQ(found[i], present) << name;
+            }
+        }
+    }
+
+    // The padding key itself is a valid stored key
+    std::vector<int64_t> wide = {-5, 7, std::numeric_limits<int64_t>::max()};
+    StaticBTree<int64_t> tree(wide);
+    EXPECT_EQ(tree.lowerBound(std::numeric_limits<int64_t>::max()), 2u);
+    EXPECT_TRUE(tree.contains(std::numeric_limits<int64_t>::max()));
+    EXPECT_EQ(EytzingerIndex<int64_t>(wide).lowerBound(8), 2u);
+    EXPECT_THROW(makeSearchIndex<int>("eytzinger", {3, 1}), std::invalid_argument);
+}
+
+// Counters either work or degrade to empty values with a reason, never an error
+TEST(PerfCountersTest, GracefulFallback) {
+    PerfCounterGroup perf;
+    perf.start();
+    std::vector<int> values = randomVector(100000, 23);
+    std::sort(values.begin(), values.end());
+    PerfCounts counts = perf.stop();
+    if (perf.available()) {
+        EXPECT_TRUE(perf.unavailableReason().empty());
+    } else {
+        EXPECT_FALSE(perf.unavailableReason().empty());
+        EXPECT_FALSE(counts.get(PerfEvent::Cycles).has_value());
+        EXPECT_NE(counts.format().find("cycles=n/a"), std::string::npos);
+    }
+    EXPECT_EQ(perfEventName(PerfEvent::LLCMisses), "llc_misses");
+}
+
+// Workers a parallel sort starts are counted too, so adding threads never makes the work look smaller
+TEST(PerfCountersTest, CountsParallelWorkers) {
+    const std::vector<int> input = randomVector(1 << 20, 29);
+    auto instructionsWith = [&](unsigned int threads) {
+        ParallelMergeSort<int> strategy(threads, 1 << 12);
+        std::vector<int> values = input;
+        PerfCounterGroup perf;
+        perf.start();
+        strategy.sort(values);
+        return perf.stop().get(PerfEvent::Instructions);
+    };
+    auto single = instructionsWith(1);
+    if (!single) {
+        GTEST_SKIP() << "Instructions cannot be counted on this host";
+    }
+    auto parallel = instructionsWith(4);
+    ASSERT_TRUE(parallel.has_value());
+    EXPECT_GE(*parallel, *single * 9 / 10);
+}
+
+// Parser skips blank lines and reports malformed ones with their byte offset
+TEST(DataReaderTest, ParseNumbersReportsErrors) {
+    std::vector<int> values;
+    std::vector<ParseError> errors;
+    parseNumbers<int>("12\n-3\n\nabc\n+7\r\n4x\n99", values, errors);
+    EXPECT_EQ(values, (std::vector<int>{12, -3, 7, 99}));
+    ASSERT_EQ(errors.size(), 2u);
+    EXPECT_EQ(errors[0].line, 4u);
+    EXPECT_EQ(errors[0].offset, 7u);
+    EXPECT_EQ(errors[0].text, "abc");
+    EXPECT_EQ(errors[1].line, 6u);
+}
+
+// Whitespace around a number is trimmed as std::stoi did; inside it the line is malformed
+TEST(DataReaderTest, ParseNumbersTrimsWhitespace) {
+    std::vector<int> values;
+    std::vector<ParseError> errors;
+    parseNumbers<int>(" 42\n42\r\n\t-5 \r\n  \n+8\t\n1 2\n", values, errors);
+    EXPECT_EQ(values, (std::vector<int>{42, 42, -5, 8}));
+    ASSERT_EQ(errors.size(), 1u);
+    EXPECT_EQ(errors[0].line, 6u);
+
+    // One '+' is accepted, but not a second sign after it
+    values.clear();
+    errors.clear();
+    parseNumbers<int>("+-5\n++5\n+\n+5\n", values, errors);
+    EXPECT_EQ(values, (std::vector<int>{5}));
+    ASSERT_EQ(errors.size(), 3u);
+    EXPECT_EQ(errors[0].text, "+-5");
+    EXPECT_EQ(errors[1].text, "++5");
+
+    std::vector<double> doubles;
+    errors.clear();
+    parseNumbers<double>("  -0.5e1\r\n\tnan \n+-inf\n", doubles, errors);
+    EXPECT_EQ(errors.size(), 1u);
+    ASSERT_EQ(doubles.size(), 2u);
+    EXPECT_EQ(doubles[0], -5.0);
+    EXPECT_TRUE(std::isnan(doubles[1]));
+}
+
+// Values past a blank line are still read (the old reader stopped there)
+TEST(DataReaderTest, MappedFileRoundTrip) {
+    std::string path = ::testing::TempDir() + "data_reader_test.txt";
+    {
+        std::ofstream out(path);
+        out << "5\n1\n\n3\n";
+    }
+    MappedFile file(path);
+    ASSERT_TRUE(file.isOpen());
+    std::vector<int> values;
+    std::vector<ParseError> errors;
+    parseNumbers(file.contents(), values, errors);
+    EXPECT_EQ(values, (std::vector<int>{5, 1, 3}));
+    EXPECT_TRUE(errors.empty());
+    std::remove(path.c_str());
+}
+
+// The stream keeps only the first errors it is allowed but counts every malformed line,
+// and the report summarises the ones that were dropped
+TEST(DataReaderTest, StreamKeepsFirstErrorsAndCountsTheRest) {
+    std::string path = ::testing::TempDir() + "data_reader_errors.txt";
+    {
+        std::ofstream out(path);
+        for (int i = 0; i < 1000; ++i) {
+            out << i << "\nbad" << i << "\n";
+        }
+    }
+    TextNumberStream<int> stream(path);
+    ASSERT_TRUE(stream.isOpen());
+    std::vector<int> values;
+    std::vector<ParseError> errors;
+    while (stream.read(values, 100, errors, 10) == 100) {
+    }
+    EXPECT_EQ(values.size(), 1000u);
+    ASSERT_EQ(errors.size(), 10u);
+    EXPECT_EQ(errors[0].text, "bad0");
+    EXPECT_EQ(errors[9].line, 20u);
+    EXPECT_EQ(stream.invalidLines(), 1000u);
+
+    ::testing::internal::CaptureStderr();
+    reportParseErrors(path, errors, 10, stream.invalidLines());
+    std::string report = ::testing::internal::GetCapturedStderr();
+    EXPECT_NE(report.find("... 990 more invalid lines"), std::string::npos);
+    std::remove(path.c_str());
+}
+
+// Missing files are reported as not open
+TEST(DataReaderTest, MappedFileMissing) {
+    MappedFile file("/nonexistent/definitely_missing.txt");
+    EXPECT_FALSE(file.isOpen());
+}
+
+// Binary datasets round-trip through the writer and the mapped reader
+TEST(BinaryDatasetTest, RoundTrip) {
+    std::string path = ::testing::TempDir() + "binary_dataset_test.bin";
+    std::vector<int> values = randomVector(200000, 12);
+    values[0] = -5;
+    writeBinaryDataset(path, values);
+    EXPECT_EQ(readBinaryDataset<int>(path), values);
+    std::remove(path.c_str());
+}
+
+// A flipped payload byte is caught by the checksum
+TEST(BinaryDatasetTest, DetectsCorruption) {
+    std::string path = ::testing::TempDir() + "binary_dataset_corrupt.bin";
+    writeBinaryDataset(path, randomVector(1000, 13));
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(BinaryDataset::HEADER_SIZE + 17);
+        file.put('\x7f');
+    }
+    EXPECT_THROW(readBinaryDataset<int>(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+// Only the .bin extension selects the binary format
+TEST(BinaryDatasetTest, FormatByExtension) {
+    EXPECT_TRUE(isBinaryDatasetPath("data/keys.bin"));
+    EXPECT_FALSE(isBinaryDatasetPath("data/gen_numbers.txt"));
+    EXPECT_FALSE(isBinaryDatasetPath("bin"));
+}
+
+// The loser tree yields the heads of sorted sources in order
+TEST(ExternalSortTest, LoserTreeMergesSources) {
+    std::vector<std::vector<int>> sources = {{1, 4, 9}, {2, 3, 10, 11}, {}, {0, 5}, {6}};
+    std::vector<size_t> positions(sources.size(), 0);
+    auto less = [&](size_t a, size_t b) {
+        bool aDone = a >= sources.size() || positions[a] == sources[a].size();
+        bool bDone = b >= sources.size() || positions[b] == sources[b].size();
+        if (aDone) {
+            return false;
+        }
+        return bDone || sources[a][positions[a]] < sources[b][positions[b]];
+    };
+    LoserTree<decltype(less)> tree(sources.size(), less);
+
+    std::vector<int> merged;
+    while (positions[tree.winner()] < sources[tree.winner()].size()) {
+        size_t source = tree.winner();
+        merged.push_back(sources[source][positions[source]++]);
+        tree.replay(source);
+    }
+    EXPECT_EQ(merged, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 9, 10, 11}));
+}
+
+// A budget far below the input size forces many runs through the merge
+TEST(ExternalSortTest, SortsTextInputInRuns) {
+    std::string input = ::testing::TempDir() + "external_input.txt";
+    std::string sorted = ::testing::TempDir() + "external_sorted.txt";
+    std::string results = ::testing::TempDir() + "external_results.txt";
+    std::vector<int> values = randomVector(50000, 14);
+    {
+        DatasetWriter<int> writer(input);
+        writer.write(values);
+        writer.close();
+    }
+
+    ExternalSortExecutor<int> executor(std::make_unique<PdqSort<int>>(), 16 * 1024, ::testing::TempDir());
+    EXPECT_TRUE(executor.execute(input, sorted, results));
+
+    MappedFile file(sorted);
+    std::vector<int> output;
+    std::vector<ParseError> errors;
+    parseNumbers(file.contents(), output, errors);
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(output, values);
+
+    std::remove(input.c_str());
+    std::remove(sorted.c_str());
+    std::remove(results.c_str());
+}
+
+// More runs than the fan-in are merged in passes, and every intermediate run is removed
+TEST(ExternalSortTest, MergesInPassesWithBoundedFanIn) {
+    std::filesystem::path directory = std::filesystem::path(::testing::TempDir()) / "external_passes";
+    std::filesystem::create_directories(directory);
+    std::string input = (directory / "input.bin").string();
+    std::string sorted = (directory / "sorted.bin").string();
+    std::string results = (directory / "results.txt").string();
+    std::vector<int> values = randomVector(100000, 16);
+    writeBinaryDataset(input, values);
+
+    // 8192-element chunks give 13 runs; 64 KiB fits four 4096-element buffers, so at most 3 inputs
+    ExternalSortExecutor<int> executor(std::make_unique<PdqSort<int>>(), 64 * 1024, directory, 8);
+    EXPECT_EQ(executor.fanIn(), 3u);
+    EXPECT_TRUE(executor.execute(input, sorted, results));
+
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(readBinaryDataset<int>(sorted), values);
+    std::ifstream resultsFile(results);
+    std::string line;
+    std::getline(resultsFile, line);
+    // 13 -> 5 -> 2 runs, then the final merge of those two
+    EXPECT_NE(line.find("Runs: 13, Merge passes: 3"), std::string::npos) << line;
+    size_t leftover = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        leftover += entry.path().extension() == ".run";
+    }
+    EXPECT_EQ(leftover, 0u);
+    EXPECT_EQ(ExternalSortExecutor<int>(std::make_unique<PdqSort<int>>(), 1 << 30, directory, 8).fanIn(), 8u);
+
+    std::filesystem::remove_all(directory);
+}
+
+// A corrupt input fails the sort after runs were spilled, and none of them is left behind
+TEST(ExternalSortTest, FailureRemovesSpilledRuns) {
+    std::filesystem::path directory = std::filesystem::path(::testing::TempDir()) / "external_failure";
+    std::filesystem::create_directories(directory);
+    std::string input = (directory / "input.bin").string();
+    writeBinaryDataset(input, randomVector(100000, 17));
+    {
+        // The checksum only fails once every value has been read and most runs are written
+        std::fstream file(input, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(std::filesystem::file_size(input) / 2));
+        file.put('\x5A');
+    }
+
+    ExternalSortExecutor<int> executor(std::make_unique<PdqSort<int>>(), 64 * 1024, directory);
+    EXPECT_FALSE(executor.execute(input, (directory / "sorted.bin").string(), (directory / "results.txt").string()));
+    size_t leftover = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        leftover += entry.path().extension() == ".run";
+    }
+    EXPECT_EQ(leftover, 0u);
+    std::filesystem::remove_all(directory);
+}
+
+// Floating-point keys come out in the in-memory executor's order across runs:
+// negative NaNs, the numbers with -0.0 before +0.0, positive NaNs
+TEST(ExternalSortTest, SortsDoubleKeysWithNaNsAndSignedZeros) {
+    std::string input = ::testing::TempDir() + "external_double.bin";
+    std::string sorted = ::testing::TempDir() + "external_double_sorted.bin";
+    std::string results = ::testing::TempDir() + "external_double_results.txt";
+    std::mt19937_64 rng(48);
+    std::uniform_real_distribution<double> dist(-10.0, 10.0);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> values;
+    for (int i = 0; i < 20000; ++i) {
+        values.push_back(dist(rng));
+        if (i % 500 == 0) {
+            values.insert(values.end(), {0.0, -0.0, nan, -nan});
+        }
+    }
+    writeBinaryDataset(input, values);
+
+    ExternalSortExecutor<double> executor(std::make_unique<PdqSort<double>>(), 64 * 1024, ::testing::TempDir());
+    ASSERT_TRUE(executor.execute(input, sorted, results));
+    std::vector<double> output = readBinaryDataset<double>(sorted);
+    ASSERT_EQ(output.size(), values.size());
+    EXPECT_TRUE(std::is_sorted(output.begin(), output.end(), sortedOrderLess<double>));
+    EXPECT_TRUE(std::isnan(output.front()) && std::signbit(output.front()));
+    EXPECT_TRUE(std::isnan(output.back()) && !std::signbit(output.back()));
+    auto zeros = std::find(output.begin(), output.end(), 0.0);
+    EXPECT_EQ(std::count(output.begin(), output.end(), 0.0), 80);
+    EXPECT_TRUE(std::all_of(zeros, zeros + 40, [](double value) { return std::signbit(value); }));
+    EXPECT_TRUE(std::none_of(zeros + 40, zeros + 80, [](double value) { return std::signbit(value); }));
+
+    std::remove(input.c_str());
+    std::remove(sorted.c_str());
+    std::remove(results.c_str());
+}
+
+// Binary input and output go through the streaming dataset reader and writer
+TEST(ExternalSortTest, SortsBinaryInput) {
+    std::string input = ::testing::TempDir() + "external_input.bin";
+    std::string sorted = ::testing::TempDir() + "external_sorted.bin";
+    std::string results = ::testing::TempDir() + "external_results.txt";
+    std::vector<int> values = randomVector(30001, 15);
+    writeBinaryDataset(input, values);
+
+    ExternalSortExecutor<int> executor(std::make_unique<RadixSort<int>>(), 20 * 1024, ::testing::TempDir());
+    EXPECT_TRUE(executor.execute(input, sorted, results));
+
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(readBinaryDataset<int>(sorted), values);
+
+    std::remove(input.c_str());
+    std::remove(sorted.c_str());
+    std::remove(results.c_str());
+}
+
+// The pipelined executor sorts several chunks and writes the merged result
+TEST(SortExecutorTest, PipelinedWritesSortedOutput) {
+    std::string input = ::testing::TempDir() + "pipelined_input.txt";
+    std::string sorted = ::testing::TempDir() + "pipelined_sorted.txt";
+    std::string results = ::testing::TempDir() + "pipelined_results.txt";
+    std::vector<int> values = randomVector(200003, 29);
+    {
+        DatasetWriter<int> writer(input);
+        writer.write(values);
+        writer.close();
+    }
+
+    SortExecutor<int> executor(std::make_unique<PdqSort<int>>(), 30000);
+    executor.execute(input, results, sorted);
+
+    MappedFile file(sorted);
+    std::vector<int> output;
+    std::vector<ParseError> errors;
+    parseNumbers(file.contents(), output, errors);
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(output, values);
+    EXPECT_TRUE(errors.empty());
+
+    // A single chunk is written without merging, here into the binary container
+    std::string sortedBinary = ::testing::TempDir() + "pipelined_sorted.bin";
+    SortExecutor<int> single(std::make_unique<PdqSort<int>>());
+    single.execute(input, results, sortedBinary);
+    EXPECT_EQ(readBinaryDataset<int>(sortedBinary), values);
+
+    std::remove(input.c_str());
+    std::remove(sorted.c_str());
+    std::remove(sortedBinary.c_str());
+    std::remove(results.c_str());
+}
+
+// Selection streams the top k from the input and picks quantiles without sorting it
+TEST(SortExecutorTest, SelectAnswersTopKAndQuantiles) {
+    std::string input = ::testing::TempDir() + "select_input.txt";
+    std::vector<int> values = randomVector(70001, 44);
+    {
+        DatasetWriter<int> writer(input);
+        writer.write(values);
+        writer.close();
+    }
+    std::sort(values.begin(), values.end());
+
+    SortExecutor<int> executor(std::make_unique<PdqSort<int>>(), 10000);
+    SelectionQuery query;
+    query.topK = 25;
+    SelectionResult<int> result;
+    SortReport report = executor.select(input, query, result);
+    EXPECT_TRUE(report.error.empty());
+    EXPECT_EQ(report.size, values.size());
+    EXPECT_EQ(result.smallest, std::vector<int>(values.begin(), values.begin() + 25));
+    EXPECT_TRUE(result.quantiles.empty());
+
+    query.quantiles = {0.5, 0.25};
+    SelectionResult<int> both;
+    executor.select(input, query, both);
+    EXPECT_EQ(both.smallest, result.smallest);
+    EXPECT_EQ(both.quantiles, (std::vector<int>{values[35000], values[17500]}));
+
+    std::remove(input.c_str());
+}
+
+// Double keys are parsed and written back; NaNs are set aside and written at the ends by sign
+TEST(SortExecutorTest, DoubleKeysWithNaNs) {
+    std::string input = ::testing::TempDir() + "double_input.txt";
+    std::string sorted = ::testing::TempDir() + "double_sorted.txt";
+    std::vector<double> values;
+    std::mt19937_64 rng(46);
+    std::uniform_real_distribution<double> dist(-1000.0, 1000.0);
+    {
+        std::ofstream out(input);
+        out << "nan\n-0.0\n+2.5e3\n-nan\n0\n-inf\nnot a number\n";
+        for (int i = 0; i < 5000; ++i) {
+            values.push_back(dist(rng));
+            out << std::setprecision(17) << values.back() << "\n";
+            // Zeros of both signs land in every chunk, positive ones first
+            if (i % 250 == 0) {
+                out << (i % 500 == 0 ? "0\n-0\n" : "-0\n0\n");
+                values.insert(values.end(), {0.0, -0.0});
+            }
+        }
+    }
+    values.insert(values.end(), {-0.0, 2500.0, 0.0, -std::numeric_limits<double>::infinity()});
+    std::sort(values.begin(), values.end());
+
+    for (const auto& algorithm : sortStrategyNames()) {
+        SortOptions options;
+        options.algorithm = algorithm;
+        SortExecutor<double> executor(makeSortStrategy<double>(options), 1000);
+        SortReport report = executor.run(input, sorted);
+        ASSERT_TRUE(report.error.empty()) << report.error;
+        EXPECT_EQ(report.size, values.size() + 2);
+
+        std::ifstream in(sorted);
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(in, line)) {
+            lines.push_back(line);
+        }
+        ASSERT_EQ(lines.size(), values.size() + 2) << algorithm;
+        EXPECT_EQ(lines.front(), "-nan") << algorithm;
+        EXPECT_EQ(lines.back(), "nan") << algorithm;
+        std::vector<double> middle;
+        for (size_t i = 1; i + 1 < lines.size(); ++i) {
+            middle.push_back(std::stod(lines[i]));
+        }
+        EXPECT_EQ(middle, values) << algorithm;
+        // Equal under operator<, but -0.0 comes first as in totalOrder
+        auto zeros = std::equal_range(middle.begin(), middle.end(), 0.0);
+        EXPECT_EQ(zeros.second - zeros.first, 42) << algorithm;
+        EXPECT_TRUE(std::is_sorted(zeros.first, zeros.second, [](double a, double b) {
+            return std::signbit(a) && !std::signbit(b);
+        })) << algorithm;
+        EXPECT_TRUE(std::signbit(*zeros.first)) << algorithm;
+        EXPECT_FALSE(std::signbit(*(zeros.second - 1))) << algorithm;
+
+        EXPECT_TRUE(executor.run(input).error.empty());
+    }
+    std::remove(input.c_str());
+    std::remove(sorted.c_str());
+}
+
+// The probe sees heap allocations of the region; the in-memory run reports parse and sort separately
+TEST(SortExecutorTest, ReportsMemoryPerPhase) {
+    MemoryProbe probe;
+    probe.start();
+    std::vector<int> block(1 << 20, 1);
+    MemoryUsage usage = probe.stop();
+    EXPECT_EQ(block.back(), 1);
+    EXPECT_GE(usage.allocations, 1u);
+    EXPECT_GE(usage.bytesAllocated, block.size() * sizeof(int));
+    if (usage.peakHeapBytes) {
+        EXPECT_GE(*usage.peakHeapBytes, block.size() * sizeof(int));
+    }
+    EXPECT_NE(usage.format().find("alloc_bytes="), std::string::npos);
+
+    std::string input = ::testing::TempDir() + "memory_input.txt";
+    {
+        DatasetWriter<int> writer(input);
+        writer.write(randomVector(50000, 45));
+        writer.close();
+    }
+    SortExecutor<int> executor(std::make_unique<PdqSort<int>>());
+    SortReport report = executor.run(input);
+    ASSERT_TRUE(report.error.empty()) << report.error;
+    ASSERT_EQ(report.memory.size(), 2u);
+    EXPECT_EQ(report.memory[0].phase, "parse");
+    EXPECT_GE(report.memory[0].usage.bytesAllocated, 50000 * sizeof(int));
+    EXPECT_EQ(report.memory[1].phase, "sort");
+
+    report = executor.run(input, ::testing::TempDir() + "memory_sorted.txt");
+    ASSERT_EQ(report.memory.size(), 1u);
+    EXPECT_EQ(report.memory[0].phase, "pipeline");
+    std::remove(input.c_str());
+    std::remove((::testing::TempDir() + "memory_sorted.txt").c_str());
+}
+
+// A strategy failing with a non-runtime_error exception ends up in the report, in memory and pipelined
+TEST(SortExecutorTest, ReportsAnyStandardException) {
+    struct FailingSort : SortStrategy<int> {
+        void sort(std::vector<int>&) override { throw std::length_error("too long"); }
+        std::string getName() const override { return "Failing"; }
+    };
+    std::string input = ::testing::TempDir() + "failing_input.txt";
+    std::string sorted = ::testing::TempDir() + "failing_sorted.txt";
+    {
+        DatasetWriter<int> writer(input);
+        writer.write(randomVector(100, 46));
+        writer.close();
+    }
+    SortExecutor<int> executor(std::make_unique<FailingSort>());
+    EXPECT_EQ(executor.run(input).error, "too long");
+    EXPECT_EQ(executor.run(input, sorted).error, "too long");
+    std::remove(input.c_str());
+    std::remove(sorted.c_str());
+}
+
+// A manifest batch sorts every listed file, keeps input order and reports a missing file as an error
+TEST(SortExecutorTest, BatchRunsManifestAndWritesReport) {
+    std::filesystem::path directory = std::filesystem::path(::testing::TempDir()) / "batch_sort_test";
+    std::filesystem::create_directories(directory / "sorted");
+    std::vector<std::vector<int>> datasets = {randomVector(5000, 1), randomVector(12000, 2), randomVector(1, 3)};
+    {
+        std::ofstream manifest(directory / "manifest.txt");
+        manifest << "# inputs\n\n";
+        for (size_t i = 0; i < datasets.size(); ++i) {
+            std::string name = "input" + std::to_string(i) + (i == 1 ? ".bin" : ".txt");
+            DatasetWriter<int> writer((directory / name).string());
+            writer.write(datasets[i]);
+            writer.close();
+            manifest << name << "\n";
+        }
+        manifest << "missing.txt\n";
+    }
+
+    std::vector<std::string> inputs = listBatchInputs((directory / "manifest.txt").string());
+    ASSERT_EQ(inputs.size(), 4u);
+    EXPECT_EQ(inputs[0], (directory / "input0.txt").string());
+
+    BatchOptions options;
+    options.sort.algorithm = "pdq";
+    options.sort.threads = 1;
+    options.jobs = 2;
+    // Smaller than the largest job, which then has to run alone
+    options.memoryBudgetBytes = 64 * 1024;
+    options.sortedDirectory = directory / "sorted";
+    std::vector<SortReport> reports = runBatch<int>(inputs, options);
+    ASSERT_EQ(reports.size(), 4u);
+    for (size_t i = 0; i < datasets.size(); ++i) {
+        EXPECT_EQ(reports[i].inputFilename, inputs[i]);
+        EXPECT_TRUE(reports[i].error.empty()) << reports[i].error;
+        EXPECT_EQ(reports[i].size, datasets[i].size());
+        // Concurrent jobs share one process-wide measurement
+        ASSERT_EQ(reports[i].memory.size(), 1u);
+        EXPECT_EQ(reports[i].memory[0].phase, BATCH_MEMORY_PHASE);
+        std::sort(datasets[i].begin(), datasets[i].end());
+    }
+    EXPECT_FALSE(reports[3].error.empty());
+    EXPECT_EQ(readBinaryDataset<int>((directory / "sorted" / "input1.bin").string()), datasets[1]);
+
+    std::string csv = (directory / "report.csv").string();
+    writeBatchReport(csv, reports);
+    std::ifstream csvFile(csv);
+    std::string line;
+    std::vector<std::string> lines;
+    while (std::getline(csvFile, line)) {
+        lines.push_back(line);
+    }
+    ASSERT_EQ(lines.size(), reports.size() + 1);
+    EXPECT_NE(lines[0].find(",memory_scope,allocations,bytes_allocated,peak_heap_bytes,peak_rss_bytes,error"),
+              std::string::npos);
+    EXPECT_NE(lines[1].find(",batch,"), std::string::npos);
+
+    std::string json = (directory / "report.json").string();
+    writeBatchReport(json, reports);
+    std::ifstream jsonFile(json);
+    std::string contents((std::istreambuf_iterator<char>(jsonFile)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(contents.front(), '[');
+    EXPECT_NE(contents.find("\"algorithm\": \"Pattern-Defeating Quicksort\""), std::string::npos);
+    EXPECT_NE(contents.find("\"memory_scope\": \"batch\", \"allocations\": "), std::string::npos);
+
+    // One job at a time measures every file on its own
+    options.jobs = 1;
+    options.sortedDirectory.clear();
+    reports = runBatch<int>(inputs, options);
+    EXPECT_EQ(reports[0].memory.size(), 2u);
+    writeBatchReport(csv, reports);
+    std::ifstream sequentialCsv(csv);
+    std::getline(sequentialCsv, line);
+    std::getline(sequentialCsv, line);
+    EXPECT_NE(line.find(",file,"), std::string::npos);
+
+    EXPECT_EQ(listBatchInputs((directory / "sorted").string()).size(), datasets.size());
+    std::filesystem::remove_all(directory);
+}
+
+// Inputs with the same file name in different directories are not sorted into one file
+TEST(SortExecutorTest, BatchKeepsSameNamedInputsApart) {
+    std::filesystem::path directory = std::filesystem::path(::testing::TempDir()) / "batch_names_test";
+    std::filesystem::create_directories(directory / "a");
+    std::filesystem::create_directories(directory / "b");
+    std::filesystem::create_directories(directory / "sorted");
+    std::vector<std::vector<int>> datasets = {{3, 1, 2}, {9, 7, 8}, {5, 4}};
+    std::vector<std::string> inputs = {(directory / "a" / "data.bin").string(),
+                                       (directory / "b" / "data.bin").string(), (directory / "other.bin").string()};
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        DatasetWriter<int> writer(inputs[i]);
+        writer.write(datasets[i]);
+        writer.close();
+        std::sort(datasets[i].begin(), datasets[i].end());
+    }
+
+    BatchOptions options;
+    options.sort.algorithm = "pdq";
+    options.jobs = 1;
+    options.sortedDirectory = directory / "sorted";
+    std::vector<SortReport> reports = runBatch<int>(inputs, options);
+    EXPECT_EQ(reports[0].sortedFilename, (directory / "sorted" / "data.0.bin").string());
+    EXPECT_EQ(reports[1].sortedFilename, (directory / "sorted" / "data.1.bin").string());
+    EXPECT_EQ(reports[2].sortedFilename, (directory / "sorted" / "other.bin").string());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        EXPECT_TRUE(reports[i].error.empty()) << reports[i].error;
+        EXPECT_EQ(readBinaryDataset<int>(reports[i].sortedFilename), datasets[i]);
+    }
+
+    // A suffixed name that another input already has cannot be resolved
+    inputs[2] = (directory / "data.1.bin").string();
+    EXPECT_THROW(runBatch<int>(inputs, options), std::invalid_argument);
+    std::filesystem::remove_all(directory);
+}
+
+// Shared prefixes longer than one level, prefixes of each other, empty strings and zero bytes
+TEST(StringSortTest, MatchesStdSort) {
+    std::mt19937 rng(7);
+    std::vector<std::string> prefixes = {"", "a", "abcdefg", "abcdefgh", "abcdefghijklmnopqrstuvwxyz", "zz"};
+    std::uniform_int_distribution<size_t> anyPrefix(0, prefixes.size() - 1);
+    std::uniform_int_distribution<size_t> suffixLength(0, 12);
+    std::uniform_int_distribution<int> anyByte(0, 3);
+    std::vector<std::string> storage;
+    for (int i = 0; i < 20000; ++i) {
+        std::string key = prefixes[anyPrefix(rng)];
+        for (size_t n = suffixLength(rng); n > 0; --n) {
+            key.push_back(static_cast<char>("\0a\xff" "b"[anyByte(rng)]));
+        }
+        storage.push_back(key);
+    }
+    for (const auto& name : lineSortStrategyNames()) {
+        SortOptions options;
+        options.algorithm = name;
+        std::vector<std::string_view> keys(storage.begin(), storage.end());
+        std::vector<std::string_view> expected = keys;
+        std::sort(expected.begin(), expected.end());
+        makeLineSortStrategy(options)->sort(keys);
+        EXPECT_EQ(keys, expected) << name;
+    }
+    SortOptions unknown;
+    unknown.algorithm = "radix";
+    EXPECT_THROW(makeLineSortStrategy(unknown), std::invalid_argument);
+}
+
+TEST(StringSortTest, ExecutorSortsLinesOfFile) {
+    std::string input = ::testing::TempDir() + "string_sort_input.txt";
+    std::string sorted = ::testing::TempDir() + "string_sort_sorted.txt";
+    {
+        std::ofstream out(input, std::ios::binary);
+        out << "pear\napple\n\nbanana\napple pie\nApple";
+    }
+    EXPECT_EQ(splitLines("a\n\nb").size(), 3u);
+    EXPECT_EQ(splitLines("a\n").size(), 1u);
+
+    LineSortExecutor executor(std::make_unique<MultikeyQuicksort>());
+    SortReport report = executor.run(input, sorted);
+    EXPECT_TRUE(report.error.empty()) << report.error;
+    EXPECT_EQ(report.size, 6u);
+    std::ifstream in(sorted, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(contents, "\nApple\napple\napple pie\nbanana\npear\n");
+
+    EXPECT_FALSE(executor.run(::testing::TempDir() + "string_sort_missing.txt").error.empty());
+    std::remove(input.c_str());
+    std::remove(sorted.c_str());
+}
+
+// Median-of-3 killer for the three-way partition: the first and middle key of the
+// next 200 ranges left to partition get the two smallest values, so each of those
+// steps only splits off two keys. That outlasts the partition budget, and PdqSort
+// finishes the rest.
+TEST(StringSortTest, MultikeySurvivesMedianOf3Killer) {
+    const size_t n = 100000;
+    const size_t unassigned = n;
+    std::vector<size_t> values(n, unassigned);
+    std::vector<size_t> slots(n);  // slots[k]: the key now at position k
+    std::iota(slots.begin(), slots.end(), 0);
+    size_t next = 0;
+    for (size_t step = 0, begin = 0; step < 200; ++step) {
+        size_t* a = slots.data() + begin;
+        size_t size = n - begin;
+        values[a[0]] = next++;
+        values[a[size / 2]] = next++;
+        size_t pivot = next - 1;
+        size_t lt = 0;
+        size_t i = 0;
+        size_t gt = size;
+        while (i < gt) {
+            if (values[a[i]] < pivot) {
+                std::swap(a[lt++], a[i++]);
+            } else if (values[a[i]] > pivot) {
+                std::swap(a[i], a[--gt]);
+            } else {
+                ++i;
+            }
+        }
+        begin += gt;
+    }
+    std::vector<std::string> strings(n);
+    for (size_t k = 0; k < n; ++k) {
+        char text[8];
+        std::snprintf(text, sizeof(text), "%06zu", values[k] == unassigned ? next++ : values[k]);
+        strings[k] = text;
+    }
+    std::vector<std::string_view> keys(strings.begin(), strings.end());
+    std::vector<std::string_view> expected = keys;
+    std::sort(expected.begin(), expected.end());
+    MultikeyQuicksort().sort(keys);
+    EXPECT_EQ(keys, expected);
+}
+
+// Every distribution is reproducible and sortable by every strategy, directly and indirectly
+TEST(InputDistributionsTest, AllDistributionsSort) {
+    for (const auto& name : distributionNames()) {
+        Distribution distribution = parseDistribution(name);
+        EXPECT_EQ(distributionName(distribution), name);
+        std::vector<int> values = generateDistribution<int>(distribution, 5000, 16);
+        EXPECT_EQ(values, generateDistribution<int>(distribution, 5000, 16));
+        std::vector<int> expected = values;
+        std::sort(expected.begin(), expected.end());
+        for (const auto& algorithm : sortStrategyNames()) {
+            for (bool indirect : {false, true}) {
+                SortOptions options;
+                options.algorithm = algorithm;
+                options.indirect = indirect;
+                std::vector<int> sorted = values;
+                makeSortStrategy<int>(options)->sort(sorted);
+                EXPECT_EQ(sorted, expected) << name << " / " << algorithm << (indirect ? " (indirect)" : "");
+            }
+        }
+    }
+    EXPECT_THROW(parseDistribution("gaussian"), std::invalid_argument);
+}
+
+// The Feistel permutation is a bijection, including domains that need cycle-walking
+TEST(InputDistributionsTest, UniquePermutationIsBijective) {
+    for (uint64_t domain : {1ull, 2ull, 3ull, 1000ull, 4097ull}) {
+        UniquePermutation permutation(domain, 21);
+        std::set<uint64_t> seen;
+        for (uint64_t i = 0; i < domain; ++i) {
+            uint64_t value = permutation(i);
+            EXPECT_LT(value, domain);
+            seen.insert(value);
+        }
+        EXPECT_EQ(seen.size(), domain);
+    }
+    EXPECT_THROW(UniquePermutation(0, 1), std::invalid_argument);
+}
+
+// Blocks are independent, unique keys stay distinct and parameters are honoured
+TEST(InputDistributionsTest, GeneratorOptions) {
+    DistributionOptions options;
+    options.domain = 300000;
+    constexpr size_t BLOCK = DistributionGenerator<int64_t>::BLOCK_SIZE;
+    // Blocks generated back to front concatenate to the single front-to-back pass
+    for (const auto& name : distributionNames()) {
+        DistributionGenerator<int64_t> generator(parseDistribution(name), 250000, options);
+        std::vector<int64_t> forward(generator.count());
+        for (uint64_t block = 0; block < generator.blockCount(); ++block) {
+            generator.generateBlock(block, forward.data() + block * BLOCK);
+        }
+        std::vector<int64_t> backward(generator.count());
+        for (uint64_t block = generator.blockCount(); block-- > 0;) {
+            generator.generateBlock(block, backward.data() + block * BLOCK);
+        }
+        EXPECT_EQ(backward, forward) << name;
+    }
+
+    DistributionGenerator<int64_t> unique(Distribution::Unique, 250000, options);
+    std::vector<int64_t> keys(unique.count());
+    for (uint64_t block = unique.blockCount(); block-- > 0;) {
+        unique.generateBlock(block, keys.data() + block * BLOCK);
+    }
+    EXPECT_EQ(std::set<int64_t>(keys.begin(), keys.end()).size(), keys.size());
+    EXPECT_LT(*std::max_element(keys.begin(), keys.end()), 300000);
+    EXPECT_THROW(DistributionGenerator<int64_t>(Distribution::Unique, 300001, options), std::invalid_argument);
+
+    options.swaps = 3;
+    DistributionGenerator<int> nearlySorted(Distribution::NearlySorted, 1000, options);
+    std::vector<int> values(1000);
+    nearlySorted.generateBlock(0, values.data());
+    std::vector<int> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    size_t displaced = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        displaced += values[i] != sorted[i];
+    }
+    EXPECT_LE(displaced, 6u);
+
+    options.uniqueKeys = 5;
+    DistributionGenerator<int> fewUnique(Distribution::FewUnique, 1000, options);
+    fewUnique.generateBlock(0, values.data());
+    EXPECT_LE(std::set<int>(values.begin(), values.end()).size(), 5u);
+
+    // The Zipf exponent is only checked when Zipf keys are drawn
+    options.zipfExponent = 0.0;
+    EXPECT_NO_THROW(DistributionGenerator<int>(Distribution::Random, 1000, options));
+    EXPECT_THROW(DistributionGenerator<int>(Distribution::Zipf, 1000, options), std::invalid_argument);
+}
@@ -3,65 +3,423 @@
 //
 
 #include "sort_algorithms.h"
+#include "data_reader.h"
+#include "binary_dataset.h"
+#include "data_writer.h"
+#include "external_sort.h"
 #include <fstream>
+#include <stdexcept>
 #include <iostream>
 #include <chrono>
+#include <sstream>
+
+namespace {
+    using Clock = std::chrono::high_resolution_clock;
+
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    std::string describeQuery(const SelectionQuery& query) {
+        std::string name = "Selection (";
+        if (query.topK > 0) {
+            name += "top " + std::to_string(query.topK) + (query.quantiles.empty() ? "" : ", ");
+        }
+        if (!query.quantiles.empty()) {
+            name += std::to_string(query.quantiles.size()) + " quantiles";
+        }
+        return name + ")";
+    }
+
+    // The k-th smallest and the quantiles as "k-th smallest (k=10): 42, p50=..., p99=..."
+    template <typename T>
+    std::string describeAnswer(const SelectionQuery& query, const SelectionResult<T>& result) {
+        std::ostringstream out;
+        if (!result.smallest.empty()) {
+            out << "k-th smallest (k=" << result.smallest.size() << "): " << result.smallest.back();
+        }
+        for (size_t i = 0; i < result.quantiles.size(); ++i) {
+            out << (i > 0 || !result.smallest.empty() ? ", " : "") << "p" << query.quantiles[i] * 100 << "="
+                << result.quantiles[i];
+        }
+        return out.str();
+    }
+
+    // "parse: allocs=..., ...; sort: allocs=..., ..."
+    std::string formatMemory(const std::vector<PhaseMemory>& phases) {
+        std::string text;
+        for (const auto& phase : phases) {
+            text += (text.empty() ? "" : "; ") + phase.phase + ": " + phase.usage.format();
+        }
+        return text;
+    }
+}
 
 template <typename T>
-void SortExecutor<T>::execute(const std::string& inputFilename, const std::string& outputFilename) {
-    std::vector<T> data = readData(inputFilename);
-    if (data.empty()) {
+SortReport SortExecutor<T>::run(const std::string& inputFilename, const std::string& sortedFilename) {
+    SortReport report;
+    report.inputFilename = inputFilename;
+    report.sortedFilename = sortedFilename;
+    report.algorithm = strategy_->getName();
+    try {
+        if (sortedFilename.empty()) {
+            runInMemory(report);
+        } else {
+            runPipelined(report);
+        }
+    } catch (const std::exception& e) {
+        report.error = e.what();
+    }
+    return report;
+}
+
+template <typename T>
+void SortExecutor<T>::execute(const std::string& inputFilename, const std::string& outputFilename,
+                              const std::string& sortedFilename) {
+    SortReport report = run(inputFilename, sortedFilename);
+    if (!report.error.empty()) {
+        std::cerr << "Error: " << report.error << std::endl;
         return;
     }
+    if (report.size == 0) {
+        return;
+    }
+    printSortReport(report);
+    appendSortReport(report, outputFilename);
+}
 
-    double elapsed = measureSortTime(data);
-    writeOutput(inputFilename, data.size(), elapsed, outputFilename);
+template <typename T>
+SortReport SortExecutor<T>::select(const std::string& inputFilename, const SelectionQuery& query,
+                                   SelectionResult<T>& result) {
+    SortReport report;
+    report.inputFilename = inputFilename;
+    report.algorithm = describeQuery(query);
+    PhaseTimings& timings = report.timings;
+    try {
+        MemoryProbe memory;
+        if (measureMemory_) {
+            memory.start();
+        }
+        PerfCounterGroup perf;
+        report.countersUnavailable = perf.unavailableReason();
+        perf.start();
+        auto start = Clock::now();
+        TopK<T> topK(query.topK);
+        if (query.quantiles.empty()) {
+            // Only the top k are asked for, so the input never has to be in memory as a whole
+            NaNKeys<T> nans;
+            readChunks(inputFilename, timings, [&](std::vector<T>&& chunk) {
+                report.size += chunk.size();
+                auto selectStart = Clock::now();
+                nans.extract(chunk);
+                topK.push(chunk);
+                timings.sort += secondsSince(selectStart);
+            });
+        } else {
+            auto parseStart = Clock::now();
+            std::vector<T> data = readData(inputFilename);
+            timings.parse = secondsSince(parseStart);
+            report.size = data.size();
+            NaNKeys<T> nans;
+            nans.extract(data);
+            if (!data.empty()) {
+                auto selectStart = Clock::now();
+                topK.push(data);
+                result.quantiles = Selection<T>::quantiles(data, query.quantiles);
+                timings.sort = secondsSince(selectStart);
+            }
+        }
+        result.smallest = topK.result();
+        orderSignedZeros(result.smallest);
+        timings.total = secondsSince(start);
+        report.counters = perf.stop();
+        if (measureMemory_) {
+            report.memory.push_back({"select", memory.stop()});
+        }
+    } catch (const std::exception& e) {
+        report.error = e.what();
+    }
+    return report;
 }
 
 template <typename T>
-std::vector<T> SortExecutor<T>::readData(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open file " << filename << std::endl;
-        return {};
+void SortExecutor<T>::executeSelection(const std::string& inputFilename, const std::string& outputFilename,
+                                       const SelectionQuery& query, const std::string& sortedFilename) {
+    SelectionResult<T> result;
+    SortReport report = select(inputFilename, query, result);
+    if (!report.error.empty()) {
+        std::cerr << "Error: " << report.error << std::endl;
+        return;
+    }
+    if (report.size == 0) {
+        return;
     }
 
-    std::string line;
-    std::vector<T> vecs;
-    while (std::getline(file, line)) {
-        if (line.empty()) {
+    std::string answer = describeAnswer(query, result);
+    std::cout << "Time taken: " << report.timings.total << "s (select " << report.timings.sort << "s, parse "
+              << report.timings.parse << "s)" << std::endl;
+    std::cout << answer << std::endl;
+    if (report.countersUnavailable.empty()) {
+        std::cout << "Counters: " << report.counters.format() << std::endl;
+    } else {
+        std::cout << "Counters unavailable (" << report.countersUnavailable << ")" << std::endl;
+    }
+    std::cout << "Memory: " << formatMemory(report.memory) << std::endl;
+    if (!sortedFilename.empty() && !result.smallest.empty()) {
+        DatasetWriter<T> writer(sortedFilename);
+        writer.write(result.smallest);
+        writer.close();
+    }
+    writeSelectionOutput(report, answer, outputFilename);
+}
+
+template <typename T>
+void SortExecutor<T>::runInMemory(SortReport& report) {
+    MemoryProbe memory;
+    if (measureMemory_) {
+        memory.start();
+    }
+    auto parseStart = Clock::now();
+    std::vector<T> data = readData(report.inputFilename);
+    report.timings.parse = secondsSince(parseStart);
+    if (measureMemory_) {
+        report.memory.push_back({"parse", memory.stop()});
+    }
+    report.size = data.size();
+    if (data.empty()) {
+        return;
+    }
+    // Nothing is written in this mode, so the NaNs are only kept away from the strategy
+    NaNKeys<T> nans;
+    nans.extract(data);
+    if (measureMemory_) {
+        memory.start();
+    }
+    report.timings.sort = measureSortTime(data, report);
+    if (measureMemory_) {
+        report.memory.push_back({"sort", memory.stop()});
+    }
+    report.timings.total = report.timings.parse + report.timings.sort;
+}
+
+template <typename T>
+void SortExecutor<T>::runPipelined(SortReport& report) {
+    // The counters cover the whole pipeline, including the reader and writer threads it starts
+    MemoryProbe memory;
+    if (measureMemory_) {
+        memory.start();
+    }
+    PerfCounterGroup perf;
+    report.countersUnavailable = perf.unavailableReason();
+    perf.start();
+    auto start = Clock::now();
+    NaNKeys<T> nans;
+    std::vector<std::vector<T>> chunks = sortChunks(report.inputFilename, nans, report.timings);
+    report.size = nans.size();
+    for (const auto& chunk : chunks) {
+        report.size += chunk.size();
+    }
+    writeMerged(chunks, nans, report.sortedFilename, report.timings);
+    report.timings.total = secondsSince(start);
+    report.counters = perf.stop();
+    if (measureMemory_) {
+        report.memory.push_back({"pipeline", memory.stop()});
+    }
+}
+
+template <typename T>
+template <typename Consume>
+void SortExecutor<T>::readChunks(const std::string& filename, PhaseTimings& timings, Consume consume) {
+    ChunkSource<T> source(filename, MAX_REPORTED_ERRORS);
+    auto readChunk = [this, &source] {
+        std::vector<T> chunk;
+        chunk.reserve(pipelineChunkElements_);
+        source.read(chunk, pipelineChunkElements_);
+        return chunk;
+    };
+
+    // One reader thread serves the whole file; only one read is in flight at a time,
+    // so the source is never used concurrently
+    WorkStealingPool reader(1);
+    std::vector<T> next;
+    TaskGroup pendingRead(reader);
+    pendingRead.run([&] { next = readChunk(); });
+    while (true) {
+        auto waitStart = Clock::now();
+        pendingRead.wait();
+        timings.parse += secondsSince(waitStart);
+        if (next.empty()) {
             break;
         }
-        try {
-            vecs.push_back(std::stoi(line));
-        } catch (const std::invalid_argument& e) {
-            std::cerr << "Invalid arguments\n";
+        std::vector<T> chunk = std::move(next);
+        next.clear();
+        pendingRead.run([&] { next = readChunk(); });
+        consume(std::move(chunk));
+    }
+}
+
+template <typename T>
+std::vector<std::vector<T>> SortExecutor<T>::sortChunks(const std::string& filename, NaNKeys<T>& nans,
+                                                        PhaseTimings& timings) {
+    std::vector<std::vector<T>> chunks;
+    readChunks(filename, timings, [&](std::vector<T>&& chunk) {
+        auto sortStart = Clock::now();
+        nans.extract(chunk);
+        strategy_->sort(chunk, *scratch_);
+        orderSignedZeros(chunk);
+        timings.sort += secondsSince(sortStart);
+        chunks.push_back(std::move(chunk));
+    });
+    return chunks;
+}
+
+template <typename T>
+void SortExecutor<T>::writeMerged(std::vector<std::vector<T>>& chunks, const NaNKeys<T>& nans,
+                                  const std::string& sortedFilename, PhaseTimings& timings) {
+    DatasetWriter<T> writer(sortedFilename);
+    // Two blocks alternate: the merge fills one while the writer formats and writes the other
+    std::vector<T> blocks[2];
+    size_t current = 0;
+    // One writer thread takes every block, and at most one write is queued at a time
+    WorkStealingPool writerThread(1);
+    TaskGroup pendingWrite(writerThread);
+    auto emit = [&](const T* values, size_t count) {
+        auto waitStart = Clock::now();
+        pendingWrite.wait();
+        timings.write += secondsSince(waitStart);
+        pendingWrite.run([&writer, values, count] { writer.write(values, count); });
+    };
+
+    auto mergeStart = Clock::now();
+    if (!nans.negative.empty()) {
+        emit(nans.negative.data(), nans.negative.size());
+    }
+    if (chunks.size() == 1) {
+        // Nothing to merge, the writer streams the sorted chunk in blocks
+        const std::vector<T>& chunk = chunks.front();
+        for (size_t offset = 0; offset < chunk.size(); offset += OUTPUT_BLOCK_ELEMENTS) {
+            emit(chunk.data() + offset, std::min(OUTPUT_BLOCK_ELEMENTS, chunk.size() - offset));
+        }
+    } else if (chunks.size() > 1) {
+        std::vector<size_t> positions(chunks.size(), 0);
+        auto less = [&chunks, &positions](size_t a, size_t b) {
+            if (a >= chunks.size() || positions[a] == chunks[a].size()) {
+                return false;
+            }
+            if (b >= chunks.size() || positions[b] == chunks[b].size()) {
+                return true;
+            }
+            return signedZeroLess(chunks[a][positions[a]], chunks[b][positions[b]]);
+        };
+        LoserTree<decltype(less)> tree(chunks.size(), less);
+
+        blocks[0].reserve(OUTPUT_BLOCK_ELEMENTS);
+        blocks[1].reserve(OUTPUT_BLOCK_ELEMENTS);
+        while (true) {
+            size_t source = tree.winner();
+            if (positions[source] == chunks[source].size()) {
+                break;
+            }
+            blocks[current].push_back(chunks[source][positions[source]++]);
+            tree.replay(source);
+            if (blocks[current].size() == OUTPUT_BLOCK_ELEMENTS) {
+                emit(blocks[current].data(), blocks[current].size());
+                current ^= 1;
+                // The writer finished this block before the previous emit returned
+                blocks[current].clear();
+            }
         }
+        emit(blocks[current].data(), blocks[current].size());
+    }
+    if (!nans.positive.empty()) {
+        emit(nans.positive.data(), nans.positive.size());
     }
-    file.close();
+    // So far write only holds the stalls inside the merge
+    timings.sort += secondsSince(mergeStart) - timings.write;
+
+    auto drainStart = Clock::now();
+    pendingWrite.wait();
+    writer.close();
+    timings.write += secondsSince(drainStart);
+}
+
+template <typename T>
+std::vector<T> SortExecutor<T>::readData(const std::string& filename) {
+    if (isBinaryDatasetPath(filename)) {
+        return readBinaryDataset<T>(filename);
+    }
+
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        throw std::runtime_error("Could not open file " + filename);
+    }
+
+    std::vector<T> vecs;
+    std::vector<ParseError> errors;
+    parseNumbers(file.contents(), vecs, errors);
+
+    reportParseErrors(filename, errors, MAX_REPORTED_ERRORS, errors.size());
     return vecs;
 }
 
 template <typename T>
-double SortExecutor<T>::measureSortTime(std::vector<T>& data) {
-    auto start = std::chrono::high_resolution_clock::now();
-    strategy_->sort(data);
-    auto end = std::chrono::high_resolution_clock::now();
+double SortExecutor<T>::measureSortTime(std::vector<T>& data, SortReport& report) {
+    PerfCounterGroup perf;
+    report.countersUnavailable = perf.unavailableReason();
+    perf.start();
+    auto start = Clock::now();
+    strategy_->sort(data, *scratch_);
+    auto end = Clock::now();
+    report.counters = perf.stop();
     std::chrono::duration<double> elapsed = end - start;
-    std::cout << "Time taken: " << elapsed.count() << "s" << std::endl;
     return elapsed.count();
 }
 
 template <typename T>
-void SortExecutor<T>::writeOutput(const std::string& filename, size_t size, double elapsed, const std::string& outputFilename) {
+void SortExecutor<T>::writeSelectionOutput(const SortReport& report, const std::string& answer,
+                                           const std::string& outputFilename) {
     std::ofstream outfile(outputFilename, std::ios::app);
     if (outfile.is_open()) {
-        outfile << "Algorithm: " << strategy_->getName() << ", File: " << filename << ", Size: " << size << ", Time: " << elapsed << "s" << std::endl;
+        outfile << "Algorithm: " << report.algorithm << ", File: " << report.inputFilename << ", Size: " << report.size
+                << ", Time: " << report.timings.sort << "s, Parse: " << report.timings.parse << "s, " << answer << ", "
+                << report.counters.format() << ", " << formatMemory(report.memory) << std::endl;
+        outfile.close();
+    } else {
+        std::cerr << "Unable to open output file: " << outputFilename << std::endl;
+    }
+}
+
+void printSortReport(const SortReport& report) {
+    const PhaseTimings& timings = report.timings;
+    if (report.sortedFilename.empty()) {
+        std::cout << "Time taken: " << timings.sort << "s" << std::endl;
+    } else {
+        std::cout << "Time taken: " << timings.total << "s (sort " << timings.sort << "s, waiting for parse "
+                  << timings.parse << "s, for write " << timings.write << "s)" << std::endl;
+    }
+    if (report.countersUnavailable.empty()) {
+        std::cout << "Counters: " << report.counters.format() << std::endl;
+    } else {
+        std::cout << "Counters unavailable (" << report.countersUnavailable << ")" << std::endl;
+    }
+    std::cout << "Memory: " << formatMemory(report.memory) << std::endl;
+}
+
+void appendSortReport(const SortReport& report, const std::string& outputFilename) {
+    std::ofstream outfile(outputFilename, std::ios::app);
+    if (outfile.is_open()) {
+        const PhaseTimings& timings = report.timings;
+        outfile << "Algorithm: " << report.algorithm << ", File: " << report.inputFilename << ", Size: " << report.size
+                << ", Time: " << timings.sort << "s, Parse: " << timings.parse << "s, ";
+        if (!report.sortedFilename.empty()) {
+            outfile << "Write: " << timings.write << "s, Total: " << timings.total << "s, ";
+        }
+        outfile << report.counters.format() << ", " << formatMemory(report.memory) << std::endl;
         outfile.close();
     } else {
         std::cerr << "Unable to open output file: " << outputFilename << std::endl;
     }
 }
 
-// Explicit instantiation for int
-template class SortExecutor<int>;
\ No newline at end of file
+#define INSTANTIATE_SORT_EXECUTOR_KEY(K) template class SortExecutor<K>;
+SORT_KEY_TYPES(INSTANTIATE_SORT_EXECUTOR_KEY)
@@ -0,0 +1,58 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "sort_algorithms.h"
+#include <stdexcept>
+
+std::vector<std::string> sortStrategyNames() {
+    return {"insertion", "parallel_merge", "radix", "pdq", "pdq_network", "network_merge", "tim"};
+}
+
+template <typename T>
+std::unique_ptr<SortStrategy<T>> makeSortStrategy(const SortOptions& options) {
+    if (options.indirect) {
+        using Key = typename KeyProjection<T>::Key;
+        if constexpr (std::is_integral_v<Key> && sizeof(Key) == 4) {
+            SortOptions keyOptions = options;
+            keyOptions.indirect = false;
+            return std::make_unique<IndirectSort<T>>(makeSortStrategy<uint64_t>(keyOptions));
+        } else {
+            throw std::invalid_argument("Indirect mode needs 32-bit integer keys");
+        }
+    }
+    if (options.algorithm == "insertion") {
+        return std::make_unique<InsertionSort<T>>();
+    }
+    if (options.algorithm == "parallel_merge") {
+        size_t cutoff = options.cutoff ? options.cutoff : ParallelMergeSort<T>::DEFAULT_CUTOFF;
+        return std::make_unique<ParallelMergeSort<T>>(options.threads, cutoff);
+    }
+    if (options.algorithm == "radix") {
+        if constexpr (std::is_arithmetic_v<T>) {
+            return std::make_unique<RadixSort<T>>();
+        } else {
+            throw std::invalid_argument("radix only sorts plain keys directly, use the indirect mode");
+        }
+    }
+    if (options.algorithm == "pdq") {
+        return std::make_unique<PdqSort<T>>(options.cutoff ? options.cutoff : PdqSort<T>::DEFAULT_THRESHOLD);
+    }
+    if (options.algorithm == "pdq_network") {
+        return std::make_unique<PdqSort<T>>(options.cutoff ? options.cutoff : SmallSortKernel<T>::MAX_SIZE, true);
+    }
+    if (options.algorithm == "network_merge") {
+        return std::make_unique<NetworkMergeSort<T>>();
+    }
+    if (options.algorithm == "tim") {
+        return std::make_unique<TimSort<T>>();
+    }
+    throw std::invalid_argument("Unknown sort algorithm: " + options.algorithm);
+}
+
+#define INSTANTIATE_MAKE_SORT_STRATEGY_KEY(K) \
+    template std::unique_ptr<SortStrategy<K>> makeSortStrategy<K>(const SortOptions& options);
+SORT_KEY_TYPES(INSTANTIATE_MAKE_SORT_STRATEGY_KEY)
+#define INSTANTIATE_MAKE_SORT_STRATEGY(P) \
+    template std::unique_ptr<SortStrategy<Record<P>>> makeSortStrategy<Record<P>>(const SortOptions& options);
+SORT_RECORD_PAYLOADS(INSTANTIATE_MAKE_SORT_STRATEGY)
@@ -0,0 +1,173 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "sorting_network.h"
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <stdexcept>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define SORTING_NETWORK_HAS_AVX2 1
+#endif
+
+namespace {
+    // Bitonic network over memory: stage (k, j) compare-exchanges i with i ^ j,
+    // ascending where bit k of i is clear. std::min/std::max compile to
+    // conditional moves, so there is no data-dependent branch.
+    template <size_t N>
+    void bitonicScalar(int* data) {
+        for (size_t k = 2; k <= N; k <<= 1) {
+            for (size_t j = k >> 1; j > 0; j >>= 1) {
+                for (size_t i = 0; i < N; ++i) {
+                    size_t partner = i ^ j;
+                    if (partner > i) {
+                        int a = data[i];
+                        int b = data[partner];
+                        int lo = std::min(a, b);
+                        int hi = std::max(a, b);
+                        bool ascending = (i & k) == 0;
+                        data[i] = ascending ? lo : hi;
+                        data[partner] = ascending ? hi : lo;
+                    }
+                }
+            }
+        }
+    }
+
+#ifdef SORTING_NETWORK_HAS_AVX2
+    // Same network with eight lanes per register. Stages with j >= 8 pair whole
+    // registers; stages with j < 8 pair lanes of one register through a permute,
+    // and a per-lane mask picks min or max depending on the lane's position and
+    // the stage direction.
+    template <size_t N>
+    __attribute__((target("avx2"))) void bitonicAvx2(int* data) {
+        constexpr size_t REGISTERS = N / 8;
+        __m256i v[REGISTERS];
+        for (size_t r = 0; r < REGISTERS; ++r) {
+            v[r] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 8 * r));
+        }
+
+        const __m256i laneIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i zero = _mm256_setzero_si256();
+
+        for (size_t k = 2; k <= N; k <<= 1) {
+            for (size_t j = k >> 1; j > 0; j >>= 1) {
+                if (j >= 8) {
+                    const size_t step = j / 8;
+                    for (size_t r = 0; r < REGISTERS; ++r) {
+                        size_t partner = r ^ step;
+                        if (partner > r && partner < REGISTERS) {
+                            __m256i lo = _mm256_min_epi32(v[r], v[partner]);
+                            __m256i hi = _mm256_max_epi32(v[r], v[partner]);
+                            bool ascending = ((8 * r) & k) == 0;
+                            v[r] = ascending ? lo : hi;
+                            v[partner] = ascending ? hi : lo;
+                        }
+                    }
+                } else {
+                    const __m256i permutation = _mm256_xor_si256(laneIndex, _mm256_set1_epi32(static_cast<int>(j)));
+                    for (size_t r = 0; r < REGISTERS; ++r) {
+                        __m256i index = _mm256_add_epi32(laneIndex, _mm256_set1_epi32(static_cast<int>(8 * r)));
+                        // Lanes take the max when they are the upper partner of an ascending pair
+                        // or the lower partner of a descending one
+                        __m256i lower = _mm256_cmpeq_epi32(_mm256_and_si256(index, _mm256_set1_epi32(static_cast<int>(j))), zero);
+                        __m256i ascending = _mm256_cmpeq_epi32(_mm256_and_si256(index, _mm256_set1_epi32(static_cast<int>(k))), zero);
+                        __m256i takeMax = _mm256_xor_si256(lower, ascending);
+
+                        __m256i swapped = _mm256_permutevar8x32_epi32(v[r], permutation);
+                        __m256i lo = _mm256_min_epi32(v[r], swapped);
+                        __m256i hi = _mm256_max_epi32(v[r], swapped);
+                        v[r] = _mm256_blendv_epi8(lo, hi, takeMax);
+                    }
+                }
+            }
+        }
+
+        for (size_t r = 0; r < REGISTERS; ++r) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + 8 * r), v[r]);
+        }
+    }
+
+    bool detectAvx2() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+    }
+#else
+    bool detectAvx2() {
+        return false;
+    }
+#endif
+
+    using BlockKernel = void (*)(int*);
+
+    struct KernelTable {
+        bool avx2;
+        BlockKernel kernels[4];  // 8, 16, 32, 64
+    };
+
+    constexpr KernelTable SCALAR_KERNELS = {
+        false, {bitonicScalar<8>, bitonicScalar<16>, bitonicScalar<32>, bitonicScalar<64>}};
+
+    KernelTable selectKernels() {
+#ifdef SORTING_NETWORK_HAS_AVX2
+        if (detectAvx2()) {
+            return {true, {bitonicAvx2<8>, bitonicAvx2<16>, bitonicAvx2<32>, bitonicAvx2<64>}};
+        }
+#endif
+        return SCALAR_KERNELS;
+    }
+
+    // Resolved on first use, so the binary still starts on hosts without AVX2
+    const KernelTable& kernelTable() {
+        static const KernelTable table = selectKernels();
+        return table;
+    }
+
+    void sortBlockWith(const KernelTable& table, int* data, size_t n) {
+        switch (n) {
+            case 8: table.kernels[0](data); break;
+            case 16: table.kernels[1](data); break;
+            case 32: table.kernels[2](data); break;
+            case 64: table.kernels[3](data); break;
+            default: throw std::invalid_argument("Sorting network blocks hold 8, 16, 32 or 64 elements");
+        }
+    }
+}
+
+namespace SortingNetwork {
+    void sortBlock(int* data, size_t n) {
+        sortBlockWith(kernelTable(), data, n);
+    }
+
+    void sortBlockScalar(int* data, size_t n) {
+        sortBlockWith(SCALAR_KERNELS, data, n);
+    }
+
+    void sortRange(int* first, int* last) {
+        size_t n = last - first;
+        if (n < 2) {
+            return;
+        }
+        if (n > MAX_BLOCK) {
+            throw std::invalid_argument("Range is larger than the biggest sorting network");
+        }
+        size_t block = std::max(MIN_BLOCK, std::bit_ceil(n));
+        if (block == n) {
+            sortBlock(first, n);
+            return;
+        }
+        // Padding with the largest key keeps the real elements at the front
+        alignas(32) int padded[MAX_BLOCK];
+        std::copy(first, last, padded);
+        std::fill(padded + n, padded + block, INT_MAX);
+        sortBlock(padded, block);
+        std::copy(padded, padded + n, first);
+    }
+
+    bool usesAvx2() {
+        return kernelTable().avx2;
+    }
+}
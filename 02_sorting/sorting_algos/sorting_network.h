@@ -0,0 +1,32 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#ifndef ALGORITHMS_PROGRAMMING_EXERCISES_SORTING_NETWORK_H
+#define ALGORITHMS_PROGRAMMING_EXERCISES_SORTING_NETWORK_H
+
+#include <cstddef>
+
+// Branch-free bitonic sorting networks for small blocks of int.
+// The AVX2 variant keeps a whole block in 8-lane registers; a scalar
+// min/max network is used when the CPU (checked once at run time) or the
+// compiler does not provide AVX2.
+namespace SortingNetwork {
+    constexpr size_t MIN_BLOCK = 8;
+    constexpr size_t MAX_BLOCK = 64;
+
+    // Sorts exactly n ints, n being 8, 16, 32 or 64
+    void sortBlock(int* data, size_t n);
+
+    // Same as sortBlock, always on the scalar network, so the fallback can be
+    // checked on hosts that select AVX2
+    void sortBlockScalar(int* data, size_t n);
+
+    // Sorts any range of at most MAX_BLOCK ints by padding it to the next block size
+    void sortRange(int* first, int* last);
+
+    // True when the AVX2 kernels were selected on this host
+    bool usesAvx2();
+}
+
+#endif //ALGORITHMS_PROGRAMMING_EXERCISES_SORTING_NETWORK_H
@@ -0,0 +1,260 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "string_sort.h"
+#include "data_reader.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace {
+    using Clock = std::chrono::high_resolution_clock;
+
+    constexpr size_t LEVEL_BYTES = MultikeyQuicksort::BYTES_PER_LEVEL;
+    // Length tag of a string that continues past the current level
+    constexpr uint64_t CONTINUES = 8;
+    constexpr size_t WRITE_BUFFER_SIZE = 1 << 20;
+
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    using KeyedString = MultikeyQuicksort::KeyedString;
+
+    // Bytes [depth, depth + 7) in the high 56 bits, zero padded, and min(bytes left, 8)
+    // in the low byte. Among equal bytes the shorter string then orders first, and
+    // equal words with a tag below 8 mean equal strings.
+    uint64_t levelWord(std::string_view text, size_t depth) {
+        size_t remaining = text.size() > depth ? text.size() - depth : 0;
+        uint64_t word = 0;
+        if (remaining > LEVEL_BYTES) {
+            std::memcpy(&word, text.data() + depth, sizeof(word));
+            if constexpr (std::endian::native == std::endian::little) {
+                word = std::byteswap(word);
+            }
+            return (word & ~uint64_t(0xFF)) | CONTINUES;
+        }
+        for (size_t i = 0; i < remaining; ++i) {
+            word |= uint64_t(static_cast<unsigned char>(text[depth + i])) << (56 - 8 * i);
+        }
+        return word | remaining;
+    }
+
+    bool lessAtDepth(const KeyedString& a, const KeyedString& b, size_t depth) {
+        if (a.word != b.word) {
+            return a.word < b.word;
+        }
+        if ((a.word & 0xFF) != CONTINUES) {
+            return false;
+        }
+        return a.text.substr(depth + LEVEL_BYTES) < b.text.substr(depth + LEVEL_BYTES);
+    }
+
+    void insertionSort(KeyedString* a, size_t n, size_t depth) {
+        for (size_t i = 1; i < n; ++i) {
+            KeyedString current = a[i];
+            size_t j = i;
+            while (j > 0 && lessAtDepth(current, a[j - 1], depth)) {
+                a[j] = a[j - 1];
+                --j;
+            }
+            a[j] = current;
+        }
+    }
+
+    uint64_t medianOf3(uint64_t a, uint64_t b, uint64_t c) {
+        return std::max(std::min(a, b), std::min(std::max(a, b), c));
+    }
+
+    // Partitions at one level before a range is handed to PdqSort, as in introsort
+    int partitionBudget(size_t n) {
+        return 2 * std::bit_width(n);
+    }
+
+    // Sorts a[0, n) whose words hold the bytes at depth. The smaller and larger
+    // partitions stay at the same depth; the equal one continues seven bytes deeper
+    // with a fresh budget. The largest of the three is looped on and the others
+    // recurse, so the stack stays O(log n) deep.
+    void multikeySort(KeyedString* a, size_t n, size_t depth, int budget) {
+        struct Part {
+            KeyedString* a;
+            size_t n;
+            size_t depth;
+            int budget;
+        };
+        while (n >= MultikeyQuicksort::INSERTION_THRESHOLD) {
+            if (budget-- == 0) {
+                PdqSort<KeyedString>().sortRange(a, a + n);
+                return;
+            }
+            uint64_t pivot = medianOf3(a[0].word, a[n / 2].word, a[n - 1].word);
+            size_t lt = 0;
+            size_t i = 0;
+            size_t gt = n;
+            while (i < gt) {
+                if (a[i].word < pivot) {
+                    std::swap(a[lt++], a[i++]);
+                } else if (a[i].word > pivot) {
+                    std::swap(a[i], a[--gt]);
+                } else {
+                    ++i;
+                }
+            }
+
+            // Strings that end at this level and share the pivot word are equal
+            Part equal{a + lt, 0, depth + LEVEL_BYTES, 0};
+            if ((pivot & 0xFF) == CONTINUES) {
+                equal.n = gt - lt;
+                equal.budget = partitionBudget(equal.n);
+                for (size_t j = 0; j < equal.n; ++j) {
+                    equal.a[j].word = levelWord(equal.a[j].text, equal.depth);
+                }
+            }
+            Part parts[] = {{a, lt, depth, budget}, equal, {a + gt, n - gt, depth, budget}};
+            Part* largest = std::max_element(std::begin(parts), std::end(parts),
+                                             [](const Part& x, const Part& y) { return x.n < y.n; });
+            for (Part& part : parts) {
+                if (&part != largest) {
+                    multikeySort(part.a, part.n, part.depth, part.budget);
+                }
+            }
+            a = largest->a;
+            n = largest->n;
+            depth = largest->depth;
+            budget = largest->budget;
+        }
+        insertionSort(a, n, depth);
+    }
+}
+
+void MultikeyQuicksort::sort(std::vector<std::string_view>& keys, std::pmr::memory_resource& scratch) {
+    const size_t n = keys.size();
+    if (n < 2) {
+        return;
+    }
+    std::pmr::vector<KeyedString> keyed(&scratch);
+    keyed.reserve(n);
+    for (std::string_view key : keys) {
+        keyed.push_back({levelWord(key, 0), key});
+    }
+    multikeySort(keyed.data(), n, 0, partitionBudget(n));
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = keyed[i].text;
+    }
+}
+
+std::vector<std::string> lineSortStrategyNames() {
+    return {"mkqs", "pdq"};
+}
+
+std::unique_ptr<SortStrategy<std::string_view>> makeLineSortStrategy(const SortOptions& options) {
+    if (options.indirect) {
+        throw std::invalid_argument("String keys are sorted as views, the indirect mode does not apply");
+    }
+    if (options.algorithm == "mkqs") {
+        return std::make_unique<MultikeyQuicksort>();
+    }
+    if (options.algorithm == "pdq") {
+        return std::make_unique<PdqSort<std::string_view>>(options.cutoff ? options.cutoff
+                                                                          : PdqSort<std::string_view>::DEFAULT_THRESHOLD);
+    }
+    throw std::invalid_argument("Unknown string sort algorithm: " + options.algorithm);
+}
+
+std::vector<std::string_view> splitLines(std::string_view text) {
+    std::vector<std::string_view> lines;
+    lines.reserve(std::count(text.begin(), text.end(), '\n') + 1);
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        lines.push_back(text.substr(start, end - start));
+        start = end + 1;
+    }
+    return lines;
+}
+
+void writeLines(const std::string& filename, const std::vector<std::string_view>& lines) {
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Could not open output file " + filename);
+    }
+    std::string buffer;
+    buffer.reserve(WRITE_BUFFER_SIZE);
+    for (std::string_view line : lines) {
+        if (buffer.size() + line.size() + 1 > WRITE_BUFFER_SIZE && !buffer.empty()) {
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+        buffer.append(line);
+        buffer.push_back('\n');
+    }
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    out.close();
+    if (out.fail()) {
+        throw std::runtime_error("Failed to write " + filename);
+    }
+}
+
+SortReport LineSortExecutor::run(const std::string& inputFilename, const std::string& sortedFilename) {
+    SortReport report;
+    report.inputFilename = inputFilename;
+    report.sortedFilename = sortedFilename;
+    report.algorithm = strategy_->getName() + " (string keys)";
+    try {
+        MemoryProbe memory;
+        memory.start();
+        auto start = Clock::now();
+        MappedFile file(inputFilename);
+        if (!file.isOpen()) {
+            throw std::runtime_error("Could not open file " + inputFilename);
+        }
+        std::vector<std::string_view> lines = splitLines(file.contents());
+        report.size = lines.size();
+        report.timings.parse = secondsSince(start);
+        report.memory.push_back({"parse", memory.stop()});
+
+        PerfCounterGroup perf;
+        report.countersUnavailable = perf.unavailableReason();
+        memory.start();
+        perf.start();
+        auto sortStart = Clock::now();
+        strategy_->sort(lines, scratch_);
+        report.timings.sort = secondsSince(sortStart);
+        report.counters = perf.stop();
+        report.memory.push_back({"sort", memory.stop()});
+
+        if (!sortedFilename.empty()) {
+            memory.start();
+            auto writeStart = Clock::now();
+            writeLines(sortedFilename, lines);
+            report.timings.write = secondsSince(writeStart);
+            report.memory.push_back({"write", memory.stop()});
+        }
+        report.timings.total = secondsSince(start);
+    } catch (const std::exception& e) {
+        report.error = e.what();
+    }
+    return report;
+}
+
+void LineSortExecutor::execute(const std::string& inputFilename, const std::string& outputFilename,
+                               const std::string& sortedFilename) {
+    SortReport report = run(inputFilename, sortedFilename);
+    if (!report.error.empty()) {
+        std::cerr << "Error: " << report.error << std::endl;
+        return;
+    }
+    if (report.size == 0) {
+        return;
+    }
+    printSortReport(report);
+    appendSortReport(report, outputFilename);
+}
@@ -0,0 +1,81 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#ifndef ALGORITHMS_PROGRAMMING_EXERCISES_STRING_SORT_H
+#define ALGORITHMS_PROGRAMMING_EXERCISES_STRING_SORT_H
+
+#include "sort_algorithms.h"
+#include <compare>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Bentley-Sedgewick multikey quicksort over byte strings with cached key
+// prefixes. Every string carries a 64-bit word holding its next seven bytes
+// (big-endian) and, in the low byte, how many bytes are left (capped at 8).
+// A level partitions three ways on that word alone, so the strings
+// themselves are only touched when the words of the equal partition are
+// refilled for the next seven bytes. Order is bytewise, a prefix first.
+class MultikeyQuicksort : public SortStrategy<std::string_view> {
+public:
+    // Bytes compared per level; the eighth byte of the word is the length tag
+    static constexpr size_t BYTES_PER_LEVEL = 7;
+    // Ranges below this size are insertion sorted on the words
+    static constexpr size_t INSERTION_THRESHOLD = 16;
+
+    // A key with its word at the current level. Every key of a range being sorted
+    // shares the bytes before that level, so the words and then the rest of the
+    // text order it; PdqSort finishes ranges that partition badly this way.
+    struct KeyedString {
+        uint64_t word;
+        std::string_view text;
+
+        friend std::weak_ordering operator<=>(const KeyedString& a, const KeyedString& b) {
+            return a.word != b.word ? a.word <=> b.word : a.text <=> b.text;
+        }
+    };
+
+    void sort(std::vector<std::string_view>& keys) override { sort(keys, *std::pmr::get_default_resource()); }
+    void sort(std::vector<std::string_view>& keys, std::pmr::memory_resource& scratch) override;
+    std::string getName() const override { return "Multikey Quicksort"; }
+};
+
+// Names accepted by makeLineSortStrategy: the multikey quicksort and pdq over plain views
+std::vector<std::string> lineSortStrategyNames();
+
+// Throws std::invalid_argument for unknown names and for the indirect mode
+std::unique_ptr<SortStrategy<std::string_view>> makeLineSortStrategy(const SortOptions& options);
+
+// Lines of text without their '\n'; a last line without a newline counts too.
+// The views point into text.
+std::vector<std::string_view> splitLines(std::string_view text);
+
+// Writes every line followed by '\n' through one large buffer.
+// Throws std::runtime_error if the file cannot be written.
+void writeLines(const std::string& filename, const std::vector<std::string_view>& lines);
+
+// Sorts the lines of a text file as byte strings. The file is mapped once and
+// the keys are views into the mapping, so there is no allocation per line and
+// the sort moves 16-byte views instead of chasing string pointers.
+class LineSortExecutor {
+public:
+    explicit LineSortExecutor(std::unique_ptr<SortStrategy<std::string_view>> strategy)
+        : strategy_(std::move(strategy)) {}
+
+    // Sorts inputFilename and writes the sorted lines to sortedFilename when given.
+    // Failures end up in SortReport::error.
+    SortReport run(const std::string& inputFilename, const std::string& sortedFilename = {});
+
+    // run() that prints the timings and appends a results line to outputFilename
+    void execute(const std::string& inputFilename, const std::string& outputFilename,
+                 const std::string& sortedFilename = {});
+
+private:
+    std::unique_ptr<SortStrategy<std::string_view>> strategy_;
+    ScratchArena scratch_;
+};
+
+#endif //ALGORITHMS_PROGRAMMING_EXERCISES_STRING_SORT_H
@@ -0,0 +1,428 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "sort_algorithms.h"
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+namespace {
+    // Exponential then binary search for key in a[0, len), starting at hint.
+    // gallopLeft returns the first position whose element is not less than key
+    // (key goes before equal elements), gallopRight the first position whose
+    // element is greater than key (key goes after equal elements).
+    template <typename T>
+    ptrdiff_t gallopLeft(const T& key, const T* a, ptrdiff_t len, ptrdiff_t hint) {
+        ptrdiff_t lastOffset = 0;
+        ptrdiff_t offset = 1;
+        if (a[hint] < key) {
+            ptrdiff_t maxOffset = len - hint;
+            while (offset < maxOffset && a[hint + offset] < key) {
+                lastOffset = offset;
+                offset = offset * 2 + 1;
+            }
+            offset = std::min(offset, maxOffset);
+            lastOffset += hint;
+            offset += hint;
+        } else {
+            ptrdiff_t maxOffset = hint + 1;
+            while (offset < maxOffset && !(a[hint - offset] < key)) {
+                lastOffset = offset;
+                offset = offset * 2 + 1;
+            }
+            offset = std::min(offset, maxOffset);
+            ptrdiff_t previous = lastOffset;
+            lastOffset = hint - offset;
+            offset = hint - previous;
+        }
+        // Now a[lastOffset] < key <= a[offset]
+        ++lastOffset;
+        while (lastOffset < offset) {
+            ptrdiff_t middle = lastOffset + (offset - lastOffset) / 2;
+            if (a[middle] < key) {
+                lastOffset = middle + 1;
+            } else {
+                offset = middle;
+            }
+        }
+        return offset;
+    }
+
+    template <typename T>
+    ptrdiff_t gallopRight(const T& key, const T* a, ptrdiff_t len, ptrdiff_t hint) {
+        ptrdiff_t lastOffset = 0;
+        ptrdiff_t offset = 1;
+        if (key < a[hint]) {
+            ptrdiff_t maxOffset = hint + 1;
+            while (offset < maxOffset && key < a[hint - offset]) {
+                lastOffset = offset;
+                offset = offset * 2 + 1;
+            }
+            offset = std::min(offset, maxOffset);
+            ptrdiff_t previous = lastOffset;
+            lastOffset = hint - offset;
+            offset = hint - previous;
+        } else {
+            ptrdiff_t maxOffset = len - hint;
+            while (offset < maxOffset && !(key < a[hint + offset])) {
+                lastOffset = offset;
+                offset = offset * 2 + 1;
+            }
+            offset = std::min(offset, maxOffset);
+            lastOffset += hint;
+            offset += hint;
+        }
+        // Now a[lastOffset] <= key < a[offset]
+        ++lastOffset;
+        while (lastOffset < offset) {
+            ptrdiff_t middle = lastOffset + (offset - lastOffset) / 2;
+            if (key < a[middle]) {
+                offset = middle;
+            } else {
+                lastOffset = middle + 1;
+            }
+        }
+        return offset;
+    }
+
+    // State of one sort: the pending run stack, the merge buffer and the adaptive gallop threshold
+    template <typename T>
+    class TimSortMerger {
+    public:
+        struct Run {
+            ptrdiff_t base;
+            ptrdiff_t length;
+        };
+
+        TimSortMerger(T* a, std::pmr::memory_resource& scratch) : a_(a), buffer_(&scratch) {}
+
+        void pushRun(ptrdiff_t base, ptrdiff_t length) { runs_.push_back({base, length}); }
+
+        // Restores the invariants |Z| > |Y| + |X| and |Y| > |X| on the top three runs
+        // (checking one run deeper as well, which the original formulation missed)
+        void mergeCollapse() {
+            while (runs_.size() > 1) {
+                ptrdiff_t n = static_cast<ptrdiff_t>(runs_.size()) - 2;
+                if ((n > 0 && runs_[n - 1].length <= runs_[n].length + runs_[n + 1].length)
+                    || (n > 1 && runs_[n - 2].length <= runs_[n - 1].length + runs_[n].length)) {
+                    if (runs_[n - 1].length < runs_[n + 1].length) {
+                        --n;
+                    }
+                } else if (runs_[n].length > runs_[n + 1].length) {
+                    break;
+                }
+                mergeAt(n);
+            }
+        }
+
+        void mergeForceCollapse() {
+            while (runs_.size() > 1) {
+                ptrdiff_t n = static_cast<ptrdiff_t>(runs_.size()) - 2;
+                if (n > 0 && runs_[n - 1].length < runs_[n + 1].length) {
+                    --n;
+                }
+                mergeAt(n);
+            }
+        }
+
+    private:
+        void mergeAt(ptrdiff_t i) {
+            ptrdiff_t base1 = runs_[i].base;
+            ptrdiff_t length1 = runs_[i].length;
+            ptrdiff_t base2 = runs_[i + 1].base;
+            ptrdiff_t length2 = runs_[i + 1].length;
+            runs_[i].length = length1 + length2;
+            runs_.erase(runs_.begin() + i + 1);
+
+            // Elements of run 1 not greater than run 2's first are already in place
+            ptrdiff_t skipped = gallopRight(a_[base2], a_ + base1, length1, 0);
+            base1 += skipped;
+            length1 -= skipped;
+            if (length1 == 0) {
+                return;
+            }
+            // Likewise elements of run 2 not less than run 1's last
+            length2 = gallopLeft(a_[base1 + length1 - 1], a_ + base2, length2, length2 - 1);
+            if (length2 == 0) {
+                return;
+            }
+
+            if (length1 <= length2) {
+                mergeLow(base1, length1, base2, length2);
+            } else {
+                mergeHigh(base1, length1, base2, length2);
+            }
+        }
+
+        // Merges left to right, buffering the shorter first run.
+        // Requires a[base2] < a[base1] and the last of run 1 greater than all of run 2.
+        void mergeLow(ptrdiff_t base1, ptrdiff_t length1, ptrdiff_t base2, ptrdiff_t length2) {
+            buffer_.assign(std::make_move_iterator(a_ + base1), std::make_move_iterator(a_ + base1 + length1));
+            T* tmp = buffer_.data();
+            ptrdiff_t cursor1 = 0;
+            ptrdiff_t cursor2 = base2;
+            ptrdiff_t dest = base1;
+
+            a_[dest++] = std::move(a_[cursor2++]);
+            if (--length2 == 0) {
+                std::move(tmp + cursor1, tmp + cursor1 + length1, a_ + dest);
+                return;
+            }
+            if (length1 == 1) {
+                std::move(a_ + cursor2, a_ + cursor2 + length2, a_ + dest);
+                a_[dest + length2] = std::move(tmp[cursor1]);
+                return;
+            }
+
+            ptrdiff_t minGallop = minGallop_;
+            while (true) {
+                ptrdiff_t count1 = 0;
+                ptrdiff_t count2 = 0;
+                bool done = false;
+
+                // One-at-a-time mode until one run wins minGallop times in a row
+                do {
+                    if (a_[cursor2] < tmp[cursor1]) {
+                        a_[dest++] = std::move(a_[cursor2++]);
+                        ++count2;
+                        count1 = 0;
+                        done = --length2 == 0;
+                    } else {
+                        a_[dest++] = std::move(tmp[cursor1++]);
+                        ++count1;
+                        count2 = 0;
+                        done = --length1 == 1;
+                    }
+                } while (!done && (count1 | count2) < minGallop);
+
+                // Galloping mode while it keeps paying off
+                while (!done) {
+                    count1 = gallopRight(a_[cursor2], tmp + cursor1, length1, 0);
+                    if (count1 != 0) {
+                        std::move(tmp + cursor1, tmp + cursor1 + count1, a_ + dest);
+                        dest += count1;
+                        cursor1 += count1;
+                        length1 -= count1;
+                        if (length1 <= 1) {
+                            done = true;
+                            break;
+                        }
+                    }
+                    a_[dest++] = std::move(a_[cursor2++]);
+                    if (--length2 == 0) {
+                        done = true;
+                        break;
+                    }
+
+                    count2 = gallopLeft(tmp[cursor1], a_ + cursor2, length2, 0);
+                    if (count2 != 0) {
+                        std::move(a_ + cursor2, a_ + cursor2 + count2, a_ + dest);
+                        dest += count2;
+                        cursor2 += count2;
+                        length2 -= count2;
+                        if (length2 == 0) {
+                            done = true;
+                            break;
+                        }
+                    }
+                    a_[dest++] = std::move(tmp[cursor1++]);
+                    if (--length1 == 1) {
+                        done = true;
+                        break;
+                    }
+
+                    --minGallop;
+                    if (count1 < static_cast<ptrdiff_t>(TimSort<T>::MIN_GALLOP)
+                        && count2 < static_cast<ptrdiff_t>(TimSort<T>::MIN_GALLOP)) {
+                        break;
+                    }
+                }
+                if (done) {
+                    break;
+                }
+                // Leaving gallop mode makes it harder to re-enter
+                minGallop = std::max<ptrdiff_t>(minGallop, 0) + 2;
+            }
+            minGallop_ = std::max<ptrdiff_t>(minGallop, 1);
+
+            if (length1 == 1) {
+                std::move(a_ + cursor2, a_ + cursor2 + length2, a_ + dest);
+                a_[dest + length2] = std::move(tmp[cursor1]);
+            } else if (length1 == 0) {
+                throw std::invalid_argument("TimSort: the comparison is not a strict weak ordering");
+            } else {
+                std::move(tmp + cursor1, tmp + cursor1 + length1, a_ + dest);
+            }
+        }
+
+        // Mirror image of mergeLow: merges right to left, buffering the shorter second run
+        void mergeHigh(ptrdiff_t base1, ptrdiff_t length1, ptrdiff_t base2, ptrdiff_t length2) {
+            buffer_.assign(std::make_move_iterator(a_ + base2), std::make_move_iterator(a_ + base2 + length2));
+            T* tmp = buffer_.data();
+            ptrdiff_t cursor1 = base1 + length1 - 1;
+            ptrdiff_t cursor2 = length2 - 1;
+            ptrdiff_t dest = base2 + length2 - 1;
+
+            a_[dest--] = std::move(a_[cursor1--]);
+            if (--length1 == 0) {
+                std::move(tmp, tmp + length2, a_ + dest - (length2 - 1));
+                return;
+            }
+            if (length2 == 1) {
+                dest -= length1;
+                cursor1 -= length1;
+                std::move_backward(a_ + cursor1 + 1, a_ + cursor1 + 1 + length1, a_ + dest + 1 + length1);
+                a_[dest] = std::move(tmp[cursor2]);
+                return;
+            }
+
+            ptrdiff_t minGallop = minGallop_;
+            while (true) {
+                ptrdiff_t count1 = 0;
+                ptrdiff_t count2 = 0;
+                bool done = false;
+
+                do {
+                    if (tmp[cursor2] < a_[cursor1]) {
+                        a_[dest--] = std::move(a_[cursor1--]);
+                        ++count1;
+                        count2 = 0;
+                        done = --length1 == 0;
+                    } else {
+                        a_[dest--] = std::move(tmp[cursor2--]);
+                        ++count2;
+                        count1 = 0;
+                        done = --length2 == 1;
+                    }
+                } while (!done && (count1 | count2) < minGallop);
+
+                while (!done) {
+                    count1 = length1 - gallopRight(tmp[cursor2], a_ + base1, length1, length1 - 1);
+                    if (count1 != 0) {
+                        dest -= count1;
+                        cursor1 -= count1;
+                        length1 -= count1;
+                        std::move_backward(a_ + cursor1 + 1, a_ + cursor1 + 1 + count1, a_ + dest + 1 + count1);
+                        if (length1 == 0) {
+                            done = true;
+                            break;
+                        }
+                    }
+                    a_[dest--] = std::move(tmp[cursor2--]);
+                    if (--length2 == 1) {
+                        done = true;
+                        break;
+                    }
+
+                    count2 = length2 - gallopLeft(a_[cursor1], tmp, length2, length2 - 1);
+                    if (count2 != 0) {
+                        dest -= count2;
+                        cursor2 -= count2;
+                        length2 -= count2;
+                        std::move(tmp + cursor2 + 1, tmp + cursor2 + 1 + count2, a_ + dest + 1);
+                        if (length2 <= 1) {
+                            done = true;
+                            break;
+                        }
+                    }
+                    a_[dest--] = std::move(a_[cursor1--]);
+                    if (--length1 == 0) {
+                        done = true;
+                        break;
+                    }
+
+                    --minGallop;
+                    if (count1 < static_cast<ptrdiff_t>(TimSort<T>::MIN_GALLOP)
+                        && count2 < static_cast<ptrdiff_t>(TimSort<T>::MIN_GALLOP)) {
+                        break;
+                    }
+                }
+                if (done) {
+                    break;
+                }
+                minGallop = std::max<ptrdiff_t>(minGallop, 0) + 2;
+            }
+            minGallop_ = std::max<ptrdiff_t>(minGallop, 1);
+
+            if (length2 == 1) {
+                dest -= length1;
+                cursor1 -= length1;
+                std::move_backward(a_ + cursor1 + 1, a_ + cursor1 + 1 + length1, a_ + dest + 1 + length1);
+                a_[dest] = std::move(tmp[cursor2]);
+            } else if (length2 == 0) {
+                throw std::invalid_argument("TimSort: the comparison is not a strict weak ordering");
+            } else {
+                std::move(tmp, tmp + length2, a_ + dest - (length2 - 1));
+            }
+        }
+
+        T* a_;
+        std::vector<Run> runs_;
+        std::pmr::vector<T> buffer_;
+        ptrdiff_t minGallop_ = static_cast<ptrdiff_t>(TimSort<T>::MIN_GALLOP);
+    };
+
+    // Length of the run starting at lo; a strictly descending run is reversed
+    // (strictly, so reversing it keeps the sort stable)
+    template <typename T>
+    ptrdiff_t countRunAndMakeAscending(T* a, ptrdiff_t lo, ptrdiff_t hi) {
+        ptrdiff_t runHi = lo + 1;
+        if (runHi == hi) {
+            return 1;
+        }
+        if (a[runHi++] < a[lo]) {
+            while (runHi < hi && a[runHi] < a[runHi - 1]) {
+                ++runHi;
+            }
+            std::reverse(a + lo, a + runHi);
+        } else {
+            while (runHi < hi && !(a[runHi] < a[runHi - 1])) {
+                ++runHi;
+            }
+        }
+        return runHi - lo;
+    }
+
+    // Picks a run length in [MIN_MERGE / 2, MIN_MERGE] such that n / minRun is
+    // a power of two or slightly less, which keeps the final merges balanced
+    template <typename T>
+    ptrdiff_t minRunLength(ptrdiff_t n) {
+        ptrdiff_t lowBits = 0;
+        while (n >= static_cast<ptrdiff_t>(TimSort<T>::MIN_MERGE)) {
+            lowBits |= n & 1;
+            n >>= 1;
+        }
+        return n + lowBits;
+    }
+}
+
+template <typename T>
+void TimSort<T>::sortValues(T* values, size_t count, std::pmr::memory_resource& scratch) {
+    const ptrdiff_t n = static_cast<ptrdiff_t>(count);
+    if (n < 2) {
+        return;
+    }
+    T* a = values;
+
+    const ptrdiff_t minRun = minRunLength<T>(n);
+    TimSortMerger<T> merger(a, scratch);
+    for (ptrdiff_t lo = 0; lo < n;) {
+        ptrdiff_t runLength = countRunAndMakeAscending(a, lo, n);
+        if (runLength < minRun) {
+            // The insertion pass only walks the sorted prefix once, then inserts the rest
+            ptrdiff_t forced = std::min(minRun, n - lo);
+            InsertionSort<T>::sortRange(a + lo, a + lo + forced);
+            runLength = forced;
+        }
+        merger.pushRun(lo, runLength);
+        merger.mergeCollapse();
+        lo += runLength;
+    }
+    merger.mergeForceCollapse();
+}
+
+#define INSTANTIATE_TIM_SORT_KEY(K) template class TimSort<K>;
+SORT_KEY_TYPES(INSTANTIATE_TIM_SORT_KEY)
+#define INSTANTIATE_TIM_SORT(P) template class TimSort<Record<P>>;
+SORT_RECORD_PAYLOADS(INSTANTIATE_TIM_SORT)
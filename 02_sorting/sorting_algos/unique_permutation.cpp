@@ -0,0 +1,45 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "unique_permutation.h"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+UniquePermutation::UniquePermutation(uint64_t domain, uint64_t seed) : domain_(domain) {
+    if (domain == 0) {
+        throw std::invalid_argument("UniquePermutation needs a non-empty domain");
+    }
+    // Rounding the width up to an even number keeps the halves balanced; the
+    // covering range is then below 4 * domain, so cycle-walking takes < 4 steps on average.
+    unsigned int bits = static_cast<unsigned int>(std::max<uint64_t>(2, std::bit_width(domain - 1)));
+    bits += bits & 1;
+    halfBits_ = bits / 2;
+    halfMask_ = (uint64_t(1) << halfBits_) - 1;
+    for (int round = 0; round < ROUNDS; ++round) {
+        seed = mix64(seed);
+        keys_[round] = seed;
+    }
+}
+
+uint64_t UniquePermutation::encrypt(uint64_t value) const {
+    uint64_t left = value >> halfBits_;
+    uint64_t right = value & halfMask_;
+    for (uint64_t key : keys_) {
+        uint64_t next = left ^ (mix64(right ^ key) & halfMask_);
+        left = right;
+        right = next;
+    }
+    return (left << halfBits_) | right;
+}
+
+uint64_t UniquePermutation::operator()(uint64_t index) const {
+    // Cycle-walking: the Feistel network permutes the covering range, so
+    // following the cycle from an in-domain value always returns into the domain
+    uint64_t value = encrypt(index);
+    while (value >= domain_) {
+        value = encrypt(value);
+    }
+    return value;
+}
@@ -0,0 +1,43 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#ifndef ALGORITHMS_PROGRAMMING_EXERCISES_UNIQUE_PERMUTATION_H
+#define ALGORITHMS_PROGRAMMING_EXERCISES_UNIQUE_PERMUTATION_H
+
+#include <cstdint>
+
+// Seeded bijection of [0, domain) onto itself in O(1) memory: a balanced
+// Feistel network over the smallest even bit width covering the domain,
+// cycle-walked until the result falls back inside the domain. Mapping
+// 0, 1, 2, ... therefore yields distinct values in a shuffled order.
+class UniquePermutation {
+public:
+    static constexpr int ROUNDS = 4;
+
+    // Throws std::invalid_argument for an empty domain
+    UniquePermutation(uint64_t domain, uint64_t seed);
+
+    uint64_t domain() const { return domain_; }
+
+    // index must be below domain()
+    uint64_t operator()(uint64_t index) const;
+
+private:
+    uint64_t encrypt(uint64_t value) const;
+
+    uint64_t domain_;
+    unsigned int halfBits_;
+    uint64_t halfMask_;
+    uint64_t keys_[ROUNDS];
+};
+
+// SplitMix64 finaliser: a cheap, well-mixed hash used for round functions and substream seeds
+inline uint64_t mix64(uint64_t value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+#endif //ALGORITHMS_PROGRAMMING_EXERCISES_UNIQUE_PERMUTATION_H
@@ -0,0 +1,139 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "thread_pool.h"
+
+namespace {
+    // Identifies the pool (and queue) the current thread works for, so that tasks
+    // spawned from inside a task land on the spawning worker's own deque.
+    thread_local const WorkStealingPool* currentPool = nullptr;
+    thread_local unsigned int currentIndex = 0;
+}
+
+WorkStealingPool::WorkStealingPool(unsigned int threadCount) {
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        workers_.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void WorkStealingPool::submit(std::function<void()> task) {
+    unsigned int index = (currentPool == this)
+        ? currentIndex
+        : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    pending_.fetch_add(1);
+    {
+        // Taking the lock orders the increment before a sleeping worker re-checks its predicate
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    wake_.notify_one();
+}
+
+bool WorkStealingPool::popTask(std::function<void()>& task) {
+    const size_t count = queues_.size();
+    const unsigned int self = (currentPool == this) ? currentIndex : 0;
+
+    // Own queue first, newest task
+    {
+        WorkerQueue& own = *queues_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pending_.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // Steal the oldest task from somebody else
+    for (size_t offset = 1; offset < count; ++offset) {
+        WorkerQueue& victim = *queues_[(self + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pending_.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingPool::tryRunPendingTask() {
+    std::function<void()> task;
+    if (!popTask(task)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+void WorkStealingPool::workerLoop(unsigned int index) {
+    currentPool = this;
+    currentIndex = index;
+
+    while (true) {
+        if (tryRunPendingTask()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this] { return stopping_ || pending_.load() > 0; });
+        if (stopping_ && pending_.load() == 0) {
+            return;
+        }
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    outstanding_.fetch_add(1);
+    pool_.submit([this, task = std::move(task)] {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+        outstanding_.fetch_sub(1, std::memory_order_release);
+    });
+}
+
+void TaskGroup::drain() {
+    while (outstanding_.load(std::memory_order_acquire) > 0) {
+        if (!pool_.tryRunPendingTask()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void TaskGroup::wait() {
+    drain();
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    if (error_) {
+        std::exception_ptr error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
@@ -0,0 +1,75 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#ifndef ALGORITHMS_PROGRAMMING_EXERCISES_THREAD_POOL_H
+#define ALGORITHMS_PROGRAMMING_EXERCISES_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool where every worker owns a deque of tasks.
+// Workers pop their own deque from the back (LIFO, cache-warm) and steal
+// from the front of the other deques (FIFO, oldest and usually largest task).
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned int threadCount);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Runs one queued task on the calling thread, if any is available.
+    // Used by threads that block on a TaskGroup so they keep doing useful work.
+    bool tryRunPendingTask();
+
+    unsigned int size() const { return static_cast<unsigned int>(workers_.size()); }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void workerLoop(unsigned int index);
+    bool popTask(std::function<void()>& task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    std::atomic<size_t> pending_{0};
+    std::atomic<unsigned int> nextQueue_{0};
+    bool stopping_ = false;
+};
+
+// Fork-join helper: tasks started through run() are awaited by wait(),
+// which executes queued work instead of sleeping (so nested groups cannot deadlock).
+class TaskGroup {
+public:
+    explicit TaskGroup(WorkStealingPool& pool) : pool_(pool) {}
+    ~TaskGroup() { drain(); }
+
+    void run(std::function<void()> task);
+    // Blocks until every task has finished and rethrows the first exception raised by one of them.
+    void wait();
+
+private:
+    void drain();
+
+    WorkStealingPool& pool_;
+    std::atomic<size_t> outstanding_{0};
+    std::mutex errorMutex_;
+    std::exception_ptr error_;
+};
+
+#endif //ALGORITHMS_PROGRAMMING_EXERCISES_THREAD_POOL_H
@@ -0,0 +1,199 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#include "memory_stats.h"
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace {
+    // Constant-initialised, so allocations made during static initialisation are counted too
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> deallocations{0};
+    std::atomic<uint64_t> allocatedBytes{0};
+    std::atomic<size_t> liveBytes{0};
+    std::atomic<size_t> peakLiveBytes{0};
+
+#if defined(__GLIBC__)
+    constexpr bool TRACKS_LIVE_BYTES = true;
+
+    size_t blockSize(void* p) {
+        return malloc_usable_size(p);
+    }
+#else
+    constexpr bool TRACKS_LIVE_BYTES = false;
+
+    size_t blockSize(void*) {
+        return 0;
+    }
+#endif
+
+    void recordAllocation(void* p, size_t requested) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(requested, std::memory_order_relaxed);
+        if constexpr (TRACKS_LIVE_BYTES) {
+            size_t size = blockSize(p);
+            size_t live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+            size_t peak = peakLiveBytes.load(std::memory_order_relaxed);
+            while (live > peak && !peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+            }
+        }
+    }
+
+    void release(void* p) {
+        if (p == nullptr) {
+            return;
+        }
+        deallocations.fetch_add(1, std::memory_order_relaxed);
+        if constexpr (TRACKS_LIVE_BYTES) {
+            liveBytes.fetch_sub(blockSize(p), std::memory_order_relaxed);
+        }
+        std::free(p);
+    }
+
+    // The standard operator new loop: retry through the new-handler until it gives up
+    void* allocate(size_t size, size_t alignment) {
+        size = size ? size : 1;
+        while (true) {
+            void* p = alignment > alignof(std::max_align_t)
+                          ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+                          : std::malloc(size);
+            if (p != nullptr) {
+                recordAllocation(p, size);
+                return p;
+            }
+            std::new_handler handler = std::get_new_handler();
+            if (handler == nullptr) {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+
+    // Value of a "Name:   1234 kB" line of /proc/self/status in bytes
+    std::optional<size_t> statusBytes(const std::string& name) {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.compare(0, name.size(), name) == 0 && line.size() > name.size() && line[name.size()] == ':') {
+                return std::stoull(line.substr(name.size() + 1)) * 1024;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void appendValue(std::ostringstream& out, const char* name, const std::optional<size_t>& value) {
+        out << ", " << name << "=";
+        if (value) {
+            out << *value;
+        } else {
+            out << "n/a";
+        }
+    }
+}
+
+void* operator new(size_t size) {
+    return allocate(size, 0);
+}
+
+void* operator new[](size_t size) {
+    return allocate(size, 0);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept {
+    release(p);
+}
+
+void operator delete[](void* p) noexcept {
+    release(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    release(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    release(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    release(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    release(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+    release(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+    release(p);
+}
+
+AllocationCounts allocationCounts() {
+    AllocationCounts counts;
+    counts.allocations = allocations.load(std::memory_order_relaxed);
+    counts.deallocations = deallocations.load(std::memory_order_relaxed);
+    counts.bytes = allocatedBytes.load(std::memory_order_relaxed);
+    return counts;
+}
+
+std::optional<size_t> liveHeapBytes() {
+    if (!TRACKS_LIVE_BYTES) {
+        return std::nullopt;
+    }
+    return liveBytes.load(std::memory_order_relaxed);
+}
+
+std::optional<size_t> residentSetBytes() {
+    return statusBytes("VmRSS");
+}
+
+std::optional<size_t> peakResidentSetBytes() {
+    return statusBytes("VmHWM");
+}
+
+std::string MemoryUsage::format() const {
+    std::ostringstream out;
+    out << "allocs=" << allocations << ", alloc_bytes=" << bytesAllocated;
+    appendValue(out, "peak_heap_bytes", peakHeapBytes);
+    appendValue(out, peakRssOfRegion ? "peak_rss_bytes" : "process_peak_rss_bytes", peakRssBytes);
+    return out.str();
+}
+
+void MemoryProbe::start() {
+    peakLiveBytes.store(liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    // Writing 5 resets VmHWM to the current RSS (Linux 4.0 and later)
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    peakRssReset_ = clearRefs.is_open() && (clearRefs << "5").flush().good();
+    startCounts_ = allocationCounts();
+}
+
+MemoryUsage MemoryProbe::stop() const {
+    AllocationCounts counts = allocationCounts();
+    MemoryUsage usage;
+    usage.allocations = counts.allocations - startCounts_.allocations;
+    usage.bytesAllocated = counts.bytes - startCounts_.bytes;
+    if (TRACKS_LIVE_BYTES) {
+        usage.peakHeapBytes = peakLiveBytes.load(std::memory_order_relaxed);
+    }
+    usage.peakRssBytes = peakResidentSetBytes();
+    usage.peakRssOfRegion = peakRssReset_;
+    return usage;
+}
@@ -0,0 +1,57 @@
+//
+// Created by keret on 2026. 02. 15..
+//
+
+#ifndef ALGORITHMS_PROGRAMMING_EXERCISES_MEMORY_STATS_H
+#define ALGORITHMS_PROGRAMMING_EXERCISES_MEMORY_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+// Totals of the global operator new / delete since the process started.
+// They are process wide: allocations of every thread are counted.
+struct AllocationCounts {
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t bytes = 0;  // as requested, without allocator overhead
+};
+
+AllocationCounts allocationCounts();
+
+// Heap bytes currently allocated through operator new; empty where the
+// allocator cannot report block sizes (only glibc's malloc_usable_size is used)
+std::optional<size_t> liveHeapBytes();
+
+// VmRSS and VmHWM of /proc/self/status; empty where that file does not exist
+std::optional<size_t> residentSetBytes();
+std::optional<size_t> peakResidentSetBytes();
+
+// Memory used by one region of a run
+struct MemoryUsage {
+    uint64_t allocations = 0;
+    uint64_t bytesAllocated = 0;
+    std::optional<size_t> peakHeapBytes;  // high-water mark of the live heap
+    std::optional<size_t> peakRssBytes;   // of the region, or of the process if it could not be reset
+    bool peakRssOfRegion = false;
+
+    // "name=value" pairs separated by ", ", with "n/a" for values the host could not provide
+    std::string format() const;
+};
+
+// Measures the allocations and the peak memory of a region. Starting a probe
+// restarts the process-wide high-water marks (the heap one, and VmHWM through
+// /proc/self/clear_refs), so probes must not overlap; sequential phases are fine.
+// Concurrent work (a batch of jobs) is probed once around all of it.
+class MemoryProbe {
+public:
+    void start();
+    MemoryUsage stop() const;
+
+private:
+    AllocationCounts startCounts_;
+    bool peakRssReset_ = false;
+};
+
+#endif //ALGORITHMS_PROGRAMMING_EXERCISES_MEMORY_STATS_H